@@ -0,0 +1,177 @@
+#include "bench.h"
+
+#include <spot/math/animation.h>
+#include <spot/math/packed.h>
+#include <spot/math/skinning.h>
+
+
+namespace spot::math::bench
+{
+
+
+SPOT_BENCH_GROUP( animation )
+{
+	constexpr size_t count = 4096;
+	constexpr size_t keys  = 32;
+
+	auto quats = random<Quat>( count * keys );
+	auto steps = random_floats( count * keys, 0.01f, 0.1f );
+
+	std::vector<QuatTrack> tracks( count );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		float time = 0.0f;
+		for ( size_t k = 0; k < keys; ++k )
+		{
+			auto q = quats[i * keys + k];
+			q.normalize();
+			tracks[i].times.push_back( time );
+			tracks[i].values.push_back( q );
+			time += steps[i * keys + k];
+		}
+	}
+
+	std::vector<TrackCursor> cursors( count );
+	std::vector<Quat>        out( count );
+
+	const std::pair<const char*, Interpolation> modes[] = {
+		{ "nlerp", Interpolation::Nlerp },
+		{ "approx_slerp", Interpolation::ApproxSlerp },
+		{ "slerp", Interpolation::Slerp },
+	};
+
+	for ( auto& [name, interpolation] : modes )
+	{
+		// Time advances every frame like in a game loop, wrapping around
+		float time = 0.0f;
+		runner.run( std::string( "sample(" ) + name + ")/" + std::to_string( count ), count, [&] {
+			time = time > 1.5f ? 0.0f : time + 0.016f;
+			sample( tracks.data(), cursors.data(), count, time, out.data(), interpolation );
+		} );
+
+		time = 0.0f;
+		runner.run( std::string( "sample(" ) + name + ",single)/" + std::to_string( count ), count, [&] {
+			time = time > 1.5f ? 0.0f : time + 0.016f;
+			for ( size_t i = 0; i < count; ++i )
+			{
+				out[i] = sample( tracks[i], time, cursors[i], interpolation );
+			}
+		} );
+	}
+}
+
+
+SPOT_BENCH_GROUP( skinning )
+{
+	constexpr size_t bones = 64;
+
+	auto rotations    = random<Quat>( bones );
+	auto translations = random<Vec3>( bones );
+	std::vector<DualQuat> palette( bones );
+	for ( size_t i = 0; i < bones; ++i )
+	{
+		rotations[i].normalize();
+		palette[i] = DualQuat::from_tr( translations[i], rotations[i] );
+	}
+
+	auto weights = random_floats( MaxSize * BoneInfluences::Count, 0.0f, 1.0f );
+	std::vector<BoneInfluences> influences( MaxSize );
+	for ( size_t i = 0; i < MaxSize; ++i )
+	{
+		float sum = 0.0f;
+		for ( size_t j = 0; j < BoneInfluences::Count; ++j )
+		{
+			influences[i].bones[j]   = uint16_t( get_generator()() % bones );
+			influences[i].weights[j] = weights[i * BoneInfluences::Count + j];
+			sum += influences[i].weights[j];
+		}
+		for ( auto& w : influences[i].weights )
+		{
+			w /= sum;
+		}
+	}
+
+	auto positions = Vec3Soa( random<Vec3>( MaxSize ) );
+	auto normals   = Vec3Soa( random<Vec3>( MaxSize ) );
+	normalize( normals, normals );
+
+	for ( auto size : Sizes )
+	{
+		Vec3Soa sized_positions( size );
+		Vec3Soa sized_normals( size );
+		for ( size_t i = 0; i < size; ++i )
+		{
+			sized_positions.set( i, positions[i] );
+			sized_normals.set( i, normals[i] );
+		}
+		Vec3Soa out_positions( size );
+		Vec3Soa out_normals( size );
+
+		auto sized = "/" + std::to_string( size );
+		runner.run( "skin(positions)" + sized, size, [&] {
+			skin( palette.data(), influences.data(), sized_positions, out_positions );
+		} );
+		runner.run( "skin(positions,normals)" + sized, size, [&] {
+			skin( palette.data(), influences.data(), sized_positions, sized_normals, out_positions, out_normals );
+		} );
+		runner.run( "blend(DualQuat)*Vec3" + sized, size, [&] {
+			for ( size_t i = 0; i < size; ++i )
+			{
+				DualQuat dqs[BoneInfluences::Count];
+				for ( size_t j = 0; j < BoneInfluences::Count; ++j )
+				{
+					dqs[j] = palette[influences[i].bones[j]];
+				}
+				out_positions.set( i, blend( dqs, influences[i].weights, BoneInfluences::Count ) * sized_positions[i] );
+			}
+		} );
+	}
+}
+
+
+SPOT_BENCH_GROUP( packed )
+{
+	// A pose buffer of a few hundred characters
+	constexpr size_t count = 16384;
+
+	auto positions = random<Vec3>( count, -100.0f, 100.0f );
+	auto rotations = random<Quat>( count );
+	for ( auto& q : rotations )
+	{
+		q.normalize();
+	}
+	auto range = Box( Vec3( -100.0f, -100.0f, -100.0f ), Vec3( 100.0f, 100.0f, 100.0f ) );
+
+	std::vector<HalfVec3>      halves( count );
+	std::vector<QuantizedVec3> quantized( count );
+	std::vector<PackedQuat48>  quats48( count );
+	std::vector<PackedQuat32>  quats32( count );
+	std::vector<Vec3>          out_positions( count );
+	std::vector<Quat>          out_rotations( count );
+
+	auto sized = "/" + std::to_string( count );
+	runner.run( "pack(HalfVec3)" + sized, count, [&] { pack( positions.data(), halves.data(), count ); } );
+	runner.run( "unpack(HalfVec3)" + sized, count, [&] { unpack( halves.data(), out_positions.data(), count ); } );
+	runner.run( "pack(QuantizedVec3)" + sized, count, [&] { pack( positions.data(), range, quantized.data(), count ); } );
+	runner.run( "unpack(QuantizedVec3)" + sized, count, [&] { unpack( quantized.data(), range, out_positions.data(), count ); } );
+	runner.run( "pack(PackedQuat48)" + sized, count, [&] { pack( rotations.data(), quats48.data(), count ); } );
+	runner.run( "unpack(PackedQuat48)" + sized, count, [&] { unpack( quats48.data(), out_rotations.data(), count ); } );
+	runner.run( "pack(PackedQuat32)" + sized, count, [&] { pack( rotations.data(), quats32.data(), count ); } );
+	runner.run( "unpack(PackedQuat32)" + sized, count, [&] { unpack( quats32.data(), out_rotations.data(), count ); } );
+
+	runner.run( "pack(PackedQuat32,single)" + sized, count, [&] {
+		for ( size_t i = 0; i < count; ++i )
+		{
+			quats32[i] = PackedQuat32( rotations[i] );
+		}
+	} );
+	runner.run( "unpack(PackedQuat32,single)" + sized, count, [&] {
+		for ( size_t i = 0; i < count; ++i )
+		{
+			out_rotations[i] = quats32[i].get_quat();
+		}
+	} );
+}
+
+
+}  // namespace spot::math::bench
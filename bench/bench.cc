@@ -0,0 +1,135 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+
+
+namespace spot::math::bench
+{
+
+
+std::vector<Group>& get_groups()
+{
+	static std::vector<Group> groups;
+	return groups;
+}
+
+
+Registrar::Registrar( const Group group )
+{
+	get_groups().push_back( group );
+}
+
+
+std::mt19937& get_generator()
+{
+	static std::mt19937 generator( 42 );
+	return generator;
+}
+
+
+std::vector<float> random_floats( const size_t count, const float min, const float max )
+{
+	std::uniform_real_distribution<float> dist( min, max );
+	std::vector<float> ret( count );
+	for ( auto& f : ret )
+	{
+		f = dist( get_generator() );
+	}
+	return ret;
+}
+
+
+Runner::Runner( std::string f, const double t )
+: filter { std::move( f ) }
+, min_time { t }
+{
+	std::printf( "%-48s %12s %12s\n", "benchmark", "ns/op", "Mop/s" );
+}
+
+
+void Runner::run( const std::string& name, const size_t ops, const std::function<void()>& function )
+{
+	if ( name.find( filter ) == std::string::npos )
+	{
+		return;
+	}
+
+	using Clock = std::chrono::steady_clock;
+
+	// Warm up caches and branch predictors
+	function();
+
+	size_t iterations = 1;
+	double elapsed = 0.0;
+	while ( true )
+	{
+		auto start = Clock::now();
+		for ( size_t i = 0; i < iterations; ++i )
+		{
+			function();
+		}
+		elapsed = std::chrono::duration<double>( Clock::now() - start ).count();
+
+		if ( elapsed >= min_time )
+		{
+			break;
+		}
+
+		iterations *= 2;
+	}
+
+	double total_ops = double( iterations ) * double( ops );
+	double ns_per_op = elapsed * 1e9 / total_ops;
+	double mops = total_ops / elapsed / 1e6;
+	std::printf( "%-48s %12.3f %12.1f\n", name.c_str(), ns_per_op, mops );
+}
+
+
+std::vector<size_t> Runner::get_random_order( const size_t count )
+{
+	std::vector<size_t> ret( count );
+	std::iota( ret.begin(), ret.end(), size_t( 0 ) );
+	std::shuffle( ret.begin(), ret.end(), get_generator() );
+	return ret;
+}
+
+
+}  // namespace spot::math::bench
+
+
+int main( int argc, char** argv )
+{
+	using namespace spot::math::bench;
+
+	std::string filter;
+	double min_time = 0.1;
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		std::string arg = argv[i];
+		if ( arg == "--min-time" && i + 1 < argc )
+		{
+			min_time = std::atof( argv[++i] );
+		}
+		else if ( arg == "--help" || arg == "-h" )
+		{
+			std::printf( "Usage: %s [--min-time seconds] [filter]\n", argv[0] );
+			return EXIT_SUCCESS;
+		}
+		else
+		{
+			filter = arg;
+		}
+	}
+
+	Runner runner( filter, min_time );
+	for ( auto group : get_groups() )
+	{
+		group( runner );
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <spot/math/affine3.h>
+#include <spot/math/shape.h>
+
+
+namespace spot::math::bench
+{
+
+
+/// @brief Keeps the compiler from optimizing away a computed value
+template <typename T>
+inline void keep( const T& value )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+	asm volatile( "" : : "r,m"( value ) : "memory" );
+#else
+	static volatile char sink;
+	sink = *reinterpret_cast<const volatile char*>( &value );
+#endif
+}
+
+
+/// @brief Times benchmarks and prints one line per run
+class Runner
+{
+  public:
+	/// @param[in] filter Only runs benchmarks whose name contains it
+	/// @param[in] min_time Seconds every benchmark runs for at least
+	Runner( std::string filter, double min_time );
+
+	/// @brief Calls function until it ran for min_time and reports its cost
+	/// @param[in] name Name of the benchmark
+	/// @param[in] ops Number of operations performed by a single call
+	void run( const std::string& name, size_t ops, const std::function<void()>& function );
+
+	/// @brief Runs op( i ) over count elements, once in order and once in
+	/// random order, where hardware prefetching no longer hides cache misses.
+	/// Op is called directly in the loop so that it inlines into it
+	template <typename Op>
+	void run_array( const std::string& name, size_t count, Op op );
+
+  private:
+	/// @return Indices from 0 to count in random order
+	static std::vector<size_t> get_random_order( size_t count );
+
+	std::string filter;
+	double min_time;
+};
+
+
+/// @brief Data sizes for batched benchmarks, fitting L1, L2, and main memory
+constexpr size_t Sizes[] = { 256, 16384, 1048576 };
+
+constexpr size_t MaxSize = 1048576;
+
+
+/// @brief Random number generator shared by benchmarks, with a fixed seed
+std::mt19937& get_generator();
+
+
+/// @return count random floats in [min, max)
+std::vector<float> random_floats( size_t count, float min = -1.0f, float max = 1.0f );
+
+
+/// @return An element built from as many floats as it holds
+template <typename T>
+T from_floats( const float* f );
+
+template <>
+inline Vec2 from_floats<Vec2>( const float* f ) { return Vec2( f[0], f[1] ); }
+
+template <>
+inline Vec3 from_floats<Vec3>( const float* f ) { return Vec3( f[0], f[1], f[2] ); }
+
+template <>
+inline Quat from_floats<Quat>( const float* f ) { return Quat( f[0], f[1], f[2], f[3] ); }
+
+template <>
+inline Mat4 from_floats<Mat4>( const float* f ) { return Mat4( f ); }
+
+template <>
+inline Rect from_floats<Rect>( const float* f ) { return Rect( Vec2( f[0], f[1] ), Vec2( f[2], f[3] ) ); }
+
+template <>
+inline Box from_floats<Box>( const float* f ) { return Box( from_floats<Vec3>( f ), from_floats<Vec3>( f + 3 ) ); }
+
+template <>
+inline Sphere from_floats<Sphere>( const float* f ) { return Sphere( from_floats<Vec3>( f ), f[3] ); }
+
+template <>
+inline Affine3 from_floats<Affine3>( const float* f )
+{
+	Affine3 ret;
+	std::copy( f, f + 12, ret.matrix );
+	return ret;
+}
+
+
+/// @return count elements built from random floats, T must be a packed struct of floats
+template <typename T>
+std::vector<T> random( const size_t count, const float min = -1.0f, const float max = 1.0f )
+{
+	constexpr size_t size = sizeof( T ) / sizeof( float );
+	auto floats = random_floats( count * size, min, max );
+	std::vector<T> ret;
+	ret.reserve( count );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		ret.push_back( from_floats<T>( floats.data() + i * size ) );
+	}
+	return ret;
+}
+
+
+template <typename Op>
+void Runner::run_array( const std::string& name, const size_t count, Op op )
+{
+	auto sized = name + "/" + std::to_string( count );
+	run( sized, count, [&] {
+		for ( size_t i = 0; i < count; ++i )
+		{
+			op( i );
+		}
+	} );
+
+	if ( ( sized + "/random" ).find( filter ) == std::string::npos )
+	{
+		return;
+	}
+
+	auto order = get_random_order( count );
+	run( sized + "/random", count, [&] {
+		for ( auto i : order )
+		{
+			op( i );
+		}
+	} );
+}
+
+
+/// @brief Times op on the same, cache-resident operands, called in a loop
+/// so the cost of the call through Runner::run does not dominate
+template <typename Op>
+void run_single( Runner& runner, const std::string& name, Op op )
+{
+	constexpr size_t repeat = 1024;
+	runner.run( name, repeat, [&op] {
+		for ( size_t i = 0; i < repeat; ++i )
+		{
+			op();
+		}
+	} );
+}
+
+
+using Group = void ( * )( Runner& );
+
+
+/// @brief Registers a group of benchmarks at static initialization
+struct Registrar
+{
+	Registrar( Group group );
+};
+
+
+#define SPOT_BENCH_GROUP( name ) \
+	static void name( Runner& runner ); \
+	static Registrar name##_registrar( name ); \
+	static void name( Runner& runner )
+
+
+}  // namespace spot::math::bench
@@ -0,0 +1,216 @@
+#include "bench.h"
+
+#include <utility>
+
+#include <spot/math/affine3.h>
+#include <spot/math/hierarchy.h>
+#include <spot/math/mat.h>
+#include <spot/math/simd.h>
+#include <spot/math/world.h>
+
+
+namespace spot::math::bench
+{
+
+
+const char* get_name( const Simd simd )
+{
+	switch ( simd )
+	{
+	case Simd::Scalar: return "scalar";
+	case Simd::Sse2: return "sse2";
+	case Simd::Avx: return "avx";
+	case Simd::Avx2: return "avx2";
+	}
+	return "";
+}
+
+
+SPOT_BENCH_GROUP( mat4 )
+{
+	auto a = Mat4::Identity.rotate_x( 0.3f ).translate( { 1.0f, 2.0f, 3.0f } );
+	auto b = Mat4::Identity.rotate_y( 0.6f ).scale( { 2.0f, 2.0f, 2.0f } );
+	auto q = Quat( Vec3::Z, 0.4f );
+	auto v = Vec3( 1.0f, 2.0f, 3.0f );
+
+	run_single( runner, "Mat4::operator*", [&] { keep( a * b ); } );
+	run_single( runner, "Mat4::operator*(Vec3)", [&] { keep( a * v ); } );
+	run_single( runner, "Mat4::operator*(Vec4)", [&] { keep( a * Vec4( v ) ); } );
+	run_single( runner, "Mat4::Mat4(Quat)", [&] { keep( Mat4( q ) ); } );
+	run_single( runner, "Mat4::rotate(Quat)", [&] { keep( std::as_const( a ).rotate( q ) ); } );
+	run_single( runner, "Mat4::rotate_x", [&] { keep( std::as_const( a ).rotate_x( 0.2f ) ); } );
+	run_single( runner, "Mat4::translate", [&] { keep( std::as_const( a ).translate( v ) ); } );
+	run_single( runner, "Mat4::scale", [&] { keep( std::as_const( a ).scale( v ) ); } );
+	run_single( runner, "Mat4::from_trs", [&] { keep( Mat4::from_trs( v, q, v ) ); } );
+	run_single( runner, "Mat4::from_trs/chained", [&] {
+		keep( Mat4::Identity.translate( v ) * Mat4( q ) * Mat4::Identity.scale( v ) );
+	} );
+	run_single( runner, "Mat4::pre_rotate", [&] { keep( Mat4( a ).pre_rotate( q ) ); } );
+	run_single( runner, "Mat4::post_rotate", [&] { keep( Mat4( a ).post_rotate( q ) ); } );
+	run_single( runner, "Mat4::post_translate", [&] { keep( Mat4( a ).post_translate( v ) ); } );
+	run_single( runner, "Mat4::get_determinant", [&] { keep( b.get_determinant() ); } );
+	run_single( runner, "Mat4::get_inverse", [&] { keep( b.get_inverse() ); } );
+	run_single( runner, "Mat4::get_inverse_rigid", [&] { keep( a.get_inverse_rigid() ); } );
+	run_single( runner, "Mat4::get_inverse_affine", [&] { keep( b.get_inverse_affine() ); } );
+
+	for ( auto simd : { Simd::Scalar, Simd::Sse2, Simd::Avx, Simd::Avx2 } )
+	{
+		if ( simd > get_simd_support() )
+		{
+			continue;
+		}
+
+		const auto& kernels = get_mat4_kernels( simd );
+		auto prefix = std::string( "Mat4Kernels::" );
+		auto suffix = std::string( "/" ) + get_name( simd );
+		Mat4 r;
+		Vec4 v4 = v;
+		Vec4 rv;
+		run_single( runner, prefix + "mul" + suffix, [&] { kernels.mul( a.matrix, b.matrix, r.matrix ); keep( r ); } );
+		run_single( runner, prefix + "mul_vec4" + suffix, [&] { kernels.mul_vec4( a.matrix, &v4.x, &rv.x ); keep( rv ); } );
+		run_single( runner, prefix + "inverse" + suffix, [&] { keep( kernels.inverse( b.matrix, r.matrix ) ); keep( r ); } );
+
+		auto points = random<Vec3>( MaxSize );
+		for ( auto size : Sizes )
+		{
+			auto name = prefix + "transform_points" + suffix + "/" + std::to_string( size );
+			runner.run( name, size, [&] {
+				kernels.transform_points( a.matrix, &points[0].x, &points[0].x, size );
+			} );
+		}
+	}
+
+	auto mats = random<Mat4>( MaxSize );
+	auto points = random<Vec3>( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Mat4::operator*", size, [&]( size_t i ) { keep( mats[i] * b ); } );
+		runner.run_array( "Mat4::operator*(Vec3)", size, [&]( size_t i ) { points[i] = a * points[i]; } );
+
+		auto sized = "/" + std::to_string( size );
+		runner.run( "transform_points" + sized, size, [&] { transform_points( a, points.data(), points.data(), size ); } );
+		runner.run( "transform_points_affine" + sized, size, [&] { transform_points_affine( a, points.data(), points.data(), size ); } );
+		runner.run( "transform_vectors" + sized, size, [&] { transform_vectors( a, points.data(), points.data(), size ); } );
+		runner.run( "invert" + sized, size, [&] { invert( mats.data(), mats.data(), size ); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( mat )
+{
+	auto a = Mat4::Identity.rotate_x( 0.3f ).translate( { 1.0f, 2.0f, 3.0f } );
+	auto b = Mat4::Identity.rotate_y( 0.6f ).scale( { 2.0f, 2.0f, 2.0f } );
+	auto af = Mat4f( a );
+	auto bf = Mat4f( b );
+	auto ad = Mat4d( a );
+	auto bd = Mat4d( b );
+	auto ai = Mat4i( a );
+	auto bi = Mat4i( b );
+	auto v = Vec4d( 1.0, 2.0, 3.0, 1.0 );
+
+	run_single( runner, "Mat4f::operator*", [&] { keep( af * bf ); } );
+	run_single( runner, "Mat4d::operator*", [&] { keep( ad * bd ); } );
+	run_single( runner, "Mat4i::operator*", [&] { keep( ai * bi ); } );
+	run_single( runner, "Mat4d::operator*(Vec4d)", [&] { keep( ad * v ); } );
+	run_single( runner, "Mat4f::get_inverse", [&] { keep( af.get_inverse() ); } );
+	run_single( runner, "Mat4d::get_inverse", [&] { keep( ad.get_inverse() ); } );
+}
+
+
+SPOT_BENCH_GROUP( world )
+{
+	auto origin = Vec3d( 1.0e7, 2.0e5, -3.0e6 );
+	auto world = from_trs( origin + Vec3d( 1.0, 2.0, 3.0 ), Quat( Vec3::Y, 0.6f ), Vec3( 2.0f, 2.0f, 2.0f ) );
+
+	run_single( runner, "rebase(Mat4d)", [&] { keep( rebase( origin, world ) ); } );
+
+	std::vector<Vec3d> positions( MaxSize );
+	std::vector<Mat4d> transforms( MaxSize );
+	auto offsets = random<Vec3>( MaxSize );
+	for ( size_t i = 0; i < MaxSize; ++i )
+	{
+		positions[i] = origin + Vec3d( offsets[i] );
+		transforms[i] = from_trs( positions[i], Quat( Vec3::Y, offsets[i].x ), Vec3( 1.0f, 1.0f, 1.0f ) );
+	}
+	std::vector<Vec3> relative( MaxSize );
+	std::vector<Mat4> views( MaxSize );
+
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "rebase(Vec3d)/scalar", size, [&]( size_t i ) { keep( rebase( origin, positions[i] ) ); } );
+		runner.run( "rebase(Vec3d)/batch/" + std::to_string( size ), size, [&] {
+			rebase( origin, positions.data(), relative.data(), size );
+			keep( relative[0] );
+		} );
+		runner.run_array( "rebase(Mat4d)/scalar", size, [&]( size_t i ) { keep( rebase( origin, transforms[i] ) ); } );
+		runner.run( "rebase(Mat4d)/batch/" + std::to_string( size ), size, [&] {
+			rebase( origin, transforms.data(), views.data(), size );
+			keep( views[0] );
+		} );
+	}
+}
+
+
+SPOT_BENCH_GROUP( affine3 )
+{
+	auto a = Affine3( Mat4::Identity.rotate_x( 0.3f ).translate( { 1.0f, 2.0f, 3.0f } ) );
+	auto b = Affine3( Mat4::Identity.rotate_y( 0.6f ).scale( { 2.0f, 2.0f, 2.0f } ) );
+	auto v = Vec3( 1.0f, 2.0f, 3.0f );
+
+	run_single( runner, "Affine3::operator*", [&] { keep( a * b ); } );
+	run_single( runner, "Affine3::operator*(Vec3)", [&] { keep( a * v ); } );
+	run_single( runner, "Affine3::get_inverse", [&] { keep( b.get_inverse() ); } );
+
+	auto affines = random<Affine3>( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Affine3::operator*", size, [&]( size_t i ) { keep( affines[i] * b ); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( hierarchy )
+{
+	// Wide and shallow, as scene graphs usually are
+	constexpr size_t count = 16384;
+	auto translations = random<Vec3>( count );
+	Hierarchy hierarchy;
+	for ( Hierarchy::Id id = 0; id < count; ++id )
+	{
+		auto parent = id < 16 ? Hierarchy::None : ( id - 16 ) / 4;
+		hierarchy.add( parent, translations[id], Quat( Vec3::Y, 0.1f ) );
+	}
+	hierarchy.update();
+
+	runner.run( "Hierarchy::update/all", count, [&] {
+		for ( Hierarchy::Id root = 0; root < 16; ++root )
+		{
+			hierarchy.set_translation( root, translations[root] );
+		}
+		hierarchy.update();
+	} );
+
+	// A few leaves moving, as animated props
+	runner.run( "Hierarchy::update/leaves", count, [&] {
+		for ( Hierarchy::Id id = count - 1024; id < count; id += 64 )
+		{
+			hierarchy.set_translation( id, translations[id] );
+		}
+		hierarchy.update();
+	} );
+
+	runner.run( "Hierarchy::update/clean", count, [&] { hierarchy.update(); } );
+
+	ThreadPool pool;
+	auto executor = pool.get_executor();
+	runner.run( "Hierarchy::update/all/threads" + std::to_string( pool.size() ), count, [&] {
+		for ( Hierarchy::Id root = 0; root < 16; ++root )
+		{
+			hierarchy.set_translation( root, translations[root] );
+		}
+		hierarchy.update( executor );
+	} );
+}
+
+
+}  // namespace spot::math::bench
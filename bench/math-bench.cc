@@ -0,0 +1,124 @@
+#include "bench.h"
+
+#include <algorithm>
+
+#include <spot/math/mat4.h>
+#include <spot/math/rotation.h>
+#include <spot/math/vec3-soa.h>
+
+
+namespace spot::math::bench
+{
+
+
+SPOT_BENCH_GROUP( vec2 )
+{
+	auto a = Vec2( 1.0f, 2.0f );
+	auto b = Vec2( 3.0f, -4.0f );
+
+	run_single( runner, "Vec2::operator+", [&] { keep( a + b ); } );
+	run_single( runner, "Vec2::operator*=", [&] { a *= 1.0f; keep( a ); } );
+	run_single( runner, "Vec2::normalize", [&] { auto c = b; c.normalize(); keep( c ); } );
+
+	auto vecs = random<Vec2>( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Vec2::operator+", size, [&]( size_t i ) { vecs[i] += b; } );
+		runner.run_array( "Vec2::normalize", size, [&]( size_t i ) { vecs[i].normalize(); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( vec3 )
+{
+	auto a = Vec3( 1.0f, 2.0f, 3.0f );
+	auto b = Vec3( 3.0f, -4.0f, 0.5f );
+
+	run_single( runner, "Vec3::operator+", [&] { keep( a + b ); } );
+	run_single( runner, "Vec3::operator*", [&] { keep( a * 2.0f ); } );
+	run_single( runner, "Vec3::cross", [&] { keep( Vec3::cross( a, b ) ); } );
+	run_single( runner, "Vec3::dot", [&] { keep( Vec3::dot( a, b ) ); } );
+	run_single( runner, "Vec3::normalize", [&] { auto c = b; c.normalize(); keep( c ); } );
+	run_single( runner, "lerp(Vec3)", [&] { keep( lerp( a, b, 0.3f ) ); } );
+
+	auto vecs = random<Vec3>( MaxSize );
+	auto others = random<Vec3>( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Vec3::operator+", size, [&]( size_t i ) { vecs[i] += others[i]; } );
+		runner.run_array( "Vec3::dot", size, [&]( size_t i ) { keep( Vec3::dot( vecs[i], others[i] ) ); } );
+		runner.run_array( "Vec3::cross", size, [&]( size_t i ) { keep( Vec3::cross( vecs[i], others[i] ) ); } );
+		runner.run_array( "Vec3::normalize", size, [&]( size_t i ) { others[i].normalize(); } );
+		runner.run_array( "lerp(Vec3)", size, [&]( size_t i ) { vecs[i] = lerp( vecs[i], others[i], 0.5f ); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( vec3soa )
+{
+	auto a = Vec3Soa( random<Vec3>( MaxSize ) );
+	auto b = Vec3Soa( random<Vec3>( MaxSize ) );
+	Vec3Soa out;
+	std::vector<float> dots( MaxSize );
+
+	for ( auto size : Sizes )
+	{
+		// Operands hold the first size vectors
+		Vec3Soa sa( size );
+		Vec3Soa sb( size );
+		std::copy_n( a.x, size, sa.x );
+		std::copy_n( a.y, size, sa.y );
+		std::copy_n( a.z, size, sa.z );
+		std::copy_n( b.x, size, sb.x );
+		std::copy_n( b.y, size, sb.y );
+		std::copy_n( b.z, size, sb.z );
+
+		auto sized = "/" + std::to_string( size );
+		runner.run( "add(Vec3Soa)" + sized, size, [&] { add( sa, sb, out ); } );
+		runner.run( "dot(Vec3Soa)" + sized, size, [&] { dot( sa, sb, dots.data() ); } );
+		runner.run( "cross(Vec3Soa)" + sized, size, [&] { cross( sa, sb, out ); } );
+		runner.run( "normalize(Vec3Soa)" + sized, size, [&] { normalize( sa, out ); } );
+		runner.run( "lerp(Vec3Soa)" + sized, size, [&] { lerp( sa, sb, 0.5f, out ); } );
+		runner.run( "Vec3Soa::get_min" + sized, size, [&] { keep( sa.get_min() ); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( quat )
+{
+	auto a = Quat( Vec3::X, 0.5f );
+	auto b = Quat( Vec3::Y, 1.5f );
+	auto m = Mat4::Identity.rotate_z( 0.7f );
+
+	run_single( runner, "Quat::Quat(axis,angle)", [&] { keep( Quat( Vec3::Z, 0.3f ) ); } );
+	run_single( runner, "Quat::Quat(Mat4)", [&] { keep( Quat( m ) ); } );
+	run_single( runner, "Quat::operator*=", [&] { auto c = a; c *= b; keep( c ); } );
+	run_single( runner, "Quat::normalize", [&] { auto c = a; c.normalize(); keep( c ); } );
+	run_single( runner, "compose", [&] { keep( compose( a, b ) ); } );
+	run_single( runner, "Quat::renormalize", [&] { auto c = a; c.renormalize(); keep( c ); } );
+	run_single( runner, "rotate(Quat,Vec3)", [&] { keep( rotate( a, Vec3( 1.0f, 2.0f, 3.0f ) ) ); } );
+	run_single( runner, "Mat4(Quat)*Vec3", [&] { keep( Mat4( a ) * Vec3( 1.0f, 2.0f, 3.0f ) ); } );
+	run_single( runner, "slerp", [&] { keep( slerp( a, b, 0.3f ) ); } );
+	run_single( runner, "slerp/close", [&] { keep( slerp( a, a, 0.3f ) ); } );
+
+	auto quats = random<Quat>( MaxSize );
+	auto others = random<Quat>( MaxSize );
+	auto vecs = random<Vec3>( MaxSize );
+	std::vector<Quat> composed( MaxSize );
+	std::vector<Vec3> rotated( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Quat::operator*=", size, [&]( size_t i ) { quats[i] *= others[i]; } );
+		runner.run_array( "slerp", size, [&]( size_t i ) { keep( slerp( quats[i], others[i], 0.5f ) ); } );
+		runner.run_array( "compose", size, [&]( size_t i ) { keep( compose( quats[i], others[i] ) ); } );
+		runner.run_array( "rotate(Quat,Vec3)", size, [&]( size_t i ) { keep( rotate( quats[i], vecs[i] ) ); } );
+
+		auto sized = "/" + std::to_string( size );
+		runner.run( "compose(Quat*)" + sized, size, [&] { compose( quats.data(), others.data(), composed.data(), size ); } );
+		runner.run( "rotate(Quat*,Vec3*)" + sized, size, [&] { rotate( quats.data(), vecs.data(), rotated.data(), size ); } );
+		runner.run( "renormalize(Quat*)" + sized, size, [&] { renormalize( composed.data(), size ); } );
+	}
+}
+
+
+}  // namespace spot::math::bench
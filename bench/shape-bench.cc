@@ -0,0 +1,320 @@
+#include "bench.h"
+
+#include <spot/math/bounds.h>
+#include <spot/math/box-soa.h>
+#include <spot/math/bvh.h>
+#include <spot/math/frustum.h>
+#include <spot/math/grid.h>
+#include <spot/math/ray.h>
+#include <spot/math/sweep-and-prune.h>
+
+
+namespace spot::math::bench
+{
+
+
+SPOT_BENCH_GROUP( rect )
+{
+	auto a = Rect( { 0.0f, 0.0f }, { 2.0f, 1.0f } );
+	auto b = Rect( { 1.0f, 0.5f }, { -1.0f, 3.0f } );
+
+	run_single( runner, "Rect::contains", [&] { keep( a.contains( 0.5f, 0.5f ) ); } );
+	run_single( runner, "Rect::intersects", [&] { keep( a.intersects( b ) ); } );
+	run_single( runner, "Rect::distance", [&] { keep( a.distance( b ) ); } );
+
+	auto rects = random<Rect>( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Rect::intersects", size, [&]( size_t i ) { keep( rects[i].intersects( b ) ); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( box )
+{
+	auto a = Box( { 0.0f, 0.0f, 0.0f }, { 2.0f, 1.0f, 1.0f } );
+	auto b = Box( { 1.0f, 0.5f, 0.5f }, { 3.0f, 3.0f, 3.0f } );
+
+	run_single( runner, "Box::intersects", [&] { keep( a.intersects( b ) ); } );
+
+	auto boxes = random<Box>( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Box::intersects", size, [&]( size_t i ) { keep( boxes[i].intersects( b ) ); } );
+	}
+
+	auto soa = BoxSoa( boxes );
+	std::vector<uint64_t> mask( ( MaxSize + 63 ) / 64 );
+	std::vector<uint32_t> indices( MaxSize );
+	for ( auto size : Sizes )
+	{
+		BoxSoa sized;
+		sized.gather( boxes.data(), size );
+
+		auto suffix = "/" + std::to_string( size );
+		runner.run( "intersects(BoxSoa,mask)" + suffix, size, [&] { intersects( b, sized, mask.data() ); } );
+		runner.run( "intersects(BoxSoa,indices)" + suffix, size, [&] { keep( intersects( b, sized, indices.data() ) ); } );
+	}
+
+	// Bounds of transformed boxes, against the eight corners transformed one by one
+	auto m = Mat4::from_trs( { 1.0f, 2.0f, 3.0f }, Quat( Vec3::Y, 0.5f ), { 2.0f, 1.0f, 0.5f } );
+	run_single( runner, "Mat4::operator*(Box)", [&] { keep( m * a ); } );
+	run_single( runner, "Mat4::operator*(Box),corners", [&] {
+		auto ret = Box( Vec3( INFINITY, INFINITY, INFINITY ), Vec3( -INFINITY, -INFINITY, -INFINITY ) );
+		for ( size_t i = 0; i < 8; ++i )
+		{
+			auto p = m * Vec3( i & 1 ? a.b.x : a.a.x, i & 2 ? a.b.y : a.a.y, i & 4 ? a.b.z : a.a.z );
+			ret.a = Vec3( std::min( ret.a.x, p.x ), std::min( ret.a.y, p.y ), std::min( ret.a.z, p.z ) );
+			ret.b = Vec3( std::max( ret.b.x, p.x ), std::max( ret.b.y, p.y ), std::max( ret.b.z, p.z ) );
+		}
+		keep( ret );
+	} );
+
+	std::vector<Box> transformed( MaxSize );
+	for ( auto size : Sizes )
+	{
+		runner.run_array( "Mat4::operator*(Box)", size, [&]( size_t i ) { transformed[i] = m * boxes[i]; } );
+		runner.run( "transform_boxes/" + std::to_string( size ), size, [&] { transform_boxes( m, boxes.data(), transformed.data(), size ); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( frustum )
+{
+	// Perspective looking down -z from the origin with an infinite far plane
+	auto projection = Mat4::Zero;
+	projection( 0, 0 ) = 1.0f;
+	projection( 1, 1 ) = 1.0f;
+	projection( 2, 2 ) = -1.0f;
+	projection( 2, 3 ) = -0.2f;
+	projection( 3, 2 ) = -1.0f;
+	auto frustum = Frustum( projection );
+
+	auto boxes = random<Box>( MaxSize, -4.0f, 4.0f );
+	auto spheres = random<Sphere>( MaxSize, -4.0f, 4.0f );
+	for ( auto& sphere : spheres )
+	{
+		sphere.r = std::abs( sphere.r ) * 0.25f;
+	}
+	std::vector<Cull> culls( MaxSize );
+	std::vector<uint8_t> cache( MaxSize );
+
+	run_single( runner, "Frustum::classify(Box)", [&] { keep( frustum.classify( boxes[0] ) ); } );
+	for ( auto size : Sizes )
+	{
+		auto suffix = "/" + std::to_string( size );
+		runner.run_array( "Frustum::classify(Box)", size, [&]( size_t i ) { keep( frustum.classify( boxes[i] ) ); } );
+		runner.run( "Frustum::classify(Box*)" + suffix, size, [&] { frustum.classify( boxes.data(), size, culls.data() ); } );
+		runner.run( "Frustum::classify(Box*,cache)" + suffix, size, [&] { frustum.classify( boxes.data(), size, culls.data(), cache.data() ); } );
+		runner.run( "Frustum::classify(Sphere*)" + suffix, size, [&] { frustum.classify( spheres.data(), size, culls.data() ); } );
+		runner.run( "Frustum::classify(Sphere*,cache)" + suffix, size, [&] { frustum.classify( spheres.data(), size, culls.data(), cache.data() ); } );
+	}
+}
+
+
+SPOT_BENCH_GROUP( ray )
+{
+	auto box = Box( { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } );
+	auto sphere = Sphere( {}, 1.0f );
+
+	constexpr size_t count = 1024;
+	auto origins = random<Vec3>( count, -4.0f, 4.0f );
+	auto directions = random<Vec3>( count );
+	std::vector<Ray> rays( count );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		rays[i] = Ray( origins[i], directions[i] );
+	}
+
+	std::vector<RayPacket4> packets4;
+	std::vector<RayPacket8> packets8;
+	for ( size_t i = 0; i < count; i += 8 )
+	{
+		packets4.emplace_back( &rays[i] );
+		packets4.emplace_back( &rays[i + 4] );
+		packets8.emplace_back( &rays[i] );
+	}
+	std::vector<float> distances( count );
+
+	runner.run( "Ray::intersect(Box)", count, [&] {
+		for ( size_t i = 0; i < count; ++i )
+		{
+			distances[i] = rays[i].intersect( box );
+		}
+		keep( distances[0] );
+	} );
+	runner.run( "RayPacket4::intersect(Box)", count, [&] {
+		for ( size_t i = 0; i < packets4.size(); ++i )
+		{
+			packets4[i].intersect( box, &distances[i * 4] );
+		}
+		keep( distances[0] );
+	} );
+	runner.run( "RayPacket8::intersect(Box)", count, [&] {
+		for ( size_t i = 0; i < packets8.size(); ++i )
+		{
+			packets8[i].intersect( box, &distances[i * 8] );
+		}
+		keep( distances[0] );
+	} );
+
+	runner.run( "Ray::intersect(Sphere)", count, [&] {
+		for ( size_t i = 0; i < count; ++i )
+		{
+			distances[i] = rays[i].intersect( sphere );
+		}
+		keep( distances[0] );
+	} );
+	runner.run( "RayPacket4::intersect(Sphere)", count, [&] {
+		for ( size_t i = 0; i < packets4.size(); ++i )
+		{
+			packets4[i].intersect( sphere, &distances[i * 4] );
+		}
+		keep( distances[0] );
+	} );
+	runner.run( "RayPacket8::intersect(Sphere)", count, [&] {
+		for ( size_t i = 0; i < packets8.size(); ++i )
+		{
+			packets8[i].intersect( sphere, &distances[i * 8] );
+		}
+		keep( distances[0] );
+	} );
+}
+
+
+SPOT_BENCH_GROUP( bvh )
+{
+	// Unit boxes spread over a cube where each one overlaps a few others
+	auto origins = random<Vec3>( MaxSize, -50.0f, 50.0f );
+	std::vector<Box> boxes( MaxSize );
+	for ( size_t i = 0; i < MaxSize; ++i )
+	{
+		boxes[i] = Box( origins[i], origins[i] + Vec3::One );
+	}
+
+	auto queries = random<Vec3>( 1024, -50.0f, 50.0f );
+	auto directions = random<Vec3>( 1024 );
+
+	for ( auto size : { size_t( 1024 ), size_t( 16384 ) } )
+	{
+		auto sized = "/" + std::to_string( size );
+		std::vector<Box> scene( boxes.begin(), boxes.begin() + size );
+
+		Bvh bvh;
+		runner.run( "Bvh::build" + sized, size, [&] { bvh.build( scene ); } );
+		Arena arena;
+		runner.run( "Bvh::build(Arena)" + sized, size, [&] { bvh.build( scene, arena ); } );
+		runner.run( "Bvh::refit" + sized, size, [&] { bvh.refit( scene ); } );
+
+		std::vector<uint32_t> found;
+		size_t q = 0;
+		runner.run( "Bvh::query(Box)" + sized, 1, [&] {
+			found.clear();
+			auto& p = queries[q++ % queries.size()];
+			bvh.query( Box( p, p + Vec3( 4.0f, 4.0f, 4.0f ) ), found );
+			keep( found.size() );
+		} );
+		runner.run( "Bvh::query(Box),brute" + sized, 1, [&] {
+			auto& p = queries[q++ % queries.size()];
+			auto query = Box( p, p + Vec3( 4.0f, 4.0f, 4.0f ) );
+			size_t count = 0;
+			for ( auto& box : scene )
+			{
+				count += box.intersects( query );
+			}
+			keep( count );
+		} );
+
+		Bvh::Hit hit;
+		runner.run( "Bvh::raycast" + sized, 1, [&] {
+			auto i = q++ % queries.size();
+			keep( bvh.raycast( queries[i], directions[i], 200.0f, hit ) );
+		} );
+	}
+}
+
+
+SPOT_BENCH_GROUP( grid )
+{
+	constexpr size_t count = 4096;
+
+	// Rects of size 1 over a square where each one overlaps a few others
+	auto origins = random<Vec2>( count, -40.0f, 40.0f );
+	auto steps = random<Vec2>( count, -0.05f, 0.05f );
+	std::vector<Rect> rects( count );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		rects[i] = Rect( origins[i], origins[i] + Vec2( 1.0f, 1.0f ) );
+	}
+
+	RectGrid grid( 2.0f );
+	std::vector<RectGrid::Id> ids( count );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		ids[i] = grid.insert( rects[i] );
+	}
+
+	std::vector<std::pair<RectGrid::Id, RectGrid::Id>> pairs;
+	runner.run( "RectGrid::move", count, [&] {
+		for ( size_t i = 0; i < count; ++i )
+		{
+			rects[i].a += steps[i];
+			rects[i].b += steps[i];
+			grid.move( ids[i], rects[i] );
+		}
+	} );
+	runner.run( "RectGrid::get_pairs/" + std::to_string( count ), 1, [&] {
+		pairs.clear();
+		grid.get_pairs( pairs );
+		keep( pairs.size() );
+	} );
+	runner.run( "Rect::intersects,pairs/" + std::to_string( count ), 1, [&] {
+		size_t found = 0;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			for ( size_t j = i + 1; j < count; ++j )
+			{
+				found += rects[i].intersects( rects[j] );
+			}
+		}
+		keep( found );
+	} );
+}
+
+
+SPOT_BENCH_GROUP( sap )
+{
+	constexpr size_t count = 4096;
+
+	// Unit boxes over a cube where each one overlaps a few others, moving back and forth
+	auto origins = random<Vec3>( count, -16.0f, 16.0f );
+	auto steps = random<Vec3>( count, -0.02f, 0.02f );
+	std::vector<Box> boxes( count );
+
+	SweepAndPrune sap;
+	std::vector<SweepAndPrune::Id> ids( count );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		boxes[i] = Box( origins[i], origins[i] + Vec3::One );
+		ids[i] = sap.add( boxes[i] );
+	}
+
+	std::vector<SweepAndPrune::Pair> added;
+	std::vector<SweepAndPrune::Pair> removed;
+	size_t frame = 0;
+	runner.run( "SweepAndPrune::move+flush/" + std::to_string( count ), count, [&] {
+		const float direction = ( frame++ / 64 ) % 2 ? -1.0f : 1.0f;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			boxes[i].a += steps[i] * direction;
+			boxes[i].b += steps[i] * direction;
+			sap.move( ids[i], boxes[i] );
+		}
+		added.clear();
+		removed.clear();
+		sap.flush( added, removed );
+	} );
+}
+
+
+}  // namespace spot::math::bench
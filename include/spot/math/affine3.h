@@ -0,0 +1,55 @@
+#pragma once
+
+#include "spot/math/mat4.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Affine transform stored as the upper 3x4 part of a Mat4,
+/// the bottom row is implicitly 0, 0, 0, 1 so it is never multiplied
+class Affine3
+{
+  public:
+	static const Affine3 Zero;
+	static const Affine3 Identity;
+
+	Affine3() = default;
+	Affine3( std::initializer_list<float> l );
+
+	/// @brief Drops the bottom row of a matrix expected to be affine
+	explicit Affine3( const Mat4& m );
+
+	/// @return A Mat4 with the implicit bottom row
+	Mat4 get_mat4() const;
+
+	float&       operator()( size_t row, size_t column );
+	const float& operator()( size_t row, size_t column ) const;
+
+	bool operator==( const Affine3& other ) const;
+
+	/// @brief Composes two transforms with 36 multiplications
+	Affine3& operator*=( const Affine3& other );
+	Affine3  operator*( const Affine3& other ) const;
+
+	/// @brief Transforms a point, no division by w is needed
+	Vec3 operator*( const Vec3& p ) const;
+
+	/// @brief Transforms a direction, ignoring translation
+	Vec3 transform_vector( const Vec3& v ) const;
+
+	Vec3 get_translation() const;
+
+	/// @return The determinant of the linear 3x3 part
+	float get_determinant() const;
+
+	/// @return The inverse transform, assuming the linear part is invertible
+	Affine3 get_inverse() const;
+
+	/// Columns of 3 floats, the fourth one is the translation
+	float matrix[12] = {};
+};
+
+
+}  // namespace spot::math
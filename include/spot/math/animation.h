@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+
+#include "spot/math/math.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Keyframes of a value, times are expected to be strictly increasing
+template <typename T>
+struct Track
+{
+	std::vector<float> times;
+	std::vector<T>     values;
+};
+
+using Vec3Track = Track<Vec3>;
+using QuatTrack = Track<Quat>;
+
+
+/// @brief Remembers the key found by the last sample of a track,
+/// so that sampling at increasing times walks forward instead of searching
+struct TrackCursor
+{
+	size_t key = 0;
+};
+
+
+/// @brief How rotations are interpolated between two keys
+enum class Interpolation
+{
+	/// Normalized linear interpolation, fastest but not constant speed
+	Nlerp,
+	/// Nlerp with a corrected parameter, within 1e-3 radians of rotation from slerp
+	ApproxSlerp,
+	/// Exact spherical linear interpolation
+	Slerp,
+};
+
+
+/// @brief Finds the key k such that times[k] <= time < times[k + 1],
+/// times before the first key map to 0 and times after the last key map to the last one
+/// @param[in] times Strictly increasing key times
+/// @param[in] time Time to look for
+/// @param[in] cursor Key of the previous search, updated with the new one
+/// @return The key preceding time
+size_t find_key( const std::vector<float>& times, float time, TrackCursor& cursor );
+
+/// @brief Interpolates along the shortest path and normalizes the result
+/// @param[in] a Unit quaternion
+/// @param[in] b Unit quaternion
+Quat nlerp( const Quat& a, const Quat& b, float t );
+
+/// @brief Approximates slerp of unit quaternions with a corrected nlerp
+/// @return A rotation within 1e-3 radians of slerp( a, b, t )
+Quat approx_slerp( const Quat& a, const Quat& b, float t );
+
+/// @return The value of the track at that time, clamped to the first and last keys
+Vec3 sample( const Vec3Track& track, float time, TrackCursor& cursor );
+Quat sample( const QuatTrack& track, float time, TrackCursor& cursor,
+             Interpolation interpolation = Interpolation::Nlerp );
+
+/// @brief Samples many tracks at the same time
+/// @param[in] tracks Non-empty tracks
+/// @param[in] cursors One cursor for each track
+/// @param[out] out One value for each track
+void sample( const Vec3Track* tracks, TrackCursor* cursors, size_t count, float time, Vec3* out );
+
+/// @brief Samples many rotation tracks at the same time, interpolating four of them at once
+void sample( const QuatTrack* tracks, TrackCursor* cursors, size_t count, float time, Quat* out,
+             Interpolation interpolation = Interpolation::Nlerp );
+
+
+}  // namespace spot::math
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "spot/math/mat4.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Contiguous elements owned by someone else, such as an Arena. Batch
+/// functions take them as data() and size() like any other array
+template <typename T>
+class View
+{
+  public:
+	View() = default;
+	View( T* data, size_t count ) : elements { data }, count { count } {}
+
+	/// @brief Views of mutable elements convert to views of constant ones
+	template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T>>>
+	View( const View<U>& other ) : View( other.data(), other.size() ) {}
+
+	T*     data() const { return elements; }
+	size_t size() const { return count; }
+	bool   empty() const { return count == 0; }
+
+	T* begin() const { return elements; }
+	T* end() const { return elements + count; }
+
+	T& operator[]( const size_t i ) const { return elements[i]; }
+
+  private:
+	T*     elements = nullptr;
+	size_t count    = 0;
+};
+
+
+using Mat4View = View<Mat4>;
+using Vec3View = View<Vec3>;
+using QuatView = View<Quat>;
+
+
+/// @brief Linear allocator for transient data, such as scratch buffers and outputs of batch
+/// functions living until the end of a frame. Allocations bump an offset into blocks which are
+/// all released at once by reset, in constant time, and kept for the next frame, so that once
+/// they grew to what a frame needs there are no more heap allocations. Structures living
+/// across frames, as RectGrid and SweepAndPrune, recycle their own storage to the same end
+class Arena
+{
+  public:
+	/// Default alignment of allocations in bytes, enough for AVX loads
+	static constexpr size_t Alignment = 32;
+
+	/// @brief Position of an arena, to release what was allocated after it
+	struct Marker
+	{
+		size_t block  = 0;
+		size_t offset = 0;
+		size_t used   = 0;
+	};
+
+	/// @param[in] capacity Bytes of the first block, allocated on first use
+	explicit Arena( size_t capacity = 1 << 20 );
+
+	Arena( const Arena& ) = delete;
+	Arena& operator=( const Arena& ) = delete;
+	Arena( Arena&& other ) noexcept;
+	Arena& operator=( Arena&& other ) noexcept;
+
+	/// @return Memory for size bytes, adding a block at least twice as large as the last one
+	/// when the remaining blocks are too small
+	/// @param[in] alignment Power of two
+	void* allocate( size_t size, size_t alignment = Alignment );
+
+	/// @return A view of count elements which are not constructed, meant
+	/// to be written by batch functions before being read
+	template <typename T>
+	View<T> allocate( size_t count );
+
+	/// @return A view of count copies of value, T is not deduced from it
+	/// so that allocate( size, alignment ) is never taken for this one
+	template <typename T>
+	View<T> allocate( size_t count, const std::common_type_t<T>& value );
+
+	/// @brief Releases every allocation, keeping the blocks for the next ones
+	void reset() { rewind( {} ); }
+
+	Marker get_marker() const { return { current, offset, used }; }
+
+	/// @brief Releases the allocations made after a marker, which lets functions
+	/// borrow scratch memory from an arena and give it back when they return
+	void rewind( const Marker& marker );
+
+	/// @return Bytes allocated since the last reset, including padding for alignment
+	size_t get_used() const { return used; }
+
+	/// @return Bytes of all the blocks
+	size_t get_capacity() const;
+
+  private:
+	struct Free
+	{
+		void operator()( uint8_t* data ) const;
+	};
+
+	struct Block
+	{
+		std::unique_ptr<uint8_t[], Free> data;
+		size_t                           size = 0;
+	};
+
+	/// Size of the first block
+	size_t capacity = 0;
+
+	std::vector<Block> blocks;
+
+	/// Block allocations come from, the ones before it are full
+	size_t current = 0;
+
+	/// Bytes used in the current block
+	size_t offset = 0;
+
+	/// Bytes used in all the blocks
+	size_t used = 0;
+};
+
+
+template <typename T>
+View<T> Arena::allocate( const size_t count )
+{
+	static_assert( std::is_trivially_destructible_v<T>, "Arenas do not run destructors" );
+	const size_t alignment = alignof( T ) > Alignment ? alignof( T ) : Alignment;
+	return View<T>( static_cast<T*>( allocate( count * sizeof( T ), alignment ) ), count );
+}
+
+
+template <typename T>
+View<T> Arena::allocate( const size_t count, const std::common_type_t<T>& value )
+{
+	auto ret = allocate<T>( count );
+	std::uninitialized_fill( ret.begin(), ret.end(), value );
+	return ret;
+}
+
+
+}  // namespace spot::math
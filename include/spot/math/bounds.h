@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include "spot/math/mat4.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Transforms an array of boxes by the same matrix, as m * in[i]
+/// @param[out] out Bounds of the transformed boxes, may be the same array as in
+void transform_boxes( const Mat4& m, const Box* in, Box* out, size_t count );
+
+
+/// @brief Transforms an array of boxes, each one by the matrix at the same index as m[i] * in[i],
+/// meant for bounds of objects in world space after their transforms changed
+/// @param[out] out Bounds of the transformed boxes, may be the same array as in
+void transform_boxes( const Mat4* m, const Box* in, Box* out, size_t count );
+
+
+/// @brief Transforms an array of rectangles by the same matrix, as m * in[i]
+/// @param[out] out Bounds of the transformed rectangles, may be the same array as in
+void transform_rects( const Mat4& m, const Rect* in, Rect* out, size_t count );
+
+
+/// @brief Transforms an array of rectangles, each one by the matrix at the same index as m[i] * in[i]
+/// @param[out] out Bounds of the transformed rectangles, may be the same array as in
+void transform_rects( const Mat4* m, const Rect* in, Rect* out, size_t count );
+
+
+}  // namespace spot::math
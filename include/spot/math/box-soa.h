@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "spot/math/shape.h"
+#include "spot/math/vec3-soa.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Array of boxes as the structures of arrays of their corners,
+/// so that one box can be tested against four of them at once
+struct BoxSoa
+{
+	BoxSoa() = default;
+
+	/// @brief Gathers the corners of the boxes, normalizing them
+	explicit BoxSoa( const std::vector<Box>& boxes );
+
+	void gather( const Box* boxes, size_t count );
+
+	size_t size() const { return min.size(); }
+
+	/// Minimum corners
+	Vec3Soa min;
+	/// Maximum corners
+	Vec3Soa max;
+};
+
+
+/// @brief Tests one box against every box of an array, as Box::intersects
+/// @param[out] mask One bit for each box, in (boxes.size() + 63) / 64 words
+void intersects( const Box& box, const BoxSoa& boxes, uint64_t* mask );
+
+/// @brief Tests one box against every box of an array, as Box::intersects
+/// @param[out] indices Room for boxes.size() indices, the intersecting ones are written in order
+/// @return The number of intersecting boxes
+size_t intersects( const Box& box, const BoxSoa& boxes, uint32_t* indices );
+
+
+}  // namespace spot::math
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "spot/math/arena.h"
+#include "spot/math/ray.h"
+#include "spot/math/shape.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Bounding volume hierarchy over a set of boxes, built with binned SAH
+/// and stored as a flat array of nodes in depth-first order
+class Bvh
+{
+  public:
+	/// @brief 32 bytes, two nodes per cache line
+	struct Node
+	{
+		Vec3 min;
+		/// First primitive of a leaf, or the right child of an inner node
+		/// as the left child always follows its parent
+		uint32_t offset = 0;
+		Vec3 max;
+		/// Primitives of a leaf, 0 for inner nodes
+		uint32_t count = 0;
+
+		bool is_leaf() const { return count > 0; }
+	};
+
+	/// @brief Closest box hit by a ray
+	struct Hit
+	{
+		/// Index of the box in the vector the hierarchy was built from
+		uint32_t index = 0;
+		/// Distance along the ray, in units of its direction
+		float distance = 0.0f;
+	};
+
+	/// Nodes never get deeper than this, so queries can use a fixed stack
+	static constexpr uint32_t MaxDepth = 64;
+
+	Bvh() = default;
+
+	/// @brief Builds a hierarchy over the boxes
+	/// @param[in] max_leaf Primitives a leaf holds at most, unless MaxDepth is reached
+	explicit Bvh( const std::vector<Box>& boxes, uint32_t max_leaf = 4 );
+
+	/// @brief Rebuilds the hierarchy over a new set of boxes
+	void build( const std::vector<Box>& boxes, uint32_t max_leaf = 4 );
+
+	/// @brief Same as the other overload, with scratch memory from an arena which
+	/// is given back on return, so that rebuilding every frame does not allocate
+	void build( const std::vector<Box>& boxes, Arena& scratch, uint32_t max_leaf = 4 );
+
+	/// @brief Updates the bounds of every node after the boxes moved, keeping the topology,
+	/// which stays correct but gets less efficient as boxes travel far from where they were
+	/// @param[in] boxes The same number of boxes, in the same order, of the last build
+	void refit( const std::vector<Box>& boxes );
+
+	/// @brief Finds the boxes overlapping another box, touching faces do not count
+	/// @param[out] out Indices of the overlapping boxes are appended here
+	void query( const Box& box, std::vector<uint32_t>& out ) const;
+
+	/// @brief Finds all the boxes hit by a ray
+	/// @param[in] max_distance Boxes further than this are ignored
+	/// @param[out] out Indices of the hit boxes are appended here, unordered
+	void query( const Ray& ray, float max_distance, std::vector<uint32_t>& out ) const;
+
+	/// @param[in] origin Origin of the ray
+	/// @param[in] direction Direction of the ray, not necessarily normalized
+	void query( const Vec3& origin, const Vec3& direction, float max_distance, std::vector<uint32_t>& out ) const;
+
+	/// @brief Finds the closest box hit by a ray, visiting the nearest child first
+	/// @return Whether a box was hit within max_distance
+	bool raycast( const Ray& ray, float max_distance, Hit& hit ) const;
+	bool raycast( const Vec3& origin, const Vec3& direction, float max_distance, Hit& hit ) const;
+
+	/// Depth-first nodes, the first one is the root
+	std::vector<Node> nodes;
+
+	/// Index of the original box for every primitive referenced by the leaves
+	std::vector<uint32_t> indices;
+
+	/// Boxes in leaf order with a as minimum and b as maximum,
+	/// so that leaves read contiguous memory
+	std::vector<Box> primitives;
+
+  private:
+	/// @param[in] bounds Scratch for a normalized box for each box
+	/// @param[in] centroids Scratch for the centre of each box
+	void build( const std::vector<Box>& boxes, uint32_t max_leaf, Box* bounds, Vec3* centroids );
+};
+
+
+}  // namespace spot::math
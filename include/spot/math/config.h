@@ -0,0 +1,20 @@
+#pragma once
+
+/// @file Build configuration shared by the headers
+///
+/// When SPOT_MATH_INLINE is defined, which the MATHSPOT_INLINE CMake option
+/// does for every target linking mathspot, the definitions of shape.h and
+/// mat4.h are included by those headers, inline and constexpr where possible,
+/// so trivial operators no longer go through a call. Vectors, quaternions,
+/// and sizes are templates, always defined in vec.h and math.h.
+///
+/// When SPOT_MATH_FAST is defined, which the MATHSPOT_FAST CMake option does,
+/// normalize, length, and slerp use Precision::Fast, see precision.h.
+
+#ifdef SPOT_MATH_INLINE
+#define SPOT_MATH_API inline
+#define SPOT_MATH_CONSTEXPR constexpr
+#else
+#define SPOT_MATH_API
+#define SPOT_MATH_CONSTEXPR
+#endif
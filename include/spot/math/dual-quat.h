@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+#include "spot/math/mat4.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Rigid transform as a rotation quaternion, the real part, and a dual part
+/// holding the translation as t * real / 2, which unlike matrices can be blended
+/// without the volume loss of linear blend skinning
+class DualQuat
+{
+  public:
+	static const DualQuat Identity;
+
+	DualQuat() = default;
+	DualQuat( const Quat& real, const Quat& dual );
+
+	/// @brief Takes rotation and translation of a matrix expected to be rigid, without scale
+	explicit DualQuat( const Mat4& m );
+
+	/// @brief Builds a transform rotating first and translating afterwards, as Mat4::from_trs
+	/// @param[in] t Translation
+	/// @param[in] r Rotation, expected to be normalized
+	static DualQuat from_tr( const Vec3& t, const Quat& r );
+
+	/// @return A Mat4 with the same rotation and translation
+	Mat4 get_mat4() const;
+
+	/// @brief Divides both parts by the length of the real one, which makes a blend
+	/// rigid again, the dual part orthogonal to the real one being ignored by transforms
+	void normalize();
+
+	/// @brief Composes two transforms, other is applied first
+	DualQuat& operator*=( const DualQuat& other );
+	DualQuat  operator*( const DualQuat& other ) const;
+
+	/// @brief Transforms a point, expecting a normalized dual quaternion
+	Vec3 operator*( const Vec3& p ) const;
+
+	/// @brief Transforms a direction, ignoring translation
+	Vec3 transform_vector( const Vec3& v ) const;
+
+	Vec3 get_translation() const;
+
+	/// @return The inverse transform, assuming it is normalized
+	DualQuat get_inverse() const;
+
+	Quat real = {};
+	Quat dual = {};
+};
+
+
+/// @brief Weighted sum of count transforms, normalized afterwards.
+/// Each real part is flipped to the hemisphere of the one with the largest weight,
+/// the first of them on ties, so that a rotation and its negation, which are
+/// the same, do not cancel out
+/// @param[in] weights One for each transform, expected to sum to one
+DualQuat blend( const DualQuat* dqs, const float* weights, size_t count );
+
+
+}  // namespace spot::math
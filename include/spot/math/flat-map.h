@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace spot::math
+{
+
+
+/// @brief Hash table of 64 bit keys with every slot in one array, probed linearly.
+/// Unlike std::unordered_map it does not allocate a node for each key nor free it on
+/// erase, so once it grew to the keys a frame needs, inserting and erasing them does
+/// not touch the heap. Values are trivially copyable, as erasing moves them around
+template <typename T>
+class FlatMap
+{
+	static_assert( std::is_trivially_copyable_v<T>, "Values are moved by copy within the table" );
+
+  public:
+	/// @return Number of keys
+	size_t size() const { return count; }
+	bool   empty() const { return count == 0; }
+
+	/// @return The value of a key, nullptr when not found
+	T*       find( uint64_t key );
+	const T* find( uint64_t key ) const;
+
+	bool contains( uint64_t key ) const { return find( key ) != nullptr; }
+
+	/// @return The value of a key, inserted as value when missing, and whether it was inserted
+	std::pair<T*, bool> emplace( uint64_t key, const T& value = {} );
+
+	/// @return Whether the key was found and removed
+	bool erase( uint64_t key );
+
+	/// @brief Removes every key, keeping the slots for the next ones
+	void clear();
+
+	/// @brief Calls f( key, value ) for every key, in no particular order
+	template <typename F>
+	void for_each( F f ) const;
+
+  private:
+	struct Slot
+	{
+		uint64_t key = 0;
+		T        value = {};
+		bool     used = false;
+	};
+
+	/// @return Where a key is, or the free slot ending its probe sequence
+	size_t get_slot( uint64_t key ) const;
+
+	/// @return First slot a key probes, from the top bits of a Fibonacci hash
+	size_t get_home( uint64_t key ) const;
+
+	/// @brief Doubles the slots, moving every key to the new ones
+	void grow();
+
+	std::vector<Slot> slots;
+
+	/// Bits of the number of slots, which is a power of two
+	uint32_t bits = 0;
+
+	size_t count = 0;
+};
+
+
+template <typename T>
+size_t FlatMap<T>::get_home( const uint64_t key ) const
+{
+	return size_t( ( key * 0x9e3779b97f4a7c15ull ) >> ( 64 - bits ) );
+}
+
+
+template <typename T>
+size_t FlatMap<T>::get_slot( const uint64_t key ) const
+{
+	const size_t mask = slots.size() - 1;
+	size_t       i    = get_home( key );
+	while ( slots[i].used && slots[i].key != key )
+	{
+		i = ( i + 1 ) & mask;
+	}
+	return i;
+}
+
+
+template <typename T>
+T* FlatMap<T>::find( const uint64_t key )
+{
+	return const_cast<T*>( static_cast<const FlatMap&>( *this ).find( key ) );
+}
+
+
+template <typename T>
+const T* FlatMap<T>::find( const uint64_t key ) const
+{
+	if ( count == 0 )
+	{
+		return nullptr;
+	}
+	auto& slot = slots[get_slot( key )];
+	return slot.used ? &slot.value : nullptr;
+}
+
+
+template <typename T>
+std::pair<T*, bool> FlatMap<T>::emplace( const uint64_t key, const T& value )
+{
+	// At most three quarters full, so that probe sequences stay short
+	if ( 4 * ( count + 1 ) > 3 * slots.size() )
+	{
+		grow();
+	}
+
+	auto& slot = slots[get_slot( key )];
+	if ( slot.used )
+	{
+		return { &slot.value, false };
+	}
+	slot = { key, value, true };
+	++count;
+	return { &slot.value, true };
+}
+
+
+template <typename T>
+bool FlatMap<T>::erase( const uint64_t key )
+{
+	if ( count == 0 )
+	{
+		return false;
+	}
+
+	size_t i = get_slot( key );
+	if ( !slots[i].used )
+	{
+		return false;
+	}
+
+	// Shifts back the keys following it which would not be found past a free slot
+	const size_t mask = slots.size() - 1;
+	for ( size_t j = ( i + 1 ) & mask; slots[j].used; j = ( j + 1 ) & mask )
+	{
+		// Distances from the home of the key to the free slot and to where it is
+		const size_t home = get_home( slots[j].key );
+		if ( ( ( i - home ) & mask ) < ( ( j - home ) & mask ) )
+		{
+			slots[i] = slots[j];
+			i        = j;
+		}
+	}
+	slots[i].used = false;
+	--count;
+	return true;
+}
+
+
+template <typename T>
+void FlatMap<T>::clear()
+{
+	if ( count == 0 )
+	{
+		return;
+	}
+	for ( auto& slot : slots )
+	{
+		slot.used = false;
+	}
+	count = 0;
+}
+
+
+template <typename T>
+template <typename F>
+void FlatMap<T>::for_each( F f ) const
+{
+	for ( auto& slot : slots )
+	{
+		if ( slot.used )
+		{
+			f( slot.key, slot.value );
+		}
+	}
+}
+
+
+template <typename T>
+void FlatMap<T>::grow()
+{
+	auto old = std::move( slots );
+	bits     = bits == 0 ? 4 : bits + 1;
+	slots.assign( size_t( 1 ) << bits, Slot() );
+
+	for ( auto& slot : old )
+	{
+		if ( slot.used )
+		{
+			slots[get_slot( slot.key )] = slot;
+		}
+	}
+}
+
+
+/// @brief Value of a FlatMap used as a set of keys
+struct NoValue
+{
+};
+
+using FlatSet = FlatMap<NoValue>;
+
+
+}  // namespace spot::math
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+#include "spot/math/mat4.h"
+#include "spot/math/shape.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Plane of points p where dot( n, p ) + d is zero,
+/// the normal points towards the positive half-space
+struct Plane
+{
+	/// @return The signed distance of a point, in units of the length of the normal
+	float distance( const Vec3& p ) const { return n.x * p.x + n.y * p.y + n.z * p.z + d; }
+
+	Vec3 n;
+	float d = 0.0f;
+};
+
+
+/// @brief Where a shape lies with respect to a frustum
+enum class Cull : uint8_t
+{
+	Outside,
+	Intersecting,
+	Inside,
+};
+
+
+/// @brief Depth range of the clip space a projection maps to
+enum class ClipDepth
+{
+	/// OpenGL convention, -w <= z <= w
+	NegativeOneToOne,
+	/// Vulkan and Direct3D convention, 0 <= z <= w
+	ZeroToOne,
+};
+
+
+/// @brief Volume seen through a projection, as six planes facing inwards
+class Frustum
+{
+  public:
+	enum Side
+	{
+		Left,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+		Count
+	};
+
+	Frustum() = default;
+
+	/// @brief Extracts the planes of a view-projection matrix, which are normalized
+	/// unless degenerate, as the far plane of an infinite projection
+	explicit Frustum( const Mat4& view_projection, ClipDepth depth = ClipDepth::NegativeOneToOne );
+
+	/// @brief Classifies a box, which is outside when all of its corners are behind one plane
+	/// and inside when all of them are in front of every plane. Boxes outside near the edges
+	/// of the frustum may be classified as intersecting, as no plane separates them alone
+	Cull classify( const Box& box ) const;
+	Cull classify( const Sphere& sphere ) const;
+
+	/// @brief Classifies an array of boxes, testing one of them against all planes at once
+	/// @param[out] out One classification for each box
+	/// @param[in,out] cache Optional plane coherency cache, one byte for each box which
+	/// holds the plane that rejected it last time, and is tested first. Zero initialize
+	/// it and pass it back every frame, with the boxes in the same order
+	void classify( const Box* boxes, size_t count, Cull* out, uint8_t* cache = nullptr ) const;
+	void classify( const Sphere* spheres, size_t count, Cull* out, uint8_t* cache = nullptr ) const;
+
+	Plane planes[Count];
+};
+
+
+}  // namespace spot::math
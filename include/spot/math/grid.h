@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "spot/math/flat-map.h"
+#include "spot/math/shape.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Broadphase for rects hashed into the cells of an infinite uniform grid,
+/// so queries only look at rects in the cells they touch. Cells and their lists
+/// of ids are recycled, so moving rects around does not allocate once the grid
+/// held as many cells as it needs. Rects covering more than MaxCells cells, up to
+/// infinite ones, are kept in a list tested by every query instead
+class RectGrid
+{
+  public:
+	using Id = uint32_t;
+
+	/// Cells a rect or a query covers at most to go through the cells
+	static constexpr int64_t MaxCells = 1024;
+
+	/// Cell coordinates are clamped within plus or minus this
+	static constexpr int32_t MaxCell = 1 << 30;
+
+	/// @param[in] cell_size Side of a cell, ideally close to the size of a typical rect
+	explicit RectGrid( float cell_size );
+
+	/// @return An id for the rect, ids of removed rects are reused
+	Id insert( const Rect& rect );
+
+	/// @brief Updates the bounds of a rect, touching the cells only when it crosses their borders
+	void move( Id id, const Rect& rect );
+
+	void remove( Id id );
+
+	/// @return Number of rects in the grid
+	size_t size() const { return count; }
+
+	/// @return The normalized bounds of a rect, with a as minimum and b as maximum
+	Rect get_rect( Id id ) const;
+
+	/// @brief Finds the rects overlapping a rect, each of them once
+	/// @param[out] out Ids are appended here
+	void query( const Rect& rect, std::vector<Id>& out ) const;
+
+	/// @brief Finds every pair of overlapping rects, each of them once
+	/// @param[out] out Pairs are appended here, with the smaller id first
+	void get_pairs( std::vector<std::pair<Id, Id>>& out ) const;
+
+  private:
+	/// @brief Range of cells covered by a rect, inclusive
+	struct Cells
+	{
+		int32_t x0, y0, x1, y1;
+
+		bool operator==( const Cells& other ) const;
+
+		/// @return Whether there are more than MaxCells of them
+		bool is_large() const;
+	};
+
+	struct Entry
+	{
+		Vec2  min;
+		Vec2  max;
+		Cells cells;
+		bool  alive = false;
+		/// In the list of large rects rather than in cells
+		bool  large = false;
+	};
+
+	Cells get_cells( const Vec2& min, const Vec2& max ) const;
+
+	static uint64_t get_key( int32_t x, int32_t y );
+
+	void add_to_cells( Id id );
+	void remove_from_cells( Id id );
+
+	float inv_cell_size;
+	size_t count = 0;
+
+	std::vector<Entry> entries;
+	std::vector<Id> free_ids;
+
+	/// Index in lists of the ids of the rects touching each non-empty cell
+	FlatMap<uint32_t> cells;
+
+	/// Lists of ids of the cells, the ones of cells which became empty
+	/// are kept with their capacity for the next cells
+	std::vector<std::vector<Id>> lists;
+	std::vector<uint32_t> free_lists;
+
+	/// Ids of the rects covering more than MaxCells cells
+	std::vector<Id> large;
+};
+
+
+}  // namespace spot::math
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "spot/math/mat4.h"
+#include "spot/math/thread-pool.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Tree of transforms stored as flat arrays in topological order,
+/// where parents always come before their children, so that world matrices
+/// are updated in a single pass going forward through memory
+class Hierarchy
+{
+  public:
+	using Id = uint32_t;
+
+	/// Parent of the roots
+	static constexpr Id None = UINT32_MAX;
+
+	/// @brief Appends a node, which starts dirty
+	/// @param[in] parent A node already in the hierarchy, or None for a root
+	/// @return The index of the node, which is always the current size
+	Id add( Id parent, const Vec3& translation = {}, const Quat& rotation = Quat::Identity, const Vec3& scale = Vec3::One );
+
+	/// @brief Setters mark the node dirty, so that the next update recomputes its subtree
+	void set_local( Id id, const Vec3& translation, const Quat& rotation, const Vec3& scale );
+	void set_translation( Id id, const Vec3& translation );
+	void set_rotation( Id id, const Quat& rotation );
+	void set_scale( Id id, const Vec3& scale );
+
+	/// @brief Recomputes the world matrices of dirty nodes and of their descendants,
+	/// starting from the first dirty node, as parent world * local TRS
+	void update();
+
+	/// @brief Same as update, running the nodes of each depth level as parallel tasks,
+	/// which gives the same results as every node is computed in the same way.
+	/// Levels above the shallowest dirty node and nodes before the first dirty one are
+	/// skipped, and when no more than grain nodes may change it runs update instead
+	/// @param[in] executor Runs the tasks of a level, a level starts after the previous one returns
+	/// @param[in] grain Nodes of a level each task computes
+	void update( const Executor& executor, size_t grain = 256 );
+
+	size_t size() const { return parents.size(); }
+
+	Id get_parent( Id id ) const { return parents[id]; }
+	const Vec3& get_translation( Id id ) const { return translations[id]; }
+	const Quat& get_rotation( Id id ) const { return rotations[id]; }
+	const Vec3& get_scale( Id id ) const { return scales[id]; }
+
+	/// @return The world matrix of a node as of the last update
+	const Mat4& get_world( Id id ) const { return worlds[id]; }
+
+	/// @return World matrices of every node, in the order of their ids
+	const std::vector<Mat4>& get_worlds() const { return worlds; }
+
+	/// @return Whether the world matrix of a node changed during the last update
+	bool is_updated( Id id ) const { return versions[id] == version; }
+
+  private:
+	void mark_dirty( Id id );
+
+	/// @brief Computes the world matrix of a node if it or its parent changed
+	void update_node( Id id );
+
+	std::vector<Id> parents;
+	std::vector<Vec3> translations;
+	std::vector<Quat> rotations;
+	std::vector<Vec3> scales;
+	std::vector<Mat4> worlds;
+
+	/// Ids of the nodes at each depth, in increasing order
+	std::vector<std::vector<Id>> levels;
+	std::vector<uint32_t> depths;
+
+	/// Nodes whose local transform changed since the last update
+	std::vector<uint8_t> dirty;
+
+	/// Update during which each world matrix was last computed, children of
+	/// a node computed during the current update need to be computed as well
+	std::vector<uint32_t> versions;
+	uint32_t version = 0;
+
+	/// Nodes before this one are not dirty
+	Id first_dirty = 0;
+
+	/// Nodes at shallower depths are not dirty
+	uint32_t min_dirty_depth = 0;
+};
+
+
+}  // namespace spot::math
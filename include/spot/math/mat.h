@@ -0,0 +1,301 @@
+#pragma once
+
+#include "spot/math/math.h"
+#include "spot/math/vec.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Matrix of R rows and C columns of an arithmetic type, stored in column-major order
+/// like Mat4, whose operators are unrolled at compile time and usable in constant expressions
+/// @note Mat4, the 4x4 float matrix, is a specialization defined in mat4.h, and products
+/// of 4x4 double matrices use SIMD kernels, so neither is usable in constant expressions
+template <size_t R, size_t C, typename T>
+class Mat
+{
+	static_assert( R > 0 && C > 0, "Matrices have at least one element" );
+	static_assert( std::is_arithmetic_v<T>, "Elements of matrices are numbers" );
+
+  public:
+	using Scalar = T;
+	static constexpr size_t Rows = R;
+	static constexpr size_t Columns = C;
+
+	static const Mat Zero;
+	/// Only defined for square matrices
+	static const Mat Identity;
+
+	constexpr Mat() = default;
+
+	/// @brief Constructs a matrix from its R * C elements in column-major order, converted to T
+	template <typename... A, typename = std::enable_if_t<sizeof...( A ) == R * C && ( std::is_arithmetic_v<A> && ... )>>
+	constexpr Mat( const A... a )
+	: matrix { T( a )... }
+	{
+	}
+
+	/// @brief Converts the elements of another matrix to T
+	template <typename U>
+	constexpr explicit Mat( const Mat<R, C, U>& other )
+	: Mat( generate( [&]( size_t row, size_t column ) { return other( row, column ); } ) )
+	{
+	}
+
+	/// @return A matrix with f( row, column ) as the element at that row and column
+	template <typename F>
+	static constexpr Mat generate( F&& f ) { return generate( f, std::make_index_sequence<R * C>() ); }
+
+	constexpr T& operator()( const size_t row, const size_t column ) { return matrix[row + R * column]; }
+	constexpr const T& operator()( const size_t row, const size_t column ) const { return matrix[row + R * column]; }
+
+	constexpr Vec<R, T> get_column( const size_t column ) const
+	{
+		return Vec<R, T>::generate( [&]( size_t row ) { return ( *this )( row, column ); } );
+	}
+
+	constexpr Vec<C, T> get_row( const size_t row ) const
+	{
+		return Vec<C, T>::generate( [&]( size_t column ) { return ( *this )( row, column ); } );
+	}
+
+	constexpr Mat<C, R, T> get_transposed() const
+	{
+		return Mat<C, R, T>::generate( [&]( size_t row, size_t column ) { return ( *this )( column, row ); } );
+	}
+
+	/// @return The matrix without a row and a column
+	constexpr Mat<R - 1, C - 1, T> get_minor( size_t row, size_t column ) const;
+
+	/// @return The determinant of a square matrix, by cofactor expansion down to 3x3
+	constexpr T get_determinant() const;
+
+	/// @return The inverse of a square matrix as its adjugate over its determinant,
+	/// which is not meaningful for singular matrices
+	constexpr Mat get_inverse() const;
+
+	constexpr Mat& operator+=( const Mat& o ) { return *this = *this + o; }
+	constexpr Mat& operator-=( const Mat& o ) { return *this = *this - o; }
+	constexpr Mat& operator*=( const T k ) { return *this = *this * k; }
+	constexpr Mat& operator*=( const Mat& o ) { return *this = *this * o; }
+
+	T matrix[R * C] = {};
+
+  private:
+	template <typename F, size_t... I>
+	static constexpr Mat generate( F& f, std::index_sequence<I...> )
+	{
+		return Mat( T( f( I % R, I / R ) )... );
+	}
+};
+
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R, C, T> Mat<R, C, T>::Zero = {};
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R, C, T> Mat<R, C, T>::Identity = Mat<R, C, T>::generate( []( size_t row, size_t column ) {
+	static_assert( R == C, "Identity of a matrix which is not square" );
+	return row == column ? T( 1 ) : T( 0 );
+} );
+
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R - 1, C - 1, T> Mat<R, C, T>::get_minor( const size_t row, const size_t column ) const
+{
+	return Mat<R - 1, C - 1, T>::generate( [&]( size_t r, size_t c ) {
+		return ( *this )( r < row ? r : r + 1, c < column ? c : c + 1 );
+	} );
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr T Mat<R, C, T>::get_determinant() const
+{
+	static_assert( R == C, "Determinant of a matrix which is not square" );
+	const auto& m = *this;
+	if constexpr ( R == 1 )
+	{
+		return m( 0, 0 );
+	}
+	else if constexpr ( R == 2 )
+	{
+		return m( 0, 0 ) * m( 1, 1 ) - m( 0, 1 ) * m( 1, 0 );
+	}
+	else if constexpr ( R == 3 )
+	{
+		return m( 0, 0 ) * ( m( 1, 1 ) * m( 2, 2 ) - m( 1, 2 ) * m( 2, 1 ) ) -
+			m( 0, 1 ) * ( m( 1, 0 ) * m( 2, 2 ) - m( 1, 2 ) * m( 2, 0 ) ) +
+			m( 0, 2 ) * ( m( 1, 0 ) * m( 2, 1 ) - m( 1, 1 ) * m( 2, 0 ) );
+	}
+	else
+	{
+		// Expansion along the first row, with alternating signs
+		return T( detail::sum( [&]( size_t column ) {
+			const T cofactor = m.get_minor( 0, column ).get_determinant();
+			return column % 2 == 0 ? m( 0, column ) * cofactor : -m( 0, column ) * cofactor;
+		}, std::make_index_sequence<C>() ) );
+	}
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R, C, T> Mat<R, C, T>::get_inverse() const
+{
+	static_assert( R == C, "Inverse of a matrix which is not square" );
+	if constexpr ( R == 1 )
+	{
+		return Mat( T( 1 ) / matrix[0] );
+	}
+	else
+	{
+		const T inv_det = T( 1 ) / get_determinant();
+		// Adjugate, the transpose of the matrix of cofactors
+		return generate( [&]( size_t row, size_t column ) {
+			const T cofactor = get_minor( column, row ).get_determinant();
+			return ( row + column ) % 2 == 0 ? cofactor * inv_det : -cofactor * inv_det;
+		} );
+	}
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R, C, T> operator+( const Mat<R, C, T>& a, const Mat<R, C, T>& b )
+{
+	return Mat<R, C, T>::generate( [&]( size_t row, size_t column ) { return a( row, column ) + b( row, column ); } );
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R, C, T> operator-( const Mat<R, C, T>& a, const Mat<R, C, T>& b )
+{
+	return Mat<R, C, T>::generate( [&]( size_t row, size_t column ) { return a( row, column ) - b( row, column ); } );
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R, C, T> operator*( const Mat<R, C, T>& m, const typename Mat<R, C, T>::Scalar k )
+{
+	return Mat<R, C, T>::generate( [&]( size_t row, size_t column ) { return m( row, column ) * k; } );
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr Mat<R, C, T> operator*( const typename Mat<R, C, T>::Scalar k, const Mat<R, C, T>& m )
+{
+	return m * k;
+}
+
+
+template <size_t R, size_t K, size_t C, typename T>
+constexpr Mat<R, C, T> operator*( const Mat<R, K, T>& a, const Mat<K, C, T>& b )
+{
+	return Mat<R, C, T>::generate( [&]( size_t row, size_t column ) {
+		return detail::sum( [&]( size_t k ) { return a( row, k ) * b( k, column ); }, std::make_index_sequence<K>() );
+	} );
+}
+
+
+/// @brief AVX when available, one column of four doubles to a register
+template <>
+Mat<4, 4, double> operator*( const Mat<4, 4, double>& a, const Mat<4, 4, double>& b );
+
+template <size_t R, size_t C, typename T>
+constexpr Vec<R, T> operator*( const Mat<R, C, T>& m, const Vec<C, T>& v )
+{
+	return Vec<R, T>::generate( [&]( size_t row ) {
+		return detail::sum( [&]( size_t column ) { return m( row, column ) * v[column]; }, std::make_index_sequence<C>() );
+	} );
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr bool operator==( const Mat<R, C, T>& a, const Mat<R, C, T>& b )
+{
+	return detail::all( [&]( size_t i ) { return a.matrix[i] == b.matrix[i]; }, std::make_index_sequence<R * C>() );
+}
+
+
+template <size_t R, size_t C, typename T>
+constexpr bool operator!=( const Mat<R, C, T>& a, const Mat<R, C, T>& b )
+{
+	return !( a == b );
+}
+
+
+template <size_t R, size_t C, typename T>
+std::ostream& operator<<( std::ostream& os, const Mat<R, C, T>& m )
+{
+	for ( size_t row = 0; row < R; ++row )
+	{
+		os << m.get_row( row ) << "\n";
+	}
+	return os;
+}
+
+
+using Mat2f = Mat<2, 2, float>;
+using Mat3f = Mat<3, 3, float>;
+using Mat4 = Mat<4, 4, float>;
+using Mat4f = Mat4;
+
+using Mat2d = Mat<2, 2, double>;
+using Mat3d = Mat<3, 3, double>;
+using Mat4d = Mat<4, 4, double>;
+
+using Mat2i = Mat<2, 2, int32_t>;
+using Mat3i = Mat<3, 3, int32_t>;
+using Mat4i = Mat<4, 4, int32_t>;
+
+
+// [row][column]
+template <typename T>
+Quaternion<T>::Quaternion( const Mat<4, 4, T>& matrix )
+{
+	T t = matrix(0,0) + matrix(1,1) + matrix(2,2);
+	if ( t > 0 )
+	{
+		T s = T( 0.5 ) / std::sqrt( t + 1 );
+		w = T( 0.25 ) / s;
+		x = ( matrix(2,1) - matrix(1,2) ) * s;
+		y = ( matrix(0,2) - matrix(2,0) ) * s;
+		z = ( matrix(1,0) - matrix(0,1) ) * s;
+	}
+	else
+	{
+		if ( matrix(0,0) > matrix(1,1) && matrix(0,0) > matrix(2,2) )
+		{
+			T s = 2 * std::sqrt( 1 + matrix(0,0) - matrix(1,1) - matrix(2,2));
+			w = (matrix(2,1) - matrix(1,2) ) / s;
+			x = T( 0.25 ) * s;
+			y = (matrix(0,1) + matrix(1,0) ) / s;
+			z = (matrix(0,2) + matrix(2,0) ) / s;
+		}
+		else if (matrix(1,1) > matrix(2,2))
+		{
+			T s = 2 * std::sqrt( 1 + matrix(1,1) - matrix(0,0) - matrix(2,2));
+			w = (matrix(0,2) - matrix(2,0) ) / s;
+			x = (matrix(0,1) + matrix(1,0) ) / s;
+			y = T( 0.25 ) * s;
+			z = (matrix(1,2) + matrix(2,1) ) / s;
+		}
+		else
+		{
+			T s = 2 * std::sqrt( 1 + matrix(2,2) - matrix(0,0) - matrix(1,1) );
+			w = (matrix(1,0) - matrix(0,1) ) / s;
+			x = (matrix(0,2) + matrix(2,0) ) / s;
+			y = (matrix(1,2) + matrix(2,1) ) / s;
+			z = T( 0.25 ) * s;
+		}
+	}
+
+	normalize();
+}
+
+
+}  // namespace spot::math
+
+
+// The specialization of Mat4 is visible wherever the template is
+#include "spot/math/mat4.h"
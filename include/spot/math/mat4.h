@@ -1,5 +1,6 @@
 #pragma once
 
+#include "spot/math/mat.h"
 #include "spot/math/math.h"
 #include "spot/math/shape.h"
 
@@ -8,35 +9,71 @@ namespace spot::math
 {
 
 
-class Mat4
+/// @brief Float 4x4 matrix, whose products, inverses, and transforms of arrays
+/// go through SIMD kernels dispatched at run time, see simd.h
+template <>
+class Mat<4, 4, float>
 {
   public:
+	using Scalar = float;
+	static constexpr size_t Rows = 4;
+	static constexpr size_t Columns = 4;
+
 	static const Mat4 Zero;
 	static const Mat4 Identity;
 
-	Mat4() = default;
-	Mat4( std::initializer_list<float> l );
-	Mat4( const float* const m );
-	Mat4( const Quat& quat );
-
-	float&       operator()( size_t index );
-	const float& operator()( size_t index ) const;
-	float&       operator()( size_t row, size_t column );
-	const float& operator()( size_t row, size_t column ) const;
+	Mat() = default;
+	Mat( std::initializer_list<float> l );
+	Mat( const float* const m );
+	Mat( const Quat& quat );
+
+	/// @brief Converts the elements of another matrix to float
+	template <typename U>
+	constexpr explicit Mat( const Mat<4, 4, U>& other );
+
+	/// @return A matrix with f( row, column ) as the element at that row and column
+	template <typename F>
+	static constexpr Mat4 generate( F&& f );
+
+	/// @brief Builds translation * rotation * scale directly, with no matrix product
+	/// @param[in] t Translation
+	/// @param[in] r Rotation, expected to be normalized
+	/// @param[in] s Scale
+	static Mat4 from_trs( const Vec3& t, const Quat& r, const Vec3& s );
+
+	SPOT_MATH_CONSTEXPR float&       operator()( size_t index );
+	SPOT_MATH_CONSTEXPR const float& operator()( size_t index ) const;
+	SPOT_MATH_CONSTEXPR float&       operator()( size_t row, size_t column );
+	SPOT_MATH_CONSTEXPR const float& operator()( size_t row, size_t column ) const;
 	const float* operator[]( size_t index ) const;
 	float* operator[]( size_t index );
-	Mat4&        operator=( const Mat4& matrix );
 	Mat4&        operator+=( const Mat4& matrix );
+	Mat4&        operator-=( const Mat4& matrix );
+	Mat4&        operator*=( float k );
 	Mat4   operator+( const Mat4& other ) const;
 	Mat4&        operator*=( const Mat4& matrix );
 	Mat4   operator*( const Mat4& other ) const;
+	Vec4 operator*( const Vec4& v ) const;
+
+	/// @brief Transforms a point, dividing the result by w
 	Vec3 operator*( const Vec3& v ) const;
 	Vec2 operator*( const Vec2& v ) const;
+
+	/// @brief Bounds of a rectangle on the plane z = 0 transformed by the affine part of the matrix,
+	/// with Arvo's method: each row sums the smaller and the larger products with the corners.
+	/// Exact for affine matrices, as the bottom row is ignored there is no division by w
+	/// @param[in] r Rectangle whose corners may be swapped
+	/// @return A rectangle with a as its minimum corner and b as its maximum one
 	Rect operator*( const Rect& r ) const;
 
+	/// @brief Bounds of a box transformed by the affine part of the matrix, as for rectangles
+	/// @param[in] box Box whose corners may be swapped
+	/// @return A box with a as its minimum corner and b as its maximum one
+	Box operator*( const Box& box ) const;
+
 	bool operator==( const Mat4& other ) const;
 
-	Vec3 get_translation() const;
+	SPOT_MATH_CONSTEXPR Vec3 get_translation() const;
 	Mat4& translate( const Vec3& vec );
 	void translate_x( float amount );
 	void translate_y( float amount );
@@ -57,6 +94,7 @@ class Mat4
 	Mat4 scale_y( float scale ) const;
 	Mat4 scale_z( float scale ) const;
 
+	/// @brief Left-multiplies by a rotation, touching only the upper three rows
 	Mat4& rotate( const Quat& quat );
 	void rotate_x( float radians );
 	void rotate_y( float radians );
@@ -67,8 +105,87 @@ class Mat4
 	Mat4 rotate_y( float radians ) const;
 	Mat4 rotate_z( float radians ) const;
 
+	/// @brief Structured products with a translation, rotation, or scale matrix,
+	/// pre_ ones compute op * this, post_ ones compute this * op, skipping
+	/// every multiplication by the zeros and ones of the operand
+	Mat4& pre_translate( const Vec3& t );
+	Mat4& post_translate( const Vec3& t );
+	Mat4& pre_rotate( const Quat& q );
+	Mat4& post_rotate( const Quat& q );
+	Mat4& pre_scale( const Vec3& s );
+	Mat4& post_scale( const Vec3& s );
+
+	Vec4 get_column( size_t column ) const;
+	Vec4 get_row( size_t row ) const;
+	Mat4 get_transposed() const;
+
+	/// @return The matrix without a row and a column
+	Mat<3, 3, float> get_minor( size_t row, size_t column ) const;
+
+	float get_determinant() const;
+
+	/// @return The inverse, assuming the matrix is invertible
+	Mat4 get_inverse() const;
+
+	/// @return The inverse of a matrix made only of rotation and translation,
+	/// by transposing the rotation and rotating back the negated translation
+	Mat4 get_inverse_rigid() const;
+
+	/// @return The inverse of a matrix with a bottom row of 0, 0, 0, 1
+	Mat4 get_inverse_affine() const;
+
 	float matrix[16] = {};
 };
 
 
+template <typename U>
+constexpr Mat4::Mat( const Mat<4, 4, U>& other )
+{
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		matrix[i] = float( other.matrix[i] );
+	}
+}
+
+
+template <typename F>
+constexpr Mat4 Mat4::generate( F&& f )
+{
+	Mat4 ret;
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		ret.matrix[i] = float( f( i % 4, i / 4 ) );
+	}
+	return ret;
+}
+
+
+/// @brief Transforms an array of points, dividing each result by w
+/// @param[in] in Points to transform
+/// @param[out] out Transformed points, may be the same array as in
+/// @param[in] count Number of points
+void transform_points( const Mat4& m, const Vec3* in, Vec3* out, size_t count );
+
+
+/// @brief Transforms an array of points by an affine matrix,
+/// skipping the bottom row and the division by w
+void transform_points_affine( const Mat4& m, const Vec3* in, Vec3* out, size_t count );
+
+
+/// @brief Transforms an array of directions, ignoring translation
+void transform_vectors( const Mat4& m, const Vec3* in, Vec3* out, size_t count );
+
+
+/// @brief Inverts an array of matrices
+/// @param[in] in Matrices to invert, assumed to be invertible
+/// @param[out] out Inverted matrices, may be the same array as in
+/// @param[in] count Number of matrices
+void invert( const Mat4* in, Mat4* out, size_t count );
+
+
 } // namespace spot::math
+
+
+#ifdef SPOT_MATH_INLINE
+#include "spot/math/mat4.inl"
+#endif
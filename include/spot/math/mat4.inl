@@ -0,0 +1,746 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+
+#include "spot/math/mat4.h"
+#include "spot/math/simd.h"
+
+
+namespace spot::math
+{
+
+
+SPOT_MATH_API const Mat4 Mat4::Zero = {};
+
+
+SPOT_MATH_API const Mat4 Mat4::Identity = {
+	1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 1.0f
+};
+
+
+SPOT_MATH_API Mat4::Mat( std::initializer_list<float> list )
+{
+	size_t i = 0;
+	for ( float value : list )
+	{
+		matrix[i++] = value;
+		if ( i == 16 )
+		{
+			break;
+		}
+	}
+}
+
+
+SPOT_MATH_API Mat4::Mat( const float* const m )
+{
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		matrix[i] = m[i];
+	}
+}
+
+
+SPOT_MATH_API Mat4::Mat( const Quat& q )
+{
+	float s = 2.0f / ( q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w );
+
+	float xs = s * q.x;
+	float ys = s * q.y;
+	float zs = s * q.z;
+
+	float wx = q.w * xs;
+	float wy = q.w * ys;
+	float wz = q.w * zs;
+
+	float xx = q.x * xs;
+	float xy = q.x * ys;
+	float xz = q.x * zs;
+
+	float yy = q.y * ys;
+	float yz = q.y * zs;
+	float zz = q.z * zs;
+
+	matrix[0]  = 1.0f - ( yy + zz );
+	matrix[4]  = xy - wz;
+	matrix[8]  = xz + wy;
+	matrix[12] = 0.0f;
+
+	matrix[1]  = xy + wz;
+	matrix[5]  = 1.0f - ( xx + zz );
+	matrix[9]  = yz - wx;
+	matrix[13] = 0.0f;
+
+	matrix[2]  = xz - wy;
+	matrix[6]  = yz + wx;
+	matrix[10] = 1.0f - ( xx + yy );
+	matrix[14] = 0.0f;
+
+	matrix[3]  = 0.0f;
+	matrix[7]  = 0.0f;
+	matrix[11] = 0.0f;
+	matrix[15] = 1.0f;
+}
+
+
+SPOT_MATH_CONSTEXPR float& Mat4::operator()( const size_t index )
+{
+	assert( index < 16 && "Index out of bounds" );
+	return matrix[index];
+}
+
+
+SPOT_MATH_CONSTEXPR const float& Mat4::operator()( const size_t index ) const
+{
+	assert( index < 16 && "Index out of bounds" );
+	return matrix[index];
+}
+
+
+SPOT_MATH_CONSTEXPR float& Mat4::operator()( const size_t row, const size_t column )
+{
+	assert( row < 4 && column < 4 && "Row or column out of bounds" );
+	return matrix[row + 4 * column];
+}
+
+
+SPOT_MATH_CONSTEXPR const float& Mat4::operator()( const size_t row, const size_t column ) const
+{
+	assert( row < 4 && column < 4 && "Row or column out of bounds" );
+	return matrix[row + 4 * column];
+}
+
+
+SPOT_MATH_API const float* Mat4::operator[]( const size_t index ) const
+{
+	assert( index < 4 && "Index out of bounds" );
+	return matrix + ( index * 4 );
+}
+
+
+SPOT_MATH_API float* Mat4::operator[]( const size_t index )
+{
+	assert( index < 4 && "Index out of bounds" );
+	return matrix + ( index * 4 );
+}
+
+
+SPOT_MATH_API Mat4& Mat4::operator+=( const Mat4& other )
+{
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		matrix[i] += other.matrix[i];
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::operator+( const Mat4& other ) const
+{
+	Mat4 result = *this;
+	return result += other;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::operator-=( const Mat4& other )
+{
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		matrix[i] -= other.matrix[i];
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::operator*=( const float k )
+{
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		matrix[i] *= k;
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::operator*=( const Mat4& other )
+{
+	get_mat4_kernels().mul( matrix, other.matrix, matrix );
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::operator*( const Mat4& other ) const
+{
+	Mat4 result = *this;
+	return result *= other;
+}
+
+
+SPOT_MATH_API Vec4 Mat4::operator*( const Vec4& v ) const
+{
+	Vec4 ret;
+	get_mat4_kernels().mul_vec4( matrix, &v.x, &ret.x );
+	return ret;
+}
+
+
+SPOT_MATH_API Vec3 Mat4::operator*( const Vec3& v ) const
+{
+	Vec4 ret = *this * Vec4( v );
+	return { ret.x / ret.w, ret.y / ret.w, ret.z / ret.w };
+}
+
+
+SPOT_MATH_API Vec2 Mat4::operator*( const Vec2& v ) const
+{
+	Vec3 ret = *this * Vec3( v.x, v.y );
+	return { ret.x, ret.y };
+}
+
+
+SPOT_MATH_API Rect Mat4::operator*( const Rect& r ) const
+{
+	// Same operations of the batch kernels, as minps and maxps for the extremes
+	const float a[2] = { r.a.x, r.a.y };
+	const float b[2] = { r.b.x, r.b.y };
+	float lo[2];
+	float hi[2];
+	for ( size_t row = 0; row < 2; ++row )
+	{
+		lo[row] = hi[row] = matrix[12 + row];
+		for ( size_t column = 0; column < 2; ++column )
+		{
+			const float p = matrix[row + 4 * column] * a[column];
+			const float q = matrix[row + 4 * column] * b[column];
+			lo[row] += p < q ? p : q;
+			hi[row] += p > q ? p : q;
+		}
+	}
+	return Rect( Vec2( lo[0], lo[1] ), Vec2( hi[0], hi[1] ) );
+}
+
+
+SPOT_MATH_API Box Mat4::operator*( const Box& box ) const
+{
+	const float a[3] = { box.a.x, box.a.y, box.a.z };
+	const float b[3] = { box.b.x, box.b.y, box.b.z };
+	float lo[3];
+	float hi[3];
+	for ( size_t row = 0; row < 3; ++row )
+	{
+		lo[row] = hi[row] = matrix[12 + row];
+		for ( size_t column = 0; column < 3; ++column )
+		{
+			const float p = matrix[row + 4 * column] * a[column];
+			const float q = matrix[row + 4 * column] * b[column];
+			lo[row] += p < q ? p : q;
+			hi[row] += p > q ? p : q;
+		}
+	}
+	return Box( Vec3( lo[0], lo[1], lo[2] ), Vec3( hi[0], hi[1], hi[2] ) );
+}
+
+
+SPOT_MATH_API bool Mat4::operator==( const Mat4& other ) const
+{
+	constexpr auto epsilon = 1.0f;
+	for ( auto i = 0; i < 16; ++i )
+	{
+		if ( std::fabs( matrix[i] - other.matrix[i] ) > epsilon )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+SPOT_MATH_CONSTEXPR Vec3 Mat4::get_translation() const
+{
+	return { matrix[12], matrix[13], matrix[14] };
+}
+
+
+SPOT_MATH_API Mat4& Mat4::translate( const Vec3& vec )
+{
+	matrix[12] += vec.x;
+	matrix[13] += vec.y;
+	matrix[14] += vec.z;
+	return *this;
+}
+
+
+SPOT_MATH_API void Mat4::translate_x( const float amount )
+{
+	matrix[12] += amount;
+}
+
+
+SPOT_MATH_API void Mat4::translate_y( const float amount )
+{
+	matrix[13] += amount;
+}
+
+
+SPOT_MATH_API void Mat4::translate_z( const float amount )
+{
+	matrix[14] += amount;
+}
+
+SPOT_MATH_API Mat4 Mat4::translate( const Vec3& vec ) const
+{
+	Mat4 ret = *this;
+	ret.translate( vec );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::translate_x( const float amount ) const
+{
+	Mat4 ret = *this;
+	ret.translate_x( amount );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::translate_y( const float amount ) const
+{
+	Mat4 ret = *this;
+	ret.translate_y( amount );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::translate_z( const float amount ) const
+{
+	Mat4 ret = *this;
+	ret.translate_z( amount );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::scale( const Vec3& scale )
+{
+	matrix[0]  *= scale.x;
+	matrix[5]  *= scale.y;
+	matrix[10] *= scale.z;
+	return *this;
+}
+
+
+SPOT_MATH_API void Mat4::scale_x( const float scale )
+{
+	matrix[0] *= scale;
+}
+
+
+SPOT_MATH_API void Mat4::scale_y( const float scale )
+{
+	matrix[5] *= scale;
+}
+
+
+SPOT_MATH_API void Mat4::scale_z( const float scale )
+{
+	matrix[10] *= scale;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::scale( const Vec3& scale ) const
+{
+	auto ret = *this;
+	ret.scale( scale );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::scale_x( const float amount ) const
+{
+	auto ret = *this;
+	ret.scale_x( amount );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::scale_y( const float amount ) const
+{
+	auto ret = *this;
+	ret.scale_y( amount );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::scale_z( const float amount ) const
+{
+	auto ret = *this;
+	ret.scale_z( amount );
+	return ret;
+}
+
+
+namespace detail
+{
+
+
+/// @brief Fills a column-major 3x3 rotation from a unit quaternion
+SPOT_MATH_API void get_rotation( const Quat& q, float r[9] )
+{
+	float xw, yw, zw, xx, yy, yz, xy, xz, zz;
+
+	xx = q.x * q.x;
+	xy = q.x * q.y;
+	xz = q.x * q.z;
+	xw = q.x * q.w;
+
+	yy = q.y * q.y;
+	yz = q.y * q.z;
+	yw = q.y * q.w;
+
+	zz = q.z * q.z;
+	zw = q.z * q.w;
+
+	r[0] = 1.0f - 2.0f * ( yy + zz );
+	r[1] = 2.0f * ( xy + zw );
+	r[2] = 2.0f * ( xz - yw );
+
+	r[3] = 2.0f * ( xy - zw );
+	r[4] = 1.0f - 2.0f * ( xx + zz );
+	r[5] = 2.0f * ( yz + xw );
+
+	r[6] = 2.0f * ( xz + yw );
+	r[7] = 2.0f * ( yz - xw );
+	r[8] = 1.0f - 2.0f * ( xx + yy );
+}
+
+
+/// @brief Replaces rows a and b of m with c * a - s * b and s * a + c * b,
+/// which is a pre-multiplication by a rotation around the third axis
+SPOT_MATH_API void rotate_rows( float* m, const size_t a, const size_t b, const float c, const float s )
+{
+	for ( size_t col = 0; col < 16; col += 4 )
+	{
+		const float ma = m[a + col];
+		const float mb = m[b + col];
+		m[a + col] = c * ma - s * mb;
+		m[b + col] = s * ma + c * mb;
+	}
+}
+
+
+}  // namespace detail
+
+
+SPOT_MATH_API Mat4 Mat4::from_trs( const Vec3& t, const Quat& r, const Vec3& s )
+{
+	float rot[9];
+	detail::get_rotation( r, rot );
+
+	Mat4 ret;
+	const float* scale = &s.x;
+	for ( size_t c = 0; c < 3; ++c )
+	{
+		for ( size_t row = 0; row < 3; ++row )
+		{
+			ret.matrix[row + 4 * c] = rot[row + 3 * c] * scale[c];
+		}
+	}
+
+	ret.matrix[12] = t.x;
+	ret.matrix[13] = t.y;
+	ret.matrix[14] = t.z;
+	ret.matrix[15] = 1.0f;
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::pre_translate( const Vec3& t )
+{
+	const float* tt = &t.x;
+	for ( size_t col = 0; col < 16; col += 4 )
+	{
+		const float w = matrix[3 + col];
+		for ( size_t row = 0; row < 3; ++row )
+		{
+			matrix[row + col] += tt[row] * w;
+		}
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::post_translate( const Vec3& t )
+{
+	for ( size_t row = 0; row < 4; ++row )
+	{
+		matrix[row + 12] += matrix[row] * t.x + matrix[row + 4] * t.y + matrix[row + 8] * t.z;
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::pre_scale( const Vec3& s )
+{
+	const float* ss = &s.x;
+	for ( size_t col = 0; col < 16; col += 4 )
+	{
+		for ( size_t row = 0; row < 3; ++row )
+		{
+			matrix[row + col] *= ss[row];
+		}
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::post_scale( const Vec3& s )
+{
+	const float* ss = &s.x;
+	for ( size_t c = 0; c < 3; ++c )
+	{
+		for ( size_t row = 0; row < 4; ++row )
+		{
+			matrix[row + 4 * c] *= ss[c];
+		}
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::pre_rotate( const Quat& q )
+{
+	float r[9];
+	detail::get_rotation( q, r );
+
+	// The bottom row is untouched by a rotation on the left
+	for ( size_t col = 0; col < 16; col += 4 )
+	{
+		const float m0 = matrix[col];
+		const float m1 = matrix[col + 1];
+		const float m2 = matrix[col + 2];
+		for ( size_t row = 0; row < 3; ++row )
+		{
+			matrix[row + col] = r[row] * m0 + r[row + 3] * m1 + r[row + 6] * m2;
+		}
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::post_rotate( const Quat& q )
+{
+	float r[9];
+	detail::get_rotation( q, r );
+
+	// The translation column is untouched by a rotation on the right
+	for ( size_t row = 0; row < 4; ++row )
+	{
+		const float m0 = matrix[row];
+		const float m1 = matrix[row + 4];
+		const float m2 = matrix[row + 8];
+		for ( size_t c = 0; c < 3; ++c )
+		{
+			matrix[row + 4 * c] = m0 * r[3 * c] + m1 * r[3 * c + 1] + m2 * r[3 * c + 2];
+		}
+	}
+	return *this;
+}
+
+
+SPOT_MATH_API Mat4& Mat4::rotate( const Quat& q )
+{
+	return pre_rotate( q );
+}
+
+
+SPOT_MATH_API void Mat4::rotate_x( const float radians )
+{
+	detail::rotate_rows( matrix, 1, 2, std::cos( radians ), std::sin( radians ) );
+}
+
+
+SPOT_MATH_API void Mat4::rotate_y( const float radians )
+{
+	detail::rotate_rows( matrix, 2, 0, std::cos( radians ), std::sin( radians ) );
+}
+
+
+SPOT_MATH_API void Mat4::rotate_z( const float radians )
+{
+	detail::rotate_rows( matrix, 0, 1, std::cos( radians ), std::sin( radians ) );
+}
+
+
+SPOT_MATH_API Mat4 Mat4::rotate( const Quat& q ) const
+{
+	Mat4 ret = *this;
+	ret.rotate( q );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::rotate_x( const float radians ) const
+{
+	Mat4 ret = *this;
+	ret.rotate_x( radians );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::rotate_y( const float radians ) const
+{
+	Mat4 ret = *this;
+	ret.rotate_y( radians );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::rotate_z( const float radians ) const
+{
+	Mat4 ret = *this;
+	ret.rotate_z( radians );
+	return ret;
+}
+
+
+SPOT_MATH_API Vec4 Mat4::get_column( const size_t column ) const
+{
+	const float* c = matrix + 4 * column;
+	return { c[0], c[1], c[2], c[3] };
+}
+
+
+SPOT_MATH_API Vec4 Mat4::get_row( const size_t row ) const
+{
+	return { matrix[row], matrix[row + 4], matrix[row + 8], matrix[row + 12] };
+}
+
+
+SPOT_MATH_API Mat4 Mat4::get_transposed() const
+{
+	return generate( [this]( size_t row, size_t column ) { return ( *this )( column, row ); } );
+}
+
+
+SPOT_MATH_API Mat<3, 3, float> Mat4::get_minor( const size_t row, const size_t column ) const
+{
+	return Mat<3, 3, float>::generate( [&]( size_t r, size_t c ) {
+		return ( *this )( r < row ? r : r + 1, c < column ? c : c + 1 );
+	} );
+}
+
+
+SPOT_MATH_API float Mat4::get_determinant() const
+{
+	return get_mat4_kernels().determinant( matrix );
+}
+
+
+SPOT_MATH_API Mat4 Mat4::get_inverse() const
+{
+	Mat4 ret;
+	get_mat4_kernels().inverse( matrix, ret.matrix );
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::get_inverse_rigid() const
+{
+	Mat4 ret;
+
+	// Transpose rotation
+	for ( size_t c = 0; c < 3; ++c )
+	{
+		for ( size_t r = 0; r < 3; ++r )
+		{
+			ret.matrix[r + 4 * c] = matrix[c + 4 * r];
+		}
+	}
+
+	auto t = get_translation();
+	for ( size_t r = 0; r < 3; ++r )
+	{
+		ret.matrix[12 + r] = -( ret.matrix[r] * t.x + ret.matrix[r + 4] * t.y + ret.matrix[r + 8] * t.z );
+	}
+
+	ret.matrix[15] = 1.0f;
+	return ret;
+}
+
+
+SPOT_MATH_API Mat4 Mat4::get_inverse_affine() const
+{
+	// a(row, column)
+	auto a = [this]( size_t r, size_t c ) { return matrix[r + 4 * c]; };
+
+	float cofactors[9] = {
+		a(1,1) * a(2,2) - a(1,2) * a(2,1),
+		a(1,2) * a(2,0) - a(1,0) * a(2,2),
+		a(1,0) * a(2,1) - a(1,1) * a(2,0),
+		a(0,2) * a(2,1) - a(0,1) * a(2,2),
+		a(0,0) * a(2,2) - a(0,2) * a(2,0),
+		a(0,1) * a(2,0) - a(0,0) * a(2,1),
+		a(0,1) * a(1,2) - a(0,2) * a(1,1),
+		a(0,2) * a(1,0) - a(0,0) * a(1,2),
+		a(0,0) * a(1,1) - a(0,1) * a(1,0),
+	};
+
+	float inv_det = 1.0f / ( a(0,0) * cofactors[0] + a(0,1) * cofactors[1] + a(0,2) * cofactors[2] );
+
+	// The inverse of the linear part is the transpose of the cofactors over the determinant
+	Mat4 ret;
+	for ( size_t c = 0; c < 3; ++c )
+	{
+		for ( size_t r = 0; r < 3; ++r )
+		{
+			ret.matrix[r + 4 * c] = cofactors[r + 3 * c] * inv_det;
+		}
+	}
+
+	auto t = get_translation();
+	for ( size_t r = 0; r < 3; ++r )
+	{
+		ret.matrix[12 + r] = -( ret.matrix[r] * t.x + ret.matrix[r + 4] * t.y + ret.matrix[r + 8] * t.z );
+	}
+
+	ret.matrix[15] = 1.0f;
+	return ret;
+}
+
+
+static_assert( sizeof( Vec3 ) == sizeof( float ) * 3, "Batch kernels expect packed Vec3" );
+static_assert( sizeof( Mat4 ) == sizeof( float ) * 16, "Batch kernels expect packed Mat4" );
+
+
+SPOT_MATH_API void transform_points( const Mat4& m, const Vec3* const in, Vec3* const out, const size_t count )
+{
+	get_mat4_kernels().transform_points( m.matrix, reinterpret_cast<const float*>( in ), reinterpret_cast<float*>( out ), count );
+}
+
+
+SPOT_MATH_API void transform_points_affine( const Mat4& m, const Vec3* const in, Vec3* const out, const size_t count )
+{
+	get_mat4_kernels().transform_points_affine( m.matrix, reinterpret_cast<const float*>( in ), reinterpret_cast<float*>( out ), count );
+}
+
+
+SPOT_MATH_API void transform_vectors( const Mat4& m, const Vec3* const in, Vec3* const out, const size_t count )
+{
+	get_mat4_kernels().transform_vectors( m.matrix, reinterpret_cast<const float*>( in ), reinterpret_cast<float*>( out ), count );
+}
+
+
+SPOT_MATH_API void invert( const Mat4* const in, Mat4* const out, const size_t count )
+{
+	auto inverse = get_mat4_kernels().inverse;
+	for ( size_t i = 0; i < count; ++i )
+	{
+		inverse( in[i].matrix, out[i].matrix );
+	}
+}
+
+
+}  // namespace spot::math
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <cmath>
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
+#include "spot/math/config.h"
+#include "spot/math/precision.h"
+#include "spot/math/vec.h"
+
 
 namespace spot::math
 {
@@ -29,161 +35,302 @@ constexpr float degrees( const float radians )
 }
 
 
-class Size
+template <size_t R, size_t C, typename T>
+class Mat;
+
+
+/// @brief Quaternion of a floating point type, unit ones are rotations
+template <typename T>
+class Quaternion
 {
+	static_assert( std::is_floating_point_v<T>, "Components of quaternions are floating point" );
+
   public:
-	static const Size Null;
+	using Scalar = T;
 
-	Size( uint64_t w = 0, uint64_t h = 0 );
+	static const Quaternion Identity;
 
-	Size&      operator*=( const uint64_t f );
-	Size&      operator*=( const float f );
-	Size&      operator/=( const uint64_t i );
-	const Size operator/( const uint64_t i ) const;
+	constexpr Quaternion( T w = 0, T x = 0, T y = 0, T z = 0 );
 
-	bool operator==( const Size& other ) const;
+	/// @brief Constructs the rotation of a matrix, defined in mat4.h
+	Quaternion( const Mat<4, 4, T>& m );
 
-	friend std::ostream& operator<<( std::ostream& os, const Size& v );
+	/// @brief Constructs a quaternion from an axis
+	/// and an angle of rotation around that axis
+	Quaternion( const Vec<3, T>& axis, T radians );
 
-	uint64_t width;
-	uint64_t height;
-};
+	void normalize();
 
+	/// @brief Brings a quaternion close to unit length, as left by compose, back to it
+	/// scaling by ( 3 - |q|^2 ) / 2 instead of 1 / |q|, without square roots or divisions.
+	/// The error is about 3/8 of the squared drift, below 4e-7 while |q|^2 is within 1e-3 of 1
+	constexpr void renormalize();
 
-class Vec2
-{
-  public:
-	static const Vec2 Zero;
-	static const Vec2 One;
+	constexpr bool operator==( const Quaternion& other ) const;
 
-	constexpr Vec2( float xx = 0.0f, float yy = 0.0f ) : x { xx }, y { yy } {}
+	/// @brief A multiplication of two quaternions is
+	/// just the composition of the two quaternions,
+	/// which is normalized afterwards, see compose
+	Quaternion& operator*=( const Quaternion& other );
 
-	void normalize();
+	constexpr Quaternion operator-() const;
 
-	Vec2& operator=( const Vec2& other );
-	Vec2& operator+=( const Vec2& other );
-	Vec2& operator-=( const Vec2& other );
-	Vec2& operator*=( const Vec2& other );
-	Vec2& operator*=( float c );
-	Vec2& operator/=( float c );
-	Vec2 operator+( const Vec2& other ) const;
-	Vec2 operator-( const Vec2& other ) const;
-	Vec2 operator-() const;
-	Vec2 operator*( const Vec2& other ) const;
-	Vec2 operator*( float c ) const;
-	Vec2 operator/( float c ) const;
-
-	bool operator==( const Vec2& other ) const;
-	bool operator!=( const Vec2& other ) const;
-
-	friend std::ostream& operator<<( std::ostream& os, const Vec2& v );
-
-	float x = 0.0f;
-	float y = 0.0f;
+	constexpr Quaternion& operator+=( const Quaternion& other );
+	constexpr Quaternion operator+( const Quaternion& other ) const;
+	constexpr Quaternion operator-( const Quaternion& other ) const;
+
+	T w = 0;
+	T x = 0;
+	T y = 0;
+	T z = 0;
 };
 
 
-Vec2 abs( const Vec2& v );
+template <typename T>
+constexpr Quaternion<T> operator*( typename Quaternion<T>::Scalar c, const Quaternion<T>& q );
+
+template <typename T>
+constexpr T dot( const Quaternion<T>& a, const Quaternion<T>& b );
+
+/// @brief Composes two rotations as a *= b without normalizing the result, so that b is applied first.
+/// Unit quaternions drift from unit length by a few ULP per composition, when chaining many
+/// of them call renormalize every few hundred compositions, or normalize once at the end
+template <typename T>
+constexpr Quaternion<T> compose( const Quaternion<T>& a, const Quaternion<T>& b );
+
+/// @brief Rotates a vector by a unit quaternion, same as Mat4( q ) * v without building the matrix.
+/// Computes v + w t + u x t where u is the vector part of q and t = 2 u x v, with 15 multiplications
+template <typename T>
+constexpr Vec<3, T> rotate( const Quaternion<T>& q, const Vec<3, T>& v );
 
+template <typename T>
+T length( const Quaternion<T>& q );
 
-class Vec3
+template <typename T>
+Quaternion<T> slerp( Quaternion<T> a, Quaternion<T> b, typename Quaternion<T>::Scalar t );
+
+
+template <typename T>
+constexpr Quaternion<T> Quaternion<T>::Identity = { 1, 0, 0, 0 };
+
+
+template <typename T>
+constexpr Quaternion<T>::Quaternion( const T ww, const T xx, const T yy, const T zz )
+: w{ ww }
+, x{ xx }
+, y{ yy }
+, z{ zz }
 {
-  public:
-	static const Vec3 Zero;
-	static const Vec3 One;
-	static const Vec3 X;
-	static const Vec3 Y;
-	static const Vec3 Z;
+}
 
-	constexpr Vec3( float xx = 0.0f, float yy = 0.0f, float zz = 0.0f )
-	: x { xx }, y { yy }, z{ zz }
-	{}
 
-	constexpr Vec3( const Vec2& vv )
-	: Vec3( vv.x, vv.y )
-	{}
+template <typename T>
+Quaternion<T>::Quaternion( const Vec<3, T>& axis, const T radians )
+{
+	auto factor = std::sin( radians / T( 2 ) );
 
-	static Vec3 cross( const Vec3& a, const Vec3& b );
-	static float dot( const Vec3& a, const Vec3& b );
+	x = axis.x * factor;
+	y = axis.y * factor;
+	z = axis.z * factor;
+	w = std::cos( radians / T( 2 ) );
 
-	void set( float xx, float yy, float zz );
-	void normalize();
+	normalize();
+}
 
-	Vec3& operator=( const Vec2& other );
 
-	Vec3& operator+=( const Vec3& other );
-	Vec3& operator+=( const Vec2& other );
-	Vec3& operator+=( float c );
-	Vec3 operator+( const Vec3& other ) const;
-	Vec3 operator-( const Vec3& other ) const;
-	Vec3 operator-() const;
+template <typename T>
+constexpr bool Quaternion<T>::operator==( const Quaternion& q ) const
+{
+	return w == q.w && x == q.x && y == q.y && z == q.z;
+}
 
-	Vec3& operator*=( const Vec3& other );
-	Vec3 operator*( const Vec3& other ) const;
 
-	Vec3& operator*=( float k );
-	Vec3 operator*( float k ) const;
-	Vec3& operator/=( float k );
-	Vec3 operator/( float k ) const;
+template <typename T>
+Quaternion<T>& Quaternion<T>::operator*=( const Quaternion& q )
+{
+	*this = compose( *this, q );
+	normalize();
+	return *this;
+}
 
-	bool operator==( const Vec3& other ) const;
-	bool operator!=( const Vec3& other ) const;
 
-	float x = 0.0f;
-	float y = 0.0f;
-	float z = 0.0f;
-};
+template <typename T>
+constexpr Quaternion<T> compose( const Quaternion<T>& a, const Quaternion<T>& b )
+{
+	return {
+		a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+		a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+		a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+		a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w
+	};
+}
 
-Vec3 operator*( float c, const Vec3& v );
 
-Vec3 lerp( const Vec3& a, const Vec3& b, const float t );
+template <typename T>
+constexpr Vec<3, T> rotate( const Quaternion<T>& q, const Vec<3, T>& v )
+{
+	const auto u = Vec<3, T>( q.x, q.y, q.z );
+	// Doubling by an addition saves three multiplications
+	auto t = Vec<3, T>::cross( u, v );
+	t += t;
+	return v + q.w * t + Vec<3, T>::cross( u, t );
+}
 
-std::ostream& operator<<( std::ostream& os, const Vec3& v );
 
-class Mat4;
+template <typename T>
+constexpr Quaternion<T> operator*( const typename Quaternion<T>::Scalar t, const Quaternion<T>& q )
+{
+	return { t * q.w, t * q.x, t * q.y, t * q.z };
+}
 
 
-class Quat
+template <typename T>
+constexpr Quaternion<T> Quaternion<T>::operator-() const
 {
-  public:
-	static const Quat Identity;
+	return T( -1 ) * *this;
+}
 
-	Quat( float w = 0.0f, float x = 0.0f, float y = 0.0f, float z = 0.0f );
 
-	Quat( const Mat4& m );
+template <typename T>
+constexpr Quaternion<T>& Quaternion<T>::operator+=( const Quaternion& o )
+{
+	w += o.w;
+	x += o.x;
+	y += o.y;
+	z += o.z;
+	return *this;
+}
 
-	/// @brief Constructs a quaternion from an axis
-	/// and an angle of rotation around that axis
-	Quat( const Vec3& axis, float radians );
 
-	void normalize();
+template <typename T>
+constexpr Quaternion<T> Quaternion<T>::operator+( const Quaternion& o ) const
+{
+	Quaternion ret = *this;
+	return ret += o;
+}
 
-	bool operator==( const Quat& other ) const;
 
-	/// @brief A multiplication of two quaternions is
-	/// just the composition of the two quaternions
-	Quat& operator*=( const Quat& other );
+template <typename T>
+constexpr Quaternion<T> Quaternion<T>::operator-( const Quaternion& o ) const
+{
+	return { w - o.w, x - o.x, y - o.y, z - o.z };
+}
 
-	Quat operator-() const;
 
-	Quat& operator+=( const Quat& other );
-	Quat operator+( const Quat& other ) const;
-	Quat operator-( const Quat& other ) const;
+template <typename T>
+constexpr T dot( const Quaternion<T>& a, const Quaternion<T>& b )
+{
+	// Standard euclidean for product in 4D
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
 
-	float w = 0.0f;
-	float x = 0.0f;
-	float y = 0.0f;
-	float z = 0.0f;
-};
 
-Quat operator*( float c, const Quat& q );
+template <typename T>
+T length( const Quaternion<T>& q )
+{
+	const T d = dot( q, q );
+	if constexpr ( std::is_same_v<T, float> && DefaultPrecision == Precision::Fast )
+	{
+		// The reciprocal square root of zero is infinite
+		return d > 0.0f ? d * rsqrt( d ) : 0.0f;
+	}
+	else
+	{
+		return std::sqrt( d );
+	}
+}
+
 
-float dot( const Quat& a, const Quat& b );
+template <typename T>
+void Quaternion<T>::normalize()
+{
+	if constexpr ( std::is_same_v<T, float> && DefaultPrecision == Precision::Fast )
+	{
+		const float k = rsqrt( dot( *this, *this ) );
+		x *= k;
+		y *= k;
+		z *= k;
+		w *= k;
+	}
+	else
+	{
+		auto len = length( *this );
+
+		x /= len;
+		y /= len;
+		z /= len;
+		w /= len;
+	}
+}
 
-float length( const Quat& q );
 
-Quat slerp( Quat a, Quat b, float t );
+template <typename T>
+constexpr void Quaternion<T>::renormalize()
+{
+	// First order expansion of 1 / sqrt( d ) around 1
+	const T k = T( 1.5 ) - T( 0.5 ) * dot( *this, *this );
+	w *= k;
+	x *= k;
+	y *= k;
+	z *= k;
+}
+
+
+template <typename T>
+Quaternion<T> slerp( Quaternion<T> a, Quaternion<T> b, const typename Quaternion<T>::Scalar t )
+{
+	// Normalize a and b
+	a.normalize();
+	b.normalize();
+
+	// Cosin of angle between a and b
+	auto d = dot( a, b );
+
+	// Rotate along the shortest path (-90°, 90°)
+	if ( d < 0 )
+	{
+		// Reverse one quaternion
+		b = -b;
+		d = -d;
+	}
+
+	// Close vectors reduce to linear interpolation
+	if ( d > T( 0.984375 ) )
+	{
+		auto r = a + t * ( b - a );
+		r.normalize();
+		return r;
+	}
+
+	// Find angle between a and b
+	T theta_ab = std::acos( d );
+	// Find angle between a and result
+	T theta_ar = theta_ab * t;
+
+	T sin_theta_ab = std::sin( theta_ab );
+	T sin_theta_ar = std::sin( theta_ar );
+
+	T s0;
+	T s1;
+	if constexpr ( std::is_same_v<T, float> && DefaultPrecision == Precision::Fast )
+	{
+		s1 = sin_theta_ar * reciprocal( sin_theta_ab );
+		s0 = std::cos( theta_ar ) - d * s1;
+	}
+	else
+	{
+		s0 = std::cos( theta_ar ) - d * sin_theta_ar / sin_theta_ab;
+		s1 = sin_theta_ar / sin_theta_ab;
+	}
+
+	auto r = s0 * a + s1 * b;
+	r.normalize();
+	return r;
+}
+
 
+using Quat = Quaternion<float>;
+using Quatd = Quaternion<double>;
 
 
 }  // namespace spot::math
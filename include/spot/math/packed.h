@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "spot/math/shape.h"
+
+
+namespace spot::math
+{
+
+
+/// @file Compact encodings of vectors and rotations for buffers of poses and replicated state.
+/// Batch functions convert arrays four or eight values at a time with SSE2, giving the same
+/// results as the scalar ones, and the error bounds below hold for both.
+
+
+/// @return The nearest IEEE 754 half float, rounding ties to even. Values beyond 65504
+/// become infinity, NaNs stay NaNs keeping the top bits of their payload
+uint16_t to_half( float f );
+
+
+/// @return The float of a half float, which is exact, signaling NaNs become quiet
+float from_half( uint16_t h );
+
+
+/// @brief Vec3 as three half floats in 6 bytes, half of it. The relative error is
+/// within 2^-11, about 4.9e-4, for magnitudes from 6.1e-5 to 65504, below that the
+/// absolute error is within 2^-25, about 3e-8
+struct HalfVec3
+{
+	HalfVec3() = default;
+	explicit HalfVec3( const Vec3& v );
+
+	Vec3 get_vec3() const;
+
+	uint16_t x = 0;
+	uint16_t y = 0;
+	uint16_t z = 0;
+};
+
+
+/// @brief Vec3 within a box, quantized to 16 bits per axis in 6 bytes, half of it. The box
+/// is not stored, and the same one is needed to decode. Each coordinate is within half a step,
+/// ( b - a ) / 131070 along that axis, plus a float rounding of the result, while positions
+/// out of the box are clamped to its faces
+struct QuantizedVec3
+{
+	static constexpr uint16_t Max = 65535;
+
+	QuantizedVec3() = default;
+
+	/// @param[in] range Box with a as the minimum corner and b as the maximum one
+	QuantizedVec3( const Vec3& v, const Box& range );
+
+	Vec3 get_vec3( const Box& range ) const;
+
+	uint16_t x = 0;
+	uint16_t y = 0;
+	uint16_t z = 0;
+};
+
+
+/// @brief Unit quaternion in 48 bits, 6 bytes out of 16, by smallest three: the index of the
+/// largest component, and the other three, within [ -1 / sqrt( 2 ), 1 / sqrt( 2 ) ], as 15 bits
+/// each. Those are within 2.2e-5 of the original ones and the largest component, recomputed from
+/// the others, within 6.5e-5. The decoded quaternion may be the negation of the original one,
+/// which is the same rotation, and identity is exact
+struct PackedQuat48
+{
+	static constexpr uint32_t Bits = 15;
+	/// Code of zero, in the middle of 2^Bits - 1 codes
+	static constexpr uint32_t Center = ( 1 << ( Bits - 1 ) ) - 1;
+
+	PackedQuat48() = default;
+
+	/// @param[in] q Expected to be normalized
+	explicit PackedQuat48( const Quat& q );
+
+	Quat get_quat() const;
+
+	/// Three smallest components, with bits of the index of the largest one on top of the first two
+	uint16_t data[3] = { Center, Center, Center };
+};
+
+
+/// @brief Unit quaternion in 32 bits, a quarter of it, by smallest three as PackedQuat48,
+/// with 10 bits for each of the three smallest components. Those are within 7e-4 of the
+/// original ones and the largest component within 2.1e-3, rotations within 0.3 degrees
+struct PackedQuat32
+{
+	static constexpr uint32_t Bits = 10;
+	static constexpr uint32_t Center = ( 1 << ( Bits - 1 ) ) - 1;
+
+	PackedQuat32() = default;
+
+	/// @param[in] q Expected to be normalized
+	explicit PackedQuat32( const Quat& q );
+
+	Quat get_quat() const;
+
+	/// Index of the largest component in the top two bits, then the other three
+	uint32_t data = Center | Center << Bits | Center << 2 * Bits;
+};
+
+
+/// @brief Encodes an array of vectors as half floats
+void pack( const Vec3* in, HalfVec3* out, size_t count );
+
+
+/// @brief Decodes an array of half float vectors
+void unpack( const HalfVec3* in, Vec3* out, size_t count );
+
+
+/// @brief Quantizes an array of vectors within a box
+void pack( const Vec3* in, const Box& range, QuantizedVec3* out, size_t count );
+
+
+/// @brief Decodes an array of vectors quantized within a box
+void unpack( const QuantizedVec3* in, const Box& range, Vec3* out, size_t count );
+
+
+/// @brief Encodes an array of unit quaternions in 48 bits each
+void pack( const Quat* in, PackedQuat48* out, size_t count );
+
+
+/// @brief Decodes an array of quaternions packed in 48 bits
+void unpack( const PackedQuat48* in, Quat* out, size_t count );
+
+
+/// @brief Encodes an array of unit quaternions in 32 bits each
+void pack( const Quat* in, PackedQuat32* out, size_t count );
+
+
+/// @brief Decodes an array of quaternions packed in 32 bits
+void unpack( const PackedQuat32* in, Quat* out, size_t count );
+
+
+}  // namespace spot::math
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cmath>
+
+#include "spot/math/config.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define SPOT_MATH_RSQRT 1
+#include <xmmintrin.h>
+#endif
+
+
+namespace spot::math
+{
+
+
+/// @brief How normalize, length, and slerp compute square roots and divisions
+enum class Precision
+{
+	/// sqrtf and divisions, correctly rounded
+	Exact,
+	/// Hardware estimates refined by one Newton-Raphson step, multiplied instead of
+	/// divided. Results are within a few ULP of the exact ones, see rsqrt and reciprocal
+	Fast,
+};
+
+
+/// Precision of the non-template functions, Fast when SPOT_MATH_FAST is defined
+#ifdef SPOT_MATH_FAST
+constexpr Precision DefaultPrecision = Precision::Fast;
+#else
+constexpr Precision DefaultPrecision = Precision::Exact;
+#endif
+
+
+/// @return 1 / sqrt( x ), within 1.5 ULP when exact as it rounds twice. When fast, from
+/// rsqrtss refined by one Newton step, within 4 ULP for normal positive x, the error of the
+/// estimate being up to 1.5 * 2^-12 and squared by the step; 0 and infinity give NaN
+template <Precision P = DefaultPrecision>
+inline float rsqrt( const float x )
+{
+#ifdef SPOT_MATH_RSQRT
+	if constexpr ( P == Precision::Fast )
+	{
+		const float y = _mm_cvtss_f32( _mm_rsqrt_ss( _mm_set_ss( x ) ) );
+		// Adding a small correction to y rounds less than computing y * ( 1.5 - x * y * y / 2 )
+		const float h = 0.5f * x;
+		return y + y * ( 0.5f - h * y * y );
+	}
+#endif
+	return 1.0f / std::sqrt( x );
+}
+
+
+#ifdef SPOT_MATH_RSQRT
+
+/// @brief Four reciprocal square roots, with the same operations of the scalar version
+template <Precision P = DefaultPrecision>
+inline __m128 rsqrt( const __m128 x )
+{
+	if constexpr ( P == Precision::Fast )
+	{
+		const __m128 y = _mm_rsqrt_ps( x );
+		const __m128 h = _mm_mul_ps( _mm_set1_ps( 0.5f ), x );
+		return _mm_add_ps( y, _mm_mul_ps( y, _mm_sub_ps( _mm_set1_ps( 0.5f ), _mm_mul_ps( _mm_mul_ps( h, y ), y ) ) ) );
+	}
+	else
+	{
+		return _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( x ) );
+	}
+}
+
+#endif  // SPOT_MATH_RSQRT
+
+
+/// @return 1 / x, correctly rounded when exact. When fast, from rcpss refined
+/// by one Newton step, within 3 ULP for normal x; 0 and infinity give NaN
+template <Precision P = DefaultPrecision>
+inline float reciprocal( const float x )
+{
+#ifdef SPOT_MATH_RSQRT
+	if constexpr ( P == Precision::Fast )
+	{
+		const float y = _mm_cvtss_f32( _mm_rcp_ss( _mm_set_ss( x ) ) );
+		return y + y * ( 1.0f - x * y );
+	}
+#endif
+	return 1.0f / x;
+}
+
+
+}  // namespace spot::math
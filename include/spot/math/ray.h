@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "spot/math/shape.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Half-line from an origin along a direction, which is not necessarily
+/// normalized, so distances along the ray are in units of its length
+class Ray
+{
+  public:
+	/// Distance returned by intersection tests when the ray misses
+	static constexpr float Miss = std::numeric_limits<float>::infinity();
+
+	Ray() = default;
+
+	/// @brief Constructs a ray precomputing the inverse of its direction,
+	/// components of the direction which are zero get an infinite inverse
+	Ray( const Vec3& origin, const Vec3& direction );
+
+	/// @return The point at a distance along the ray
+	Vec3 get_point( float distance ) const;
+
+	/// @brief Slab test against a box, whose corners may be in any order
+	/// @param[in] max_distance Boxes entered beyond this are missed
+	/// @return The distance where the ray enters the box, 0 when the origin is inside, or Miss
+	float intersect( const Box& box, float max_distance = Miss ) const;
+
+	/// @return The distance where the ray enters the sphere, 0 when the origin is inside, or Miss
+	float intersect( const Sphere& sphere, float max_distance = Miss ) const;
+
+	Vec3 origin;
+	Vec3 direction;
+	Vec3 inv_direction;
+};
+
+
+/// @brief Group of coherent rays stored as structures of arrays, tested
+/// against one shape at a time with a lane for each ray. Results are the same
+/// as testing each Ray on its own, with SSE2 or AVX when available
+template <size_t N>
+struct RayPacket
+{
+	static_assert( N == 4 || N == 8, "Packets have 4 or 8 rays" );
+
+	RayPacket() = default;
+
+	/// @brief Gathers N rays, with no maximum distance
+	explicit RayPacket( const Ray* rays );
+
+	/// @param[out] distances N distances where the rays enter the box, as Ray::intersect
+	void intersect( const Box& box, float* distances ) const;
+	void intersect( const Sphere& sphere, float* distances ) const;
+
+	alignas( 32 ) float origin[3][N] = {};
+	alignas( 32 ) float direction[3][N] = {};
+	alignas( 32 ) float inv_direction[3][N] = {};
+	/// Shapes entered beyond this are missed, lowering it as hits are found
+	/// skips the shapes behind them
+	alignas( 32 ) float max_distance[N] = {};
+};
+
+
+using RayPacket4 = RayPacket<4>;
+using RayPacket8 = RayPacket<8>;
+
+
+}  // namespace spot::math
@@ -18,12 +18,12 @@ class Rect
 	/// @brief Default constructs a degenerate rect centered at the origin
 	constexpr Rect( const Vec2& aa = {}, const Vec2& bb = {} ) : a { aa }, b { bb } {}
 
-	Rect& operator*=( float c );
-	Rect operator*( float c ) const;
+	SPOT_MATH_CONSTEXPR Rect& operator*=( float c );
+	SPOT_MATH_CONSTEXPR Rect operator*( float c ) const;
 
-	bool operator==( const Rect& other ) const;
+	SPOT_MATH_CONSTEXPR bool operator==( const Rect& other ) const;
 
-	Vec2 get_offset() const;
+	SPOT_MATH_CONSTEXPR Vec2 get_offset() const;
 	Vec2 get_extent() const;
 
 	/// @brief Tests whether (x, y) is inside the rectangle
@@ -34,13 +34,13 @@ class Rect
 	bool intersects( const Rect& other ) const;
 
 	/// @return The X distance from another rectangle
-	float distance_x( const Rect& other ) const;
+	SPOT_MATH_CONSTEXPR float distance_x( const Rect& other ) const;
 
 	/// @return The Y distance from another rectangle
-	float distance_y( const Rect& other ) const;
+	SPOT_MATH_CONSTEXPR float distance_y( const Rect& other ) const;
 
 	/// @return The distance from another rectangle
-	Vec2 distance( const Rect& other ) const;
+	SPOT_MATH_CONSTEXPR Vec2 distance( const Rect& other ) const;
 
 	Vec2 a;
 	Vec2 b;
@@ -52,8 +52,9 @@ struct Box
 	/// @brief Default constructs degenerate box centered at the origin
 	constexpr Box( const Vec3& aa = {}, const Vec3& bb = {} ) : a { aa }, b { bb } {}
 
-	/// @brief Tests whether this box intersects another one
-	bool intersects( const Box& b ) const;
+	/// @brief Tests whether this box intersects another one along all three axes,
+	/// a is expected to be the minimum corner and b the maximum one
+	SPOT_MATH_CONSTEXPR bool intersects( const Box& b ) const;
 
 	Vec3 a;
 	Vec3 b;
@@ -71,3 +72,8 @@ struct Sphere
 
 
 }  // namespace spot::math
+
+
+#ifdef SPOT_MATH_INLINE
+#include "spot/math/shape.inl"
+#endif
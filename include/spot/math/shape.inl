@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "spot/math/shape.h"
+
+
+namespace spot::math
+{
+
+
+SPOT_MATH_API const Rect Rect::Unit = { { -0.5f, -0.5f }, { 0.5f, 0.5f } };
+
+
+SPOT_MATH_CONSTEXPR Rect& Rect::operator*=( float c )
+{
+	a *= c;
+	b *= c;
+	return *this;
+}
+
+
+SPOT_MATH_CONSTEXPR Rect Rect::operator*( float c ) const
+{
+	Rect ret = *this;
+	return ret *= c;
+}
+
+
+SPOT_MATH_CONSTEXPR bool Rect::operator==( const Rect& other ) const
+{
+	return a == other.a && b == other.b;
+}
+
+
+SPOT_MATH_CONSTEXPR Vec2 Rect::get_offset() const
+{
+	return { std::min( a.x, b.x ), std::min( a.y, b.y ) };
+}
+
+
+SPOT_MATH_API Vec2 Rect::get_extent() const
+{
+	return abs( b - a );
+}
+
+
+SPOT_MATH_API bool Rect::contains( const float xx, const float yy ) const
+{
+	auto offset = get_offset();
+	auto extent = get_extent();
+	return ( offset.x <= xx && xx <= ( offset.x + extent.x ) ) && ( offset.y <= yy && yy <= ( offset.y + extent.y ) );
+}
+
+
+SPOT_MATH_API bool Rect::contains( const Vec2& p ) const
+{
+	return contains( p.x, p.y );
+}
+
+
+SPOT_MATH_API bool Rect::intersects( const Rect& other ) const
+{
+	auto offset = get_offset();
+	auto extent = get_extent();
+	auto other_offset = other.get_offset();
+	auto other_extent = other.get_extent();
+	return offset.x < ( other_offset.x + other_extent.x ) &&
+		( offset.x + extent.x ) > other_offset.x &&
+		( offset.y + extent.y ) > other_offset.y &&
+		offset.y < ( other_offset.y + other_extent.y );
+}
+
+
+SPOT_MATH_CONSTEXPR float Rect::distance_x( const Rect& other ) const
+{
+	if ( a.x < other.a.x )
+	{
+		return ( other.a.x - a.x ) - ( b.x - a.x );
+	}
+	else
+	{
+		return ( other.a.x - a.x ) + ( other.b.x - other.a.x );
+	}
+}
+
+
+SPOT_MATH_CONSTEXPR float Rect::distance_y( const Rect& other ) const
+{
+	if ( a.y < other.a.y )
+	{
+		return ( other.a.y - a.y ) - ( b.y - a.y );
+	}
+	else
+	{
+		return ( other.a.y - a.y ) + ( other.b.y - other.a.y );
+	}
+}
+
+
+SPOT_MATH_CONSTEXPR Vec2 Rect::distance( const Rect& other ) const
+{
+	return { distance_x( other ), distance_y( other ) };
+}
+
+
+SPOT_MATH_CONSTEXPR bool Box::intersects( const Box& other ) const
+{
+	return a.x < other.b.x && b.x > other.a.x &&
+		a.y < other.b.y && b.y > other.a.y &&
+		a.z < other.b.z && b.z > other.a.z;
+}
+
+
+}  // namespace spot::math
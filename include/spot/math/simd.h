@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace spot::math
+{
+
+
+/// @brief Instruction set extensions math kernels can be compiled for
+enum class Simd
+{
+	Scalar,
+	Sse2,
+	Avx,
+	/// AVX2 together with FMA, as every x86 CPU with one has the other
+	Avx2,
+};
+
+
+/// @return The widest instruction set supported by both the running CPU and OS
+Simd get_simd_support();
+
+
+/// @brief Table of Mat4 kernels, matrices are 16 floats in column-major order
+struct Mat4Kernels
+{
+	/// @brief Computes out = a * b, out may alias a or b
+	void ( *mul )( const float* a, const float* b, float* out );
+
+	/// @brief Computes out = m * v for a 4 component vector, out may alias v
+	void ( *mul_vec4 )( const float* m, const float* v, float* out );
+
+	/// @brief Transforms count packed 3 float points, dividing by w.
+	/// out may be the same buffer as in, but must not partially overlap it
+	void ( *transform_points )( const float* m, const float* in, float* out, size_t count );
+
+	/// @brief Like transform_points, ignoring the bottom row of m
+	void ( *transform_points_affine )( const float* m, const float* in, float* out, size_t count );
+
+	/// @brief Transforms count packed 3 float vectors by the upper 3x3 of m
+	void ( *transform_vectors )( const float* m, const float* in, float* out, size_t count );
+
+	/// @return The determinant of m
+	float ( *determinant )( const float* m );
+
+	/// @brief Computes the inverse of m, out may alias m and is
+	/// not meaningful when the returned determinant is zero
+	/// @return The determinant of m
+	float ( *inverse )( const float* m, float* out );
+};
+
+
+/// @return The kernels for an instruction set, or for the widest one
+/// supported by the running CPU when that is narrower
+/// @note Scalar, SSE2 and AVX kernels give bit-identical results,
+/// AVX2 kernels use FMA which skips an intermediate rounding
+const Mat4Kernels& get_mat4_kernels( Simd simd );
+
+
+/// @return The kernels for the widest instruction set supported,
+/// selected once on first use
+const Mat4Kernels& get_mat4_kernels();
+
+
+}  // namespace spot::math
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#include "spot/math/dual-quat.h"
+#include "spot/math/vec3-soa.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Bones moving a vertex, with weights summing to one.
+/// Unused influences have zero weight and any valid bone
+struct BoneInfluences
+{
+	static constexpr size_t Count = 4;
+
+	uint16_t bones[Count] = {};
+	float weights[Count] = {};
+};
+
+
+/// @brief Dual quaternion skinning of an array of vertices, each one transformed by
+/// the blend of the transforms of its bones, as blend( ... ) * position
+/// @param[in] palette Normalized transform of each bone, from bind pose to the current one,
+/// usually the world transform of the bone times the inverse of its bind transform
+/// @param[in] influences One for each vertex
+/// @param[out] out_positions Resized to positions, may be the same array
+void skin( const DualQuat* palette, const BoneInfluences* influences, const Vec3Soa& positions, Vec3Soa& out_positions );
+
+
+/// @brief Same as the other overload, rotating normals by the blended rotations as well,
+/// which keeps them unit length as dual quaternion blends are rigid
+/// @param[in] normals As many as positions
+/// @param[out] out_normals Resized to normals, may be the same array
+void skin( const DualQuat*       palette,
+           const BoneInfluences* influences,
+           const Vec3Soa&        positions,
+           const Vec3Soa&        normals,
+           Vec3Soa&              out_positions,
+           Vec3Soa&              out_normals );
+
+
+}  // namespace spot::math
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "spot/math/flat-map.h"
+#include "spot/math/shape.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Incremental broadphase for boxes which keeps their endpoints sorted along
+/// up to three axes, so that coherent motion only needs a few swaps per frame.
+/// Pairs live in flat tables, which do not allocate once they grew to what a frame needs
+class SweepAndPrune
+{
+  public:
+	using Id   = uint32_t;
+	using Pair = std::pair<Id, Id>;
+
+	/// @param[in] axes Number of sorted axes starting from x, pairs are boxes
+	/// overlapping along all of them, so 3 gives exact box overlaps
+	explicit SweepAndPrune( uint32_t axes = 3 );
+
+	/// @return An id for the box, ids of removed boxes are reused after flush
+	Id add( const Box& box );
+
+	/// @brief Updates the bounds of a box, moving its endpoints by insertion sort
+	void move( Id id, const Box& box );
+
+	void remove( Id id );
+
+	/// @brief Reports how overlaps changed since the last flush,
+	/// pairs which began and ended in between are not reported
+	/// @param[out] added Pairs appended here began overlapping, with the smaller id first
+	/// @param[out] removed Pairs appended here stopped overlapping, with the smaller id first
+	void flush( std::vector<Pair>& added, std::vector<Pair>& removed );
+
+	/// @param[out] out Every overlapping pair is appended here, with the smaller id first
+	void get_pairs( std::vector<Pair>& out ) const;
+
+	/// @return Number of boxes
+	size_t size() const { return count; }
+
+  private:
+	/// @brief A box bound along an axis
+	struct Endpoint
+	{
+		float value;
+		/// Box id shifted left by one, the lowest bit tells whether this is a max
+		uint32_t data;
+
+		Id   get_id() const { return data >> 1; }
+		bool is_max() const { return data & 1; }
+	};
+
+	struct Object
+	{
+		/// Normalized bounds
+		Box      box;
+		uint32_t mins[3];
+		uint32_t maxs[3];
+		bool     alive = false;
+	};
+
+	/// @return Whether two boxes overlap along the sorted axes but skip, touching faces do not count
+	bool overlaps( const Object& a, const Object& b, uint32_t skip ) const;
+
+	/// @brief Moves an endpoint towards the beginning or the end of an axis
+	/// until it is sorted, updating pairs as it passes other endpoints
+	void sort_down( uint32_t axis, uint32_t index );
+	void sort_up( uint32_t axis, uint32_t index );
+
+	/// @param[in] axis Axis along which the endpoints swapped
+	/// @param[in] moving Endpoint which passed the other one
+	/// @param[in] other Endpoint which was passed
+	/// @param[in] down Whether the moving endpoint went towards the beginning
+	void on_pass( uint32_t axis, const Endpoint& moving, const Endpoint& other, bool down );
+
+	void add_pair( Id a, Id b );
+	void remove_pair( Id a, Id b );
+
+	/// @brief Remembers whether a pair existed at the last flush, before it changes
+	void record( uint64_t key, bool existed );
+
+	uint32_t axes;
+	size_t count = 0;
+
+	std::vector<Object> objects;
+	std::vector<Endpoint> endpoints[3];
+
+	std::vector<Id> free_ids;
+	/// Ids of removed boxes which become free at the next flush
+	std::vector<Id> removed_ids;
+
+	/// Keys of overlapping pairs, smaller id in the high half
+	FlatSet pairs;
+	/// Pairs changed since the last flush, with whether they existed at that time
+	FlatMap<bool> changes;
+};
+
+
+}  // namespace spot::math
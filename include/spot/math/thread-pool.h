@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace spot::math
+{
+
+
+/// @brief Runs count tasks, passing each one its index, and returns only when all
+/// of them are done, so that the caller can rely on their results
+using Executor = std::function<void( size_t count, const std::function<void( size_t )>& task )>;
+
+
+/// @brief Small pool of threads running batches of tasks, every thread owns a range
+/// of the tasks and steals half of the range of another one when it runs out
+class ThreadPool
+{
+  public:
+	/// @param[in] threads Threads running tasks, the one calling run included
+	explicit ThreadPool( size_t threads = std::thread::hardware_concurrency() );
+	~ThreadPool();
+
+	ThreadPool( const ThreadPool& ) = delete;
+	ThreadPool& operator=( const ThreadPool& ) = delete;
+
+	/// @brief Runs tasks from 0 to count - 1 on the pool and the calling thread,
+	/// must not be called again before returning
+	void run( size_t count, const std::function<void( size_t )>& task );
+
+	/// @return An executor running tasks on this pool, which must outlive it
+	Executor get_executor();
+
+	size_t size() const { return threads.size() + 1; }
+
+  private:
+	/// @brief Tasks from begin to end still to run
+	struct Range
+	{
+		std::mutex mutex;
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	/// @brief Takes the next task of a thread, stealing from others when its range is empty
+	/// @return Whether a task was found
+	bool pop( size_t index, size_t& task );
+
+	/// @brief Runs tasks until there are none left
+	void drain( size_t index );
+
+	/// @brief Loop of the worker threads, which wait for batches of tasks
+	void work( size_t index );
+
+	std::vector<std::thread> threads;
+	/// One range for each thread, the calling one first
+	std::unique_ptr<Range[]> ranges;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	const std::function<void( size_t )>* task = nullptr;
+	std::atomic<size_t> remaining = 0;
+	/// Incremented by every batch to wake the workers
+	uint64_t batch = 0;
+	/// Workers running tasks
+	size_t active = 0;
+	bool stop = false;
+};
+
+
+}  // namespace spot::math
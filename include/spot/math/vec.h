@@ -0,0 +1,444 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+#include "spot/math/config.h"
+#include "spot/math/precision.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Names of the components of a vector, x, y, z, and w
+struct Xyzw
+{
+};
+
+/// @brief Names of the components of a size, width and height
+struct WidthHeight
+{
+};
+
+
+namespace detail
+{
+
+
+/// @brief Sums f( i ) over a sequence of indices from the first one,
+/// the fold unrolls it at compile time
+template <typename F, size_t... I>
+constexpr auto sum( F&& f, std::index_sequence<I...> )
+{
+	return ( ... + f( I ) );
+}
+
+
+/// @brief Whether all of f( i ) over a sequence of indices are true
+template <typename F, size_t... I>
+constexpr bool all( F&& f, std::index_sequence<I...> )
+{
+	return ( f( I ) && ... );
+}
+
+
+/// @brief Storage of the components of a vector, an array unless they have names
+template <size_t N, typename T, typename Names>
+struct Components
+{
+	constexpr T& at( const size_t i ) { return data[i]; }
+	constexpr const T& at( const size_t i ) const { return data[i]; }
+
+	T data[N] = {};
+};
+
+
+template <typename T>
+struct Components<2, T, Xyzw>
+{
+	constexpr T& at( const size_t i ) { return i == 0 ? x : y; }
+	constexpr const T& at( const size_t i ) const { return i == 0 ? x : y; }
+
+	T x = {};
+	T y = {};
+};
+
+
+template <typename T>
+struct Components<3, T, Xyzw>
+{
+	constexpr T& at( const size_t i ) { return i == 0 ? x : i == 1 ? y : z; }
+	constexpr const T& at( const size_t i ) const { return i == 0 ? x : i == 1 ? y : z; }
+
+	T x = {};
+	T y = {};
+	T z = {};
+};
+
+
+template <typename T>
+struct Components<4, T, Xyzw>
+{
+	constexpr T& at( const size_t i ) { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+	constexpr const T& at( const size_t i ) const { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+
+	T x = {};
+	T y = {};
+	T z = {};
+	T w = {};
+};
+
+
+template <typename T>
+struct Components<2, T, WidthHeight>
+{
+	constexpr T& at( const size_t i ) { return i == 0 ? width : height; }
+	constexpr const T& at( const size_t i ) const { return i == 0 ? width : height; }
+
+	T width = {};
+	T height = {};
+};
+
+
+}  // namespace detail
+
+
+/// @brief Vector of N components of an arithmetic type, whose operators
+/// are unrolled at compile time and usable in constant expressions.
+/// Vectors of two to four components are named x, y, z, and w, sizes width and height
+template <size_t N, typename T, typename Names = Xyzw>
+class Vec : public detail::Components<N, T, Names>
+{
+	static_assert( N > 0, "Vectors have at least one component" );
+	static_assert( std::is_arithmetic_v<T>, "Components of vectors are numbers" );
+
+	using Base = detail::Components<N, T, Names>;
+
+  public:
+	using Scalar = T;
+	static constexpr size_t Count = N;
+
+	static const Vec Zero;
+	static const Vec One;
+	/// Unit vectors along the first three axes
+	static const Vec X;
+	static const Vec Y;
+	static const Vec Z;
+	/// Same as Zero, for sizes
+	static const Vec Null;
+
+	constexpr Vec() = default;
+
+	/// @brief Constructs a vector from its first components converted to T, the others are zero
+	template <typename... A, typename = std::enable_if_t<sizeof...( A ) >= 1 && sizeof...( A ) <= N && ( std::is_arithmetic_v<A> && ... )>>
+	constexpr Vec( const A... a )
+	: Base { T( a )... }
+	{
+	}
+
+	/// @brief Extends a vector by one component, pass 0 as w for a direction
+	/// @param[in] last Last component, 1 for a point of four components and 0 otherwise
+	template <size_t M = N, typename = std::enable_if_t<( M > 1 )>>
+	constexpr Vec( const Vec<M - 1, T, Names>& v, const T last = N == 4 ? T( 1 ) : T( 0 ) )
+	: Vec( generate( [&]( size_t i ) { return i < N - 1 ? v[i] : last; } ) )
+	{
+	}
+
+	/// @brief Converts the components of another vector to T
+	template <typename U, typename OtherNames>
+	constexpr explicit Vec( const Vec<N, U, OtherNames>& other )
+	: Vec( generate( [&]( size_t i ) { return other[i]; } ) )
+	{
+	}
+
+	/// @return A vector with f( i ) as the component at index i
+	template <typename F>
+	static constexpr Vec generate( F&& f ) { return generate( f, std::make_index_sequence<N>() ); }
+
+	/// @return A vector with all the components set to value
+	static constexpr Vec filled( const T value ) { return generate( [value]( size_t ) { return value; } ); }
+
+	static constexpr T dot( const Vec& a, const Vec& b );
+	static constexpr Vec cross( const Vec& a, const Vec& b );
+
+	/// @brief Sets the components, as the constructor does
+	template <typename... A>
+	constexpr void set( const A... a ) { *this = Vec( a... ); }
+
+	constexpr T& operator[]( const size_t i ) { return Base::at( i ); }
+	constexpr const T& operator[]( const size_t i ) const { return Base::at( i ); }
+
+	/// @brief Assigns the first components of a shorter vector, keeping the last one
+	template <size_t M = N, typename = std::enable_if_t<( M > 1 )>>
+	constexpr Vec& operator=( const Vec<M - 1, T, Names>& v );
+
+	constexpr Vec& operator+=( const Vec& o ) { return *this = *this + o; }
+	constexpr Vec& operator-=( const Vec& o ) { return *this = *this - o; }
+	constexpr Vec& operator*=( const Vec& o ) { return *this = *this * o; }
+	constexpr Vec& operator*=( const T k ) { return *this = *this * k; }
+	constexpr Vec& operator/=( const T k ) { return *this = *this / k; }
+
+	/// @brief Adds k to every component
+	constexpr Vec& operator+=( const T k ) { return *this = generate( [&]( size_t i ) { return ( *this )[i] + k; } ); }
+
+	/// @brief Adds a shorter vector to the first components, keeping the last one
+	template <size_t M = N, typename = std::enable_if_t<( M > 1 )>>
+	constexpr Vec& operator+=( const Vec<M - 1, T, Names>& v );
+
+	/// @brief Scales the components of an integer vector, truncating the products
+	template <typename K, typename = std::enable_if_t<std::is_integral_v<T> && std::is_floating_point_v<K>>>
+	constexpr Vec& operator*=( const K k ) { return *this = generate( [&]( size_t i ) { return ( *this )[i] * k; } ); }
+
+	/// @brief Divides by the length, with rsqrt for floats when the precision is fast
+	void normalize();
+
+  private:
+	template <typename F, size_t... I>
+	static constexpr Vec generate( F& f, std::index_sequence<I...> )
+	{
+		return Vec( T( f( I ) )... );
+	}
+};
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> Vec<N, T, Names>::Zero = {};
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> Vec<N, T, Names>::One = Vec<N, T, Names>::filled( T( 1 ) );
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> Vec<N, T, Names>::X = Vec<N, T, Names>::generate( []( size_t i ) { return i == 0 ? T( 1 ) : T( 0 ); } );
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> Vec<N, T, Names>::Y = Vec<N, T, Names>::generate( []( size_t i ) {
+	static_assert( N > 1, "Y axis of a vector of one component" );
+	return i == 1 ? T( 1 ) : T( 0 );
+} );
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> Vec<N, T, Names>::Z = Vec<N, T, Names>::generate( []( size_t i ) {
+	static_assert( N > 2, "Z axis of a vector of less than three components" );
+	return i == 2 ? T( 1 ) : T( 0 );
+} );
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> Vec<N, T, Names>::Null = {};
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> operator+( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return a[i] + b[i]; } );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> operator-( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return a[i] - b[i]; } );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> operator-( const Vec<N, T, Names>& v )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return -v[i]; } );
+}
+
+
+/// @brief Component-wise product
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> operator*( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return a[i] * b[i]; } );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> operator*( const Vec<N, T, Names>& v, const typename Vec<N, T, Names>::Scalar k )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return v[i] * k; } );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> operator*( const typename Vec<N, T, Names>::Scalar k, const Vec<N, T, Names>& v )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return k * v[i]; } );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> operator/( const Vec<N, T, Names>& v, const typename Vec<N, T, Names>::Scalar k )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return v[i] / k; } );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr bool operator==( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return detail::all( [&]( size_t i ) { return a[i] == b[i]; }, std::make_index_sequence<N>() );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr bool operator!=( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return !( a == b );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr T Vec<N, T, Names>::dot( const Vec& a, const Vec& b )
+{
+	return T( detail::sum( [&]( size_t i ) { return a[i] * b[i]; }, std::make_index_sequence<N>() ) );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> Vec<N, T, Names>::cross( const Vec& a, const Vec& b )
+{
+	static_assert( N == 3, "Cross product of vectors which do not have three components" );
+	return {
+		a[1] * b[2] - a[2] * b[1],
+		a[2] * b[0] - a[0] * b[2],
+		a[0] * b[1] - a[1] * b[0]
+	};
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr T dot( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return Vec<N, T, Names>::dot( a, b );
+}
+
+
+template <typename T, typename Names>
+constexpr Vec<3, T, Names> cross( const Vec<3, T, Names>& a, const Vec<3, T, Names>& b )
+{
+	return Vec<3, T, Names>::cross( a, b );
+}
+
+
+template <size_t N, typename T, typename Names>
+template <size_t M, typename>
+constexpr Vec<N, T, Names>& Vec<N, T, Names>::operator=( const Vec<M - 1, T, Names>& v )
+{
+	for ( size_t i = 0; i < N - 1; ++i )
+	{
+		( *this )[i] = v[i];
+	}
+	return *this;
+}
+
+
+template <size_t N, typename T, typename Names>
+template <size_t M, typename>
+constexpr Vec<N, T, Names>& Vec<N, T, Names>::operator+=( const Vec<M - 1, T, Names>& v )
+{
+	for ( size_t i = 0; i < N - 1; ++i )
+	{
+		( *this )[i] += v[i];
+	}
+	return *this;
+}
+
+
+template <size_t N, typename T, typename Names>
+T length( const Vec<N, T, Names>& v )
+{
+	static_assert( std::is_floating_point_v<T>, "Length of an integer vector" );
+	return std::sqrt( dot( v, v ) );
+}
+
+
+template <size_t N, typename T, typename Names>
+void Vec<N, T, Names>::normalize()
+{
+	static_assert( std::is_floating_point_v<T>, "Normalization of an integer vector" );
+	if constexpr ( std::is_same_v<T, float> && DefaultPrecision == Precision::Fast )
+	{
+		*this *= rsqrt( dot( *this, *this ) );
+	}
+	else
+	{
+		*this /= length( *this );
+	}
+}
+
+
+/// @return The component-wise minimum
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> min( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return b[i] < a[i] ? b[i] : a[i]; } );
+}
+
+
+/// @return The component-wise maximum
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> max( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return a[i] < b[i] ? b[i] : a[i]; } );
+}
+
+
+template <size_t N, typename T, typename Names>
+constexpr Vec<N, T, Names> lerp( const Vec<N, T, Names>& a, const Vec<N, T, Names>& b, const typename Vec<N, T, Names>::Scalar t )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return a[i] + t * ( b[i] - a[i] ); } );
+}
+
+
+/// @return The component-wise absolute value
+template <size_t N, typename T, typename Names>
+Vec<N, T, Names> abs( const Vec<N, T, Names>& v )
+{
+	return Vec<N, T, Names>::generate( [&]( size_t i ) { return std::abs( v[i] ); } );
+}
+
+
+template <size_t N, typename T, typename Names>
+std::ostream& operator<<( std::ostream& os, const Vec<N, T, Names>& v )
+{
+	os << "[";
+	for ( size_t i = 0; i < N; ++i )
+	{
+		os << ( i > 0 ? ", " : "" ) << v[i];
+	}
+	return os << "]";
+}
+
+
+using Vec2 = Vec<2, float>;
+using Vec3 = Vec<3, float>;
+/// Homogeneous vector, mostly used as an operand of Mat4
+using Vec4 = Vec<4, float>;
+
+using Vec2f = Vec2;
+using Vec3f = Vec3;
+using Vec4f = Vec4;
+
+using Vec2d = Vec<2, double>;
+using Vec3d = Vec<3, double>;
+using Vec4d = Vec<4, double>;
+
+using Vec2i = Vec<2, int32_t>;
+using Vec3i = Vec<3, int32_t>;
+using Vec4i = Vec<4, int32_t>;
+
+using Vec2u = Vec<2, uint32_t>;
+
+/// Width and height of 32 bits
+using Size = Vec<2, uint32_t, WidthHeight>;
+
+
+}  // namespace spot::math
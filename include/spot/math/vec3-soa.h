@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "spot/math/arena.h"
+#include "spot/math/math.h"
+
+
+namespace spot::math
+{
+
+
+/// @brief Array of Vec3 with x, y and z stored in separate aligned arrays,
+/// so that operations over many vectors fill every SIMD lane
+class Vec3Soa
+{
+  public:
+	/// Alignment in bytes of each array, enough for AVX loads
+	static constexpr size_t Alignment = 32;
+
+	Vec3Soa() = default;
+
+	/// @brief Constructs size vectors set to zero
+	explicit Vec3Soa( size_t size );
+
+	/// @brief Gathers the components of a vector of Vec3
+	explicit Vec3Soa( const std::vector<Vec3>& v );
+
+	Vec3Soa( const Vec3Soa& other );
+	Vec3Soa& operator=( const Vec3Soa& other );
+	Vec3Soa( Vec3Soa&& other ) noexcept;
+	Vec3Soa& operator=( Vec3Soa&& other ) noexcept;
+
+	size_t size() const { return count; }
+
+	/// @brief Changes the number of vectors, keeping the existing ones
+	/// and setting the new ones to zero
+	void resize( size_t size );
+
+	/// @brief Deinterleaves count packed Vec3 replacing the content of this array
+	void gather( const Vec3* v, size_t count );
+	void gather( const std::vector<Vec3>& v );
+
+	/// @brief Interleaves the vectors into size() packed Vec3
+	void scatter( Vec3* out ) const;
+	std::vector<Vec3> scatter() const;
+	View<Vec3> scatter( Arena& arena ) const;
+
+	Vec3 operator[]( size_t i ) const;
+	void set( size_t i, const Vec3& v );
+
+	/// @return The component-wise minimum of all the vectors, the array must not be empty
+	Vec3 get_min() const;
+
+	/// @return The component-wise maximum of all the vectors, the array must not be empty
+	Vec3 get_max() const;
+
+	/// Components of the vectors, owned by this array and aligned to Alignment
+	float* x = nullptr;
+	float* y = nullptr;
+	float* z = nullptr;
+
+  private:
+	struct Free
+	{
+		void operator()( float* data ) const;
+	};
+
+	/// @return Floats reserved for each component, a multiple of the SIMD width
+	static size_t get_stride( size_t size );
+
+	size_t count = 0;
+	std::unique_ptr<float[], Free> data;
+};
+
+
+/// @brief Element-wise operations, out may be one of the operands and is resized to match them
+/// @param[in] a Array of the same size of b
+void add( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out );
+void sub( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out );
+void mul( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out );
+void mul( const Vec3Soa& a, float k, Vec3Soa& out );
+void cross( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out );
+void lerp( const Vec3Soa& a, const Vec3Soa& b, float t, Vec3Soa& out );
+
+/// @brief Computes the dot product of every pair of vectors
+/// @param[out] out Array of a.size() floats
+void dot( const Vec3Soa& a, const Vec3Soa& b, float* out );
+
+/// @brief Normalizes every vector, zero vectors are undefined as in Vec3::normalize
+void normalize( const Vec3Soa& a, Vec3Soa& out );
+
+
+}  // namespace spot::math
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#include "spot/math/mat.h"
+
+
+namespace spot::math
+{
+
+
+/// @file Transforms of large worlds are kept in double, as Mat4d and Vec3d, since far
+/// from the origin float translations no longer have sub-millimetre precision. They are
+/// rebased against a camera origin into float Mat4 and Vec3, small near the camera where
+/// precision matters, so that everything downstream of the rebase stays in float.
+
+
+/// @brief Builds translation * rotation * scale, as Mat4::from_trs with a double translation
+/// @param[in] r Rotation, expected to be normalized
+Mat4d from_trs( const Vec3d& t, const Quat& r, const Vec3& s );
+
+
+/// @return The position relative to origin, subtracted in double and rounded once to float
+Vec3 rebase( const Vec3d& origin, const Vec3d& position );
+
+
+/// @return The transform followed by a translation by -origin, computed in double
+/// and rounded once to float, so world * p for points near the camera stays precise
+Mat4 rebase( const Vec3d& origin, const Mat4d& world );
+
+
+/// @brief Rebases an array of positions, with AVX when available
+/// @param[out] out Relative positions, as many as in
+void rebase( const Vec3d& origin, const Vec3d* in, Vec3* out, size_t count );
+
+
+/// @brief Rebases an array of transforms, with AVX when available
+/// @param[out] out Relative transforms, as many as in
+void rebase( const Vec3d& origin, const Mat4d* in, Mat4* out, size_t count );
+
+
+}  // namespace spot::math
@@ -0,0 +1,173 @@
+#include "spot/math/affine3.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+
+namespace spot::math
+{
+
+
+const Affine3 Affine3::Zero = {};
+
+
+const Affine3 Affine3::Identity = {
+	1.0f, 0.0f, 0.0f,
+	0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 1.0f,
+	0.0f, 0.0f, 0.0f
+};
+
+
+Affine3::Affine3( std::initializer_list<float> list )
+{
+	size_t i = 0;
+	for ( float value : list )
+	{
+		matrix[i++] = value;
+		if ( i == 12 )
+		{
+			break;
+		}
+	}
+}
+
+
+Affine3::Affine3( const Mat4& m )
+{
+	for ( size_t c = 0; c < 4; ++c )
+	{
+		for ( size_t r = 0; r < 3; ++r )
+		{
+			matrix[r + 3 * c] = m.matrix[r + 4 * c];
+		}
+	}
+}
+
+
+Mat4 Affine3::get_mat4() const
+{
+	Mat4 ret;
+	for ( size_t c = 0; c < 4; ++c )
+	{
+		for ( size_t r = 0; r < 3; ++r )
+		{
+			ret.matrix[r + 4 * c] = matrix[r + 3 * c];
+		}
+	}
+	ret.matrix[15] = 1.0f;
+	return ret;
+}
+
+
+float& Affine3::operator()( const size_t row, const size_t column )
+{
+	assert( row < 3 && column < 4 && "Row or column out of bounds" );
+	return matrix[row + 3 * column];
+}
+
+
+const float& Affine3::operator()( const size_t row, const size_t column ) const
+{
+	assert( row < 3 && column < 4 && "Row or column out of bounds" );
+	return matrix[row + 3 * column];
+}
+
+
+bool Affine3::operator==( const Affine3& other ) const
+{
+	return std::memcmp( matrix, other.matrix, sizeof( matrix ) ) == 0;
+}
+
+
+Affine3& Affine3::operator*=( const Affine3& other )
+{
+	return *this = *this * other;
+}
+
+
+Affine3 Affine3::operator*( const Affine3& other ) const
+{
+	const float* a = matrix;
+	const float* b = other.matrix;
+	Affine3 ret;
+
+	for ( size_t j = 0; j < 4; ++j )
+	{
+		const size_t k = j * 3;
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			ret.matrix[i+k] = a[i] * b[k] + a[i+3] * b[k+1] + a[i+6] * b[k+2];
+		}
+	}
+
+	// The implicit 1 at the bottom of the translation column
+	ret.matrix[9]  += a[9];
+	ret.matrix[10] += a[10];
+	ret.matrix[11] += a[11];
+
+	return ret;
+}
+
+
+Vec3 Affine3::operator*( const Vec3& p ) const
+{
+	return transform_vector( p ) + get_translation();
+}
+
+
+Vec3 Affine3::transform_vector( const Vec3& v ) const
+{
+	return {
+		matrix[0] * v.x + matrix[3] * v.y + matrix[6] * v.z,
+		matrix[1] * v.x + matrix[4] * v.y + matrix[7] * v.z,
+		matrix[2] * v.x + matrix[5] * v.y + matrix[8] * v.z
+	};
+}
+
+
+Vec3 Affine3::get_translation() const
+{
+	return { matrix[9], matrix[10], matrix[11] };
+}
+
+
+float Affine3::get_determinant() const
+{
+	const float* m = matrix;
+	return m[0] * ( m[4] * m[8] - m[7] * m[5] )
+		- m[3] * ( m[1] * m[8] - m[7] * m[2] )
+		+ m[6] * ( m[1] * m[5] - m[4] * m[2] );
+}
+
+
+Affine3 Affine3::get_inverse() const
+{
+	const float* m = matrix;
+	const float inv_det = 1.0f / get_determinant();
+
+	// Transposed cofactors of the linear part
+	Affine3 ret;
+	float* r = ret.matrix;
+	r[0] = ( m[4] * m[8] - m[7] * m[5] ) * inv_det;
+	r[1] = ( m[7] * m[2] - m[1] * m[8] ) * inv_det;
+	r[2] = ( m[1] * m[5] - m[4] * m[2] ) * inv_det;
+	r[3] = ( m[6] * m[5] - m[3] * m[8] ) * inv_det;
+	r[4] = ( m[0] * m[8] - m[6] * m[2] ) * inv_det;
+	r[5] = ( m[3] * m[2] - m[0] * m[5] ) * inv_det;
+	r[6] = ( m[3] * m[7] - m[6] * m[4] ) * inv_det;
+	r[7] = ( m[6] * m[1] - m[0] * m[7] ) * inv_det;
+	r[8] = ( m[0] * m[4] - m[3] * m[1] ) * inv_det;
+
+	// Undo the translation in the inverted space
+	auto t = ret.transform_vector( get_translation() );
+	r[9]  = -t.x;
+	r[10] = -t.y;
+	r[11] = -t.z;
+
+	return ret;
+}
+
+
+}  // namespace spot::math
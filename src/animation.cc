@@ -0,0 +1,293 @@
+#include "spot/math/animation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+/// Keys walked forward before falling back to a binary search
+constexpr size_t MaxWalk = 4;
+
+
+size_t find_key( const std::vector<float>& times, const float time, TrackCursor& cursor )
+{
+	assert( !times.empty() && "Track has no keys" );
+	const size_t last = times.size() - 1;
+	size_t key = std::min( cursor.key, last );
+
+	if ( time >= times[key] )
+	{
+		// Time usually moves forward by a few keys at most
+		size_t steps = 0;
+		while ( key < last && time >= times[key + 1] )
+		{
+			if ( ++steps > MaxWalk )
+			{
+				auto it = std::upper_bound( times.begin() + key + 1, times.end(), time );
+				key = it - times.begin() - 1;
+				break;
+			}
+			++key;
+		}
+	}
+	else
+	{
+		// Time went backwards, the key can only be before the cached one
+		auto it = std::upper_bound( times.begin(), times.begin() + key, time );
+		key = it == times.begin() ? 0 : it - times.begin() - 1;
+	}
+
+	cursor.key = key;
+	return key;
+}
+
+
+namespace
+{
+
+
+/// @brief Two keys and the parameter between them
+struct Segment
+{
+	size_t key;
+	size_t next;
+	float  t;
+};
+
+
+template <typename T>
+Segment find_segment( const Track<T>& track, const float time, TrackCursor& cursor )
+{
+	assert( track.times.size() == track.values.size() && "Track times and values differ" );
+	const size_t key = find_key( track.times, time, cursor );
+	if ( key + 1 == track.times.size() )
+	{
+		return { key, key, 0.0f };
+	}
+
+	const float begin = track.times[key];
+	const float end   = track.times[key + 1];
+	// Times before the first key give a negative parameter
+	const float t = std::max( 0.0f, ( time - begin ) / ( end - begin ) );
+	return { key, key + 1, t };
+}
+
+
+/// @brief Parameter correction which makes nlerp follow slerp,
+/// a polynomial fit in t and in the cosine of the angle between the keys
+/// @param[in] t Interpolation parameter
+/// @param[in] d Absolute value of the cosine, in [0, 1]
+inline float correct( const float t, const float d )
+{
+	const float a = 1.0904f + d * ( -3.2452f + d * ( 3.55645f - d * 1.43519f ) );
+	const float b = 0.848013f + d * ( -1.06021f + d * 0.215638f );
+	const float h = t - 0.5f;
+	const float k = a * h * h + b;
+	return t + t * h * ( t - 1.0f ) * k;
+}
+
+
+/// @brief Nlerp along the shortest path, with an optional slerp correction of t
+template <bool Correct>
+Quat interpolate( const Quat& a, const Quat& b, float t )
+{
+	const float d    = dot( a, b );
+	const float sign = d < 0.0f ? -1.0f : 1.0f;
+
+	if constexpr ( Correct )
+	{
+		t = correct( t, d * sign );
+	}
+
+	Quat r;
+	r.w = a.w + t * ( b.w * sign - a.w );
+	r.x = a.x + t * ( b.x * sign - a.x );
+	r.y = a.y + t * ( b.y * sign - a.y );
+	r.z = a.z + t * ( b.z * sign - a.z );
+
+	const float inv = rsqrt( dot( r, r ) );
+	r.w *= inv;
+	r.x *= inv;
+	r.y *= inv;
+	r.z *= inv;
+	return r;
+}
+
+
+#ifdef SPOT_SSE2
+
+/// @brief Interpolates four pairs of quaternions, with the same operations of interpolate
+template <bool Correct>
+void interpolate_sse2( const Quat* a, const Quat* b, const float* t, Quat* out )
+{
+	// Rows become w, x, y, z of four quaternions
+	__m128 aw = _mm_loadu_ps( &a[0].w );
+	__m128 ax = _mm_loadu_ps( &a[1].w );
+	__m128 ay = _mm_loadu_ps( &a[2].w );
+	__m128 az = _mm_loadu_ps( &a[3].w );
+	_MM_TRANSPOSE4_PS( aw, ax, ay, az );
+
+	__m128 bw = _mm_loadu_ps( &b[0].w );
+	__m128 bx = _mm_loadu_ps( &b[1].w );
+	__m128 by = _mm_loadu_ps( &b[2].w );
+	__m128 bz = _mm_loadu_ps( &b[3].w );
+	_MM_TRANSPOSE4_PS( bw, bx, by, bz );
+
+	__m128 d = _mm_add_ps(
+		_mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ), _mm_mul_ps( az, bz ) ),
+		_mm_mul_ps( aw, bw ) );
+
+	// Flipping the sign bit of b follows the shortest path
+	const __m128 sign = _mm_and_ps( d, _mm_set1_ps( -0.0f ) );
+	bw = _mm_xor_ps( bw, sign );
+	bx = _mm_xor_ps( bx, sign );
+	by = _mm_xor_ps( by, sign );
+	bz = _mm_xor_ps( bz, sign );
+
+	__m128 tt = _mm_loadu_ps( t );
+
+	if constexpr ( Correct )
+	{
+		d = _mm_xor_ps( d, sign );
+
+		const __m128 ca = _mm_add_ps( _mm_set1_ps( 1.0904f ),
+			_mm_mul_ps( d, _mm_add_ps( _mm_set1_ps( -3.2452f ),
+				_mm_mul_ps( d, _mm_sub_ps( _mm_set1_ps( 3.55645f ), _mm_mul_ps( d, _mm_set1_ps( 1.43519f ) ) ) ) ) ) );
+		const __m128 cb = _mm_add_ps( _mm_set1_ps( 0.848013f ),
+			_mm_mul_ps( d, _mm_add_ps( _mm_set1_ps( -1.06021f ), _mm_mul_ps( d, _mm_set1_ps( 0.215638f ) ) ) ) );
+		const __m128 h = _mm_sub_ps( tt, _mm_set1_ps( 0.5f ) );
+		const __m128 k = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( ca, h ), h ), cb );
+		tt = _mm_add_ps( tt, _mm_mul_ps( _mm_mul_ps( _mm_mul_ps( tt, h ), _mm_sub_ps( tt, _mm_set1_ps( 1.0f ) ) ), k ) );
+	}
+
+	__m128 rw = _mm_add_ps( aw, _mm_mul_ps( tt, _mm_sub_ps( bw, aw ) ) );
+	__m128 rx = _mm_add_ps( ax, _mm_mul_ps( tt, _mm_sub_ps( bx, ax ) ) );
+	__m128 ry = _mm_add_ps( ay, _mm_mul_ps( tt, _mm_sub_ps( by, ay ) ) );
+	__m128 rz = _mm_add_ps( az, _mm_mul_ps( tt, _mm_sub_ps( bz, az ) ) );
+
+	const __m128 len = _mm_add_ps(
+		_mm_add_ps( _mm_add_ps( _mm_mul_ps( rx, rx ), _mm_mul_ps( ry, ry ) ), _mm_mul_ps( rz, rz ) ),
+		_mm_mul_ps( rw, rw ) );
+	const __m128 inv = rsqrt( len );
+	rw = _mm_mul_ps( rw, inv );
+	rx = _mm_mul_ps( rx, inv );
+	ry = _mm_mul_ps( ry, inv );
+	rz = _mm_mul_ps( rz, inv );
+
+	_MM_TRANSPOSE4_PS( rw, rx, ry, rz );
+	_mm_storeu_ps( &out[0].w, rw );
+	_mm_storeu_ps( &out[1].w, rx );
+	_mm_storeu_ps( &out[2].w, ry );
+	_mm_storeu_ps( &out[3].w, rz );
+}
+
+#endif  // SPOT_SSE2
+
+
+template <bool Correct>
+void sample_batch( const QuatTrack* tracks, TrackCursor* cursors, const size_t count, const float time, Quat* out )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		// Key search is scalar, gathered keys are interpolated together
+		Quat  a[4];
+		Quat  b[4];
+		float t[4];
+		for ( size_t j = 0; j < 4; ++j )
+		{
+			auto& track   = tracks[i + j];
+			auto  segment = find_segment( track, time, cursors[i + j] );
+			a[j]          = track.values[segment.key];
+			b[j]          = track.values[segment.next];
+			t[j]          = segment.t;
+		}
+		interpolate_sse2<Correct>( a, b, t, out + i );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		auto& track   = tracks[i];
+		auto  segment = find_segment( track, time, cursors[i] );
+		out[i]        = interpolate<Correct>( track.values[segment.key], track.values[segment.next], segment.t );
+	}
+}
+
+
+}  // namespace
+
+
+Quat nlerp( const Quat& a, const Quat& b, const float t )
+{
+	return interpolate<false>( a, b, t );
+}
+
+
+Quat approx_slerp( const Quat& a, const Quat& b, const float t )
+{
+	return interpolate<true>( a, b, t );
+}
+
+
+Vec3 sample( const Vec3Track& track, const float time, TrackCursor& cursor )
+{
+	auto segment = find_segment( track, time, cursor );
+	return lerp( track.values[segment.key], track.values[segment.next], segment.t );
+}
+
+
+Quat sample( const QuatTrack& track, const float time, TrackCursor& cursor, const Interpolation interpolation )
+{
+	auto  segment = find_segment( track, time, cursor );
+	auto& a       = track.values[segment.key];
+	auto& b       = track.values[segment.next];
+
+	switch ( interpolation )
+	{
+	case Interpolation::Nlerp: return nlerp( a, b, segment.t );
+	case Interpolation::ApproxSlerp: return approx_slerp( a, b, segment.t );
+	default: return slerp( a, b, segment.t );
+	}
+}
+
+
+void sample( const Vec3Track* tracks, TrackCursor* cursors, const size_t count, const float time, Vec3* out )
+{
+	for ( size_t i = 0; i < count; ++i )
+	{
+		out[i] = sample( tracks[i], time, cursors[i] );
+	}
+}
+
+
+void sample( const QuatTrack* tracks,
+             TrackCursor*     cursors,
+             const size_t     count,
+             const float      time,
+             Quat*            out,
+             const Interpolation interpolation )
+{
+	switch ( interpolation )
+	{
+	case Interpolation::Nlerp: sample_batch<false>( tracks, cursors, count, time, out ); break;
+	case Interpolation::ApproxSlerp: sample_batch<true>( tracks, cursors, count, time, out ); break;
+	default:
+		for ( size_t i = 0; i < count; ++i )
+		{
+			out[i] = sample( tracks[i], time, cursors[i], interpolation );
+		}
+		break;
+	}
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,95 @@
+#include "spot/math/arena.h"
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+
+namespace spot::math
+{
+
+
+void Arena::Free::operator()( uint8_t* data ) const
+{
+	::operator delete[]( data, std::align_val_t( Alignment ) );
+}
+
+
+Arena::Arena( const size_t c )
+: capacity { c > 0 ? c : Alignment }
+{
+}
+
+
+Arena::Arena( Arena&& other ) noexcept
+{
+	*this = std::move( other );
+}
+
+
+Arena& Arena::operator=( Arena&& other ) noexcept
+{
+	capacity = other.capacity;
+	blocks   = std::move( other.blocks );
+	current  = std::exchange( other.current, 0 );
+	offset   = std::exchange( other.offset, 0 );
+	used     = std::exchange( other.used, 0 );
+	return *this;
+}
+
+
+void* Arena::allocate( const size_t size, const size_t alignment )
+{
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 && "Alignment must be a power of two" );
+
+	for ( ;; )
+	{
+		if ( current == blocks.size() )
+		{
+			// Blocks are aligned to Alignment, a larger one may need padding
+			const size_t grown  = blocks.empty() ? capacity : 2 * blocks.back().size;
+			const size_t needed = size + ( alignment > Alignment ? alignment : 0 );
+			Block block;
+			block.size = needed > grown ? needed : grown;
+			block.data.reset( static_cast<uint8_t*>( ::operator new[]( block.size, std::align_val_t( Alignment ) ) ) );
+			blocks.push_back( std::move( block ) );
+		}
+
+		auto&           block = blocks[current];
+		const uintptr_t base  = reinterpret_cast<uintptr_t>( block.data.get() );
+		const size_t    start = ( ( base + offset + alignment - 1 ) & ~uintptr_t( alignment - 1 ) ) - base;
+		if ( start + size <= block.size )
+		{
+			used += start + size - offset;
+			offset = start + size;
+			return block.data.get() + start;
+		}
+
+		// The rest of this block is left unused, the next one may have been added in a previous frame
+		++current;
+		offset = 0;
+	}
+}
+
+
+void Arena::rewind( const Marker& marker )
+{
+	assert( marker.block <= blocks.size() && marker.used <= used && "Marker of another arena" );
+	current = marker.block;
+	offset  = marker.offset;
+	used    = marker.used;
+}
+
+
+size_t Arena::get_capacity() const
+{
+	size_t ret = 0;
+	for ( auto& block : blocks )
+	{
+		ret += block.size;
+	}
+	return ret;
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,144 @@
+#include "spot/math/bounds.h"
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+static_assert( sizeof( Box ) == sizeof( float ) * 6, "Batch kernels expect packed boxes" );
+static_assert( sizeof( Rect ) == sizeof( float ) * 4, "Batch kernels expect packed rectangles" );
+
+
+namespace
+{
+
+
+#ifdef SPOT_SSE2
+
+/// @brief Columns of a matrix, loaded once for all the boxes it transforms
+struct Columns
+{
+	explicit Columns( const Mat4& m )
+	{
+		for ( size_t i = 0; i < 4; ++i )
+		{
+			c[i] = _mm_loadu_ps( m.matrix + 4 * i );
+		}
+	}
+
+	__m128 c[4];
+};
+
+
+/// @brief Same operations of Mat4::operator*( const Box& ) with a column of the matrix
+/// to a register, all the rows at once, the one of w being computed and dropped
+void transform_box( const Columns& m, const Box& in, Box& out )
+{
+	__m128 lo = m.c[3];
+	__m128 hi = m.c[3];
+
+	const float a[3] = { in.a.x, in.a.y, in.a.z };
+	const float b[3] = { in.b.x, in.b.y, in.b.z };
+	for ( size_t column = 0; column < 3; ++column )
+	{
+		const __m128 p = _mm_mul_ps( m.c[column], _mm_set1_ps( a[column] ) );
+		const __m128 q = _mm_mul_ps( m.c[column], _mm_set1_ps( b[column] ) );
+		lo = _mm_add_ps( lo, _mm_min_ps( p, q ) );
+		hi = _mm_add_ps( hi, _mm_max_ps( p, q ) );
+	}
+
+	// lo.x lo.y lo.z hi.x | hi.y hi.z, as the six floats of a box
+	const __m128 z = _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 0, 0, 2, 2 ) );
+	_mm_storeu_ps( &out.a.x, _mm_shuffle_ps( lo, z, _MM_SHUFFLE( 2, 0, 1, 0 ) ) );
+	_mm_storel_pi( reinterpret_cast<__m64*>( &out.b.y ), _mm_shuffle_ps( hi, hi, _MM_SHUFFLE( 3, 3, 2, 1 ) ) );
+}
+
+
+/// @brief Same operations of Mat4::operator*( const Rect& ), as transform_box
+void transform_rect( const Columns& m, const Rect& in, Rect& out )
+{
+	__m128 lo = m.c[3];
+	__m128 hi = m.c[3];
+
+	const float a[2] = { in.a.x, in.a.y };
+	const float b[2] = { in.b.x, in.b.y };
+	for ( size_t column = 0; column < 2; ++column )
+	{
+		const __m128 p = _mm_mul_ps( m.c[column], _mm_set1_ps( a[column] ) );
+		const __m128 q = _mm_mul_ps( m.c[column], _mm_set1_ps( b[column] ) );
+		lo = _mm_add_ps( lo, _mm_min_ps( p, q ) );
+		hi = _mm_add_ps( hi, _mm_max_ps( p, q ) );
+	}
+
+	_mm_storeu_ps( &out.a.x, _mm_movelh_ps( lo, hi ) );
+}
+
+#endif  // SPOT_SSE2
+
+
+}  // namespace
+
+
+void transform_boxes( const Mat4& m, const Box* const in, Box* const out, const size_t count )
+{
+#ifdef SPOT_SSE2
+	const Columns columns( m );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		transform_box( columns, in[i], out[i] );
+	}
+#else
+	for ( size_t i = 0; i < count; ++i )
+	{
+		out[i] = m * in[i];
+	}
+#endif
+}
+
+
+void transform_boxes( const Mat4* const m, const Box* const in, Box* const out, const size_t count )
+{
+	for ( size_t i = 0; i < count; ++i )
+	{
+#ifdef SPOT_SSE2
+		transform_box( Columns( m[i] ), in[i], out[i] );
+#else
+		out[i] = m[i] * in[i];
+#endif
+	}
+}
+
+
+void transform_rects( const Mat4& m, const Rect* const in, Rect* const out, const size_t count )
+{
+#ifdef SPOT_SSE2
+	const Columns columns( m );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		transform_rect( columns, in[i], out[i] );
+	}
+#else
+	for ( size_t i = 0; i < count; ++i )
+	{
+		out[i] = m * in[i];
+	}
+#endif
+}
+
+
+void transform_rects( const Mat4* const m, const Rect* const in, Rect* const out, const size_t count )
+{
+	for ( size_t i = 0; i < count; ++i )
+	{
+#ifdef SPOT_SSE2
+		transform_rect( Columns( m[i] ), in[i], out[i] );
+#else
+		out[i] = m[i] * in[i];
+#endif
+	}
+}
+
+
+}  // namespace spot::math
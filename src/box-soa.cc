@@ -0,0 +1,157 @@
+#include "spot/math/box-soa.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+BoxSoa::BoxSoa( const std::vector<Box>& boxes )
+{
+	gather( boxes.data(), boxes.size() );
+}
+
+
+void BoxSoa::gather( const Box* boxes, const size_t count )
+{
+	min.resize( count );
+	max.resize( count );
+	for ( size_t i = 0; i < count; ++i )
+	{
+		auto& box = boxes[i];
+		min.set( i, { std::min( box.a.x, box.b.x ), std::min( box.a.y, box.b.y ), std::min( box.a.z, box.b.z ) } );
+		max.set( i, { std::max( box.a.x, box.b.x ), std::max( box.a.y, box.b.y ), std::max( box.a.z, box.b.z ) } );
+	}
+}
+
+
+namespace
+{
+
+
+/// @brief Query box with normalized corners
+struct Query
+{
+	Query( const Box& box )
+	: lo { std::min( box.a.x, box.b.x ), std::min( box.a.y, box.b.y ), std::min( box.a.z, box.b.z ) }
+	, hi { std::max( box.a.x, box.b.x ), std::max( box.a.y, box.b.y ), std::max( box.a.z, box.b.z ) }
+	{}
+
+	bool test( const BoxSoa& boxes, const size_t i ) const
+	{
+		return lo.x < boxes.max.x[i] && hi.x > boxes.min.x[i] &&
+		       lo.y < boxes.max.y[i] && hi.y > boxes.min.y[i] &&
+		       lo.z < boxes.max.z[i] && hi.z > boxes.min.z[i];
+	}
+
+	Vec3 lo;
+	Vec3 hi;
+};
+
+
+#ifdef SPOT_SSE2
+
+/// @brief Query box broadcast to every lane
+struct Query4
+{
+	Query4( const Query& q )
+	: lo { _mm_set1_ps( q.lo.x ), _mm_set1_ps( q.lo.y ), _mm_set1_ps( q.lo.z ) }
+	, hi { _mm_set1_ps( q.hi.x ), _mm_set1_ps( q.hi.y ), _mm_set1_ps( q.hi.z ) }
+	{}
+
+	/// @return Four bits telling which boxes starting from i intersect the query,
+	/// arrays are padded so this can read past their end up to a multiple of four
+	uint32_t test( const BoxSoa& boxes, const size_t i ) const
+	{
+		__m128 x = _mm_and_ps( _mm_cmplt_ps( lo[0], _mm_load_ps( boxes.max.x + i ) ),
+		                       _mm_cmpgt_ps( hi[0], _mm_load_ps( boxes.min.x + i ) ) );
+		__m128 y = _mm_and_ps( _mm_cmplt_ps( lo[1], _mm_load_ps( boxes.max.y + i ) ),
+		                       _mm_cmpgt_ps( hi[1], _mm_load_ps( boxes.min.y + i ) ) );
+		__m128 z = _mm_and_ps( _mm_cmplt_ps( lo[2], _mm_load_ps( boxes.max.z + i ) ),
+		                       _mm_cmpgt_ps( hi[2], _mm_load_ps( boxes.min.z + i ) ) );
+		return uint32_t( _mm_movemask_ps( _mm_and_ps( _mm_and_ps( x, y ), z ) ) );
+	}
+
+	__m128 lo[3];
+	__m128 hi[3];
+};
+
+#endif  // SPOT_SSE2
+
+
+}  // namespace
+
+
+void intersects( const Box& box, const BoxSoa& boxes, uint64_t* mask )
+{
+	assert( boxes.min.size() == boxes.max.size() && "Corners of different sizes" );
+	const size_t count = boxes.size();
+	std::fill( mask, mask + ( count + 63 ) / 64, 0 );
+
+	const Query query = box;
+
+#ifdef SPOT_SSE2
+	const Query4 query4 = query;
+	for ( size_t i = 0; i < count; i += 4 )
+	{
+		mask[i / 64] |= uint64_t( query4.test( boxes, i ) ) << ( i % 64 );
+	}
+
+	// Clear the bits of the padding
+	if ( count % 64 )
+	{
+		mask[count / 64] &= ( uint64_t( 1 ) << ( count % 64 ) ) - 1;
+	}
+#else
+	for ( size_t i = 0; i < count; ++i )
+	{
+		mask[i / 64] |= uint64_t( query.test( boxes, i ) ) << ( i % 64 );
+	}
+#endif
+}
+
+
+size_t intersects( const Box& box, const BoxSoa& boxes, uint32_t* indices )
+{
+	assert( boxes.min.size() == boxes.max.size() && "Corners of different sizes" );
+	const size_t count = boxes.size();
+	const Query  query = box;
+
+	size_t found = 0;
+	size_t i     = 0;
+
+#ifdef SPOT_SSE2
+	const Query4 query4 = query;
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		// Every index is written and kept only when its bit is set,
+		// writes stay within the output as found never exceeds i
+		const uint32_t bits = query4.test( boxes, i );
+		indices[found] = uint32_t( i );
+		found += bits & 1;
+		indices[found] = uint32_t( i + 1 );
+		found += ( bits >> 1 ) & 1;
+		indices[found] = uint32_t( i + 2 );
+		found += ( bits >> 2 ) & 1;
+		indices[found] = uint32_t( i + 3 );
+		found += ( bits >> 3 ) & 1;
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		if ( query.test( boxes, i ) )
+		{
+			indices[found++] = uint32_t( i );
+		}
+	}
+
+	return found;
+}
+
+
+}  // namespace spot::math
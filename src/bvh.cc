@@ -0,0 +1,477 @@
+#include "spot/math/bvh.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+
+/// Centroids are binned along one axis to evaluate the split cost
+constexpr uint32_t Bins = 16;
+
+
+Vec3 min( const Vec3& a, const Vec3& b )
+{
+	return { std::min( a.x, b.x ), std::min( a.y, b.y ), std::min( a.z, b.z ) };
+}
+
+
+Vec3 max( const Vec3& a, const Vec3& b )
+{
+	return { std::max( a.x, b.x ), std::max( a.y, b.y ), std::max( a.z, b.z ) };
+}
+
+
+/// @brief Accumulates the bounds of boxes and points
+struct Bounds
+{
+	Vec3 min = { Infinity, Infinity, Infinity };
+	Vec3 max = { -Infinity, -Infinity, -Infinity };
+
+	void grow( const Vec3& p )
+	{
+		min = math::min( min, p );
+		max = math::max( max, p );
+	}
+
+	void grow( const Box& box )
+	{
+		min = math::min( min, box.a );
+		max = math::max( max, box.b );
+	}
+
+	void grow( const Bounds& other )
+	{
+		min = math::min( min, other.min );
+		max = math::max( max, other.max );
+	}
+
+	/// @return Half the surface area, which is enough to compare costs
+	float get_area() const
+	{
+		if ( min.x > max.x )
+		{
+			return 0.0f;
+		}
+		const Vec3 d = max - min;
+		return d.x * d.y + d.y * d.z + d.z * d.x;
+	}
+};
+
+
+float get( const Vec3& v, const uint32_t axis )
+{
+	return ( &v.x )[axis];
+}
+
+
+/// @brief Builds nodes recursively over a range of primitives
+struct Builder
+{
+	const Box*              bounds;
+	const Vec3*             centroids;
+	std::vector<uint32_t>&  indices;
+	std::vector<Bvh::Node>& nodes;
+	uint32_t                max_leaf;
+
+	void make_leaf( const uint32_t node, const uint32_t begin, const uint32_t end )
+	{
+		nodes[node].offset = begin;
+		nodes[node].count  = end - begin;
+	}
+
+	void build( const uint32_t node, const uint32_t begin, const uint32_t end, const uint32_t depth )
+	{
+		Bounds box;
+		Bounds centroid;
+		for ( uint32_t i = begin; i < end; ++i )
+		{
+			box.grow( bounds[indices[i]] );
+			centroid.grow( centroids[indices[i]] );
+		}
+		nodes[node].min = box.min;
+		nodes[node].max = box.max;
+
+		const uint32_t count = end - begin;
+		if ( count == 1 || depth + 1 >= Bvh::MaxDepth )
+		{
+			return make_leaf( node, begin, end );
+		}
+
+		// Split along the axis where centroids spread the most
+		const Vec3 spread = centroid.max - centroid.min;
+		uint32_t   axis   = spread.x > spread.y ? 0 : 1;
+		axis              = get( spread, 2 ) > get( spread, axis ) ? 2 : axis;
+		const float lower = get( centroid.min, axis );
+		const float width = get( spread, axis );
+
+		uint32_t mid = begin + count / 2;
+
+		if ( width > 0.0f )
+		{
+			auto get_bin = [&]( const uint32_t i ) {
+				auto bin = uint32_t( ( get( centroids[i], axis ) - lower ) * ( Bins / width ) );
+				return std::min( bin, Bins - 1 );
+			};
+
+			Bounds   bin_bounds[Bins];
+			uint32_t bin_counts[Bins] = {};
+			for ( uint32_t i = begin; i < end; ++i )
+			{
+				const uint32_t bin = get_bin( indices[i] );
+				bin_bounds[bin].grow( bounds[indices[i]] );
+				++bin_counts[bin];
+			}
+
+			// Areas and counts at the right of every split plane
+			float    right_areas[Bins];
+			uint32_t right_counts[Bins];
+			Bounds   right;
+			uint32_t right_count = 0;
+			for ( uint32_t b = Bins - 1; b > 0; --b )
+			{
+				right.grow( bin_bounds[b] );
+				right_count += bin_counts[b];
+				right_areas[b]  = right.get_area();
+				right_counts[b] = right_count;
+			}
+
+			// Cost of a split is relative to the one of testing a primitive
+			float    best_cost  = Infinity;
+			uint32_t best_split = 0;
+			Bounds   left;
+			uint32_t left_count = 0;
+			for ( uint32_t b = 1; b < Bins; ++b )
+			{
+				left.grow( bin_bounds[b - 1] );
+				left_count += bin_counts[b - 1];
+				if ( left_count == 0 || right_counts[b] == 0 )
+				{
+					continue;
+				}
+
+				const float cost = left.get_area() * left_count + right_areas[b] * right_counts[b];
+				if ( cost < best_cost )
+				{
+					best_cost  = cost;
+					best_split = b;
+				}
+			}
+
+			const float area = box.get_area();
+			const float split_cost = area > 0.0f ? 1.0f + best_cost / area : float( count );
+			if ( count <= max_leaf && float( count ) <= split_cost )
+			{
+				return make_leaf( node, begin, end );
+			}
+
+			if ( best_split > 0 )
+			{
+				auto it = std::partition( indices.begin() + begin, indices.begin() + end,
+				                          [&]( const uint32_t i ) { return get_bin( i ) < best_split; } );
+				mid     = uint32_t( it - indices.begin() );
+			}
+		}
+		else if ( count <= max_leaf )
+		{
+			return make_leaf( node, begin, end );
+		}
+
+		// Left child follows its parent, the right one follows the left subtree
+		const uint32_t left_node = uint32_t( nodes.size() );
+		nodes.emplace_back();
+		build( left_node, begin, mid, depth + 1 );
+
+		const uint32_t right_node = uint32_t( nodes.size() );
+		nodes.emplace_back();
+		build( right_node, mid, end, depth + 1 );
+
+		nodes[node].offset = right_node;
+		nodes[node].count  = 0;
+	}
+};
+
+
+/// @brief Normalizes a box so that a is its minimum and b its maximum
+Box get_bounds( const Box& box )
+{
+	return { min( box.a, box.b ), max( box.a, box.b ) };
+}
+
+
+bool overlaps( const Vec3& amin, const Vec3& amax, const Vec3& bmin, const Vec3& bmax )
+{
+	return amin.x < bmax.x && amax.x > bmin.x &&
+	       amin.y < bmax.y && amax.y > bmin.y &&
+	       amin.z < bmax.z && amax.z > bmin.z;
+}
+
+
+}  // namespace
+
+
+Bvh::Bvh( const std::vector<Box>& boxes, const uint32_t max_leaf )
+{
+	build( boxes, max_leaf );
+}
+
+
+void Bvh::build( const std::vector<Box>& boxes, const uint32_t max_leaf )
+{
+	std::vector<Box> bounds( boxes.size() );
+	std::vector<Vec3> centroids( boxes.size() );
+	build( boxes, max_leaf, bounds.data(), centroids.data() );
+}
+
+
+void Bvh::build( const std::vector<Box>& boxes, Arena& scratch, const uint32_t max_leaf )
+{
+	const auto marker = scratch.get_marker();
+	auto bounds = scratch.allocate<Box>( boxes.size() );
+	auto centroids = scratch.allocate<Vec3>( boxes.size() );
+	build( boxes, max_leaf, bounds.data(), centroids.data() );
+	scratch.rewind( marker );
+}
+
+
+void Bvh::build( const std::vector<Box>& boxes, const uint32_t max_leaf, Box* const bounds, Vec3* const centroids )
+{
+	assert( max_leaf > 0 && "Leaves need at least one primitive" );
+	assert( boxes.size() < std::numeric_limits<uint32_t>::max() && "Too many boxes" );
+	nodes.clear();
+	indices.clear();
+	primitives.clear();
+	if ( boxes.empty() )
+	{
+		return;
+	}
+
+	indices.resize( boxes.size() );
+	for ( uint32_t i = 0; i < boxes.size(); ++i )
+	{
+		bounds[i]    = get_bounds( boxes[i] );
+		centroids[i] = ( bounds[i].a + bounds[i].b ) * 0.5f;
+		indices[i]   = i;
+	}
+
+	// A binary tree with a primitive in every leaf has 2n - 1 nodes
+	nodes.reserve( 2 * boxes.size() - 1 );
+	nodes.emplace_back();
+
+	Builder builder = { bounds, centroids, indices, nodes, max_leaf };
+	builder.build( 0, 0, uint32_t( boxes.size() ), 0 );
+
+	primitives.resize( boxes.size() );
+	for ( size_t i = 0; i < indices.size(); ++i )
+	{
+		primitives[i] = bounds[indices[i]];
+	}
+}
+
+
+void Bvh::refit( const std::vector<Box>& boxes )
+{
+	assert( boxes.size() == indices.size() && "Refit with a different number of boxes" );
+	for ( size_t i = 0; i < indices.size(); ++i )
+	{
+		primitives[i] = get_bounds( boxes[indices[i]] );
+	}
+
+	// Children always come after their parent
+	for ( size_t n = nodes.size(); n-- > 0; )
+	{
+		auto& node = nodes[n];
+		if ( node.is_leaf() )
+		{
+			Bounds bounds;
+			for ( uint32_t i = node.offset; i < node.offset + node.count; ++i )
+			{
+				bounds.grow( primitives[i] );
+			}
+			node.min = bounds.min;
+			node.max = bounds.max;
+		}
+		else
+		{
+			auto& left  = nodes[n + 1];
+			auto& right = nodes[node.offset];
+			node.min    = min( left.min, right.min );
+			node.max    = max( left.max, right.max );
+		}
+	}
+}
+
+
+void Bvh::query( const Box& box, std::vector<uint32_t>& out ) const
+{
+	if ( nodes.empty() )
+	{
+		return;
+	}
+
+	const Box bounds = get_bounds( box );
+
+	uint32_t stack[MaxDepth];
+	uint32_t size = 0;
+	stack[size++] = 0;
+
+	while ( size > 0 )
+	{
+		auto& node = nodes[stack[--size]];
+		// Nodes touching the box may still hold overlapping primitives
+		if ( node.min.x > bounds.b.x || node.max.x < bounds.a.x ||
+		     node.min.y > bounds.b.y || node.max.y < bounds.a.y ||
+		     node.min.z > bounds.b.z || node.max.z < bounds.a.z )
+		{
+			continue;
+		}
+
+		if ( node.is_leaf() )
+		{
+			for ( uint32_t i = node.offset; i < node.offset + node.count; ++i )
+			{
+				if ( overlaps( primitives[i].a, primitives[i].b, bounds.a, bounds.b ) )
+				{
+					out.push_back( indices[i] );
+				}
+			}
+		}
+		else
+		{
+			stack[size++] = node.offset;
+			stack[size++] = uint32_t( &node - nodes.data() ) + 1;
+		}
+	}
+}
+
+
+void Bvh::query( const Ray& ray, const float max_distance, std::vector<uint32_t>& out ) const
+{
+	if ( nodes.empty() )
+	{
+		return;
+	}
+
+	uint32_t stack[MaxDepth];
+	uint32_t size = 0;
+	stack[size++] = 0;
+
+	while ( size > 0 )
+	{
+		auto& node = nodes[stack[--size]];
+		if ( ray.intersect( Box( node.min, node.max ), max_distance ) == Ray::Miss )
+		{
+			continue;
+		}
+
+		if ( node.is_leaf() )
+		{
+			for ( uint32_t i = node.offset; i < node.offset + node.count; ++i )
+			{
+				if ( ray.intersect( primitives[i], max_distance ) != Ray::Miss )
+				{
+					out.push_back( indices[i] );
+				}
+			}
+		}
+		else
+		{
+			stack[size++] = node.offset;
+			stack[size++] = uint32_t( &node - nodes.data() ) + 1;
+		}
+	}
+}
+
+
+void Bvh::query( const Vec3& origin, const Vec3& direction, const float max_distance, std::vector<uint32_t>& out ) const
+{
+	query( Ray( origin, direction ), max_distance, out );
+}
+
+
+bool Bvh::raycast( const Ray& ray, const float max_distance, Hit& hit ) const
+{
+	if ( nodes.empty() )
+	{
+		return false;
+	}
+
+	float closest = max_distance;
+	bool  found   = false;
+
+	// Nodes are pushed with the distance where the ray enters them
+	struct Entry
+	{
+		uint32_t node;
+		float    distance;
+	};
+	Entry    stack[MaxDepth];
+	uint32_t size = 0;
+	stack[size++] = { 0, 0.0f };
+
+	while ( size > 0 )
+	{
+		const Entry entry = stack[--size];
+		if ( entry.distance > closest )
+		{
+			continue;
+		}
+
+		auto& node = nodes[entry.node];
+		if ( node.is_leaf() )
+		{
+			for ( uint32_t i = node.offset; i < node.offset + node.count; ++i )
+			{
+				const float distance = ray.intersect( primitives[i], closest );
+				if ( distance != Ray::Miss )
+				{
+					closest      = distance;
+					hit.index    = indices[i];
+					hit.distance = distance;
+					found        = true;
+				}
+			}
+			continue;
+		}
+
+		Entry first  = { entry.node + 1, 0.0f };
+		Entry second = { node.offset, 0.0f };
+		first.distance  = ray.intersect( Box( nodes[first.node].min, nodes[first.node].max ), closest );
+		second.distance = ray.intersect( Box( nodes[second.node].min, nodes[second.node].max ), closest );
+		if ( second.distance < first.distance )
+		{
+			std::swap( first, second );
+		}
+
+		// The nearest child is popped first
+		if ( second.distance != Ray::Miss )
+		{
+			stack[size++] = second;
+		}
+		if ( first.distance != Ray::Miss )
+		{
+			stack[size++] = first;
+		}
+	}
+
+	return found;
+}
+
+
+bool Bvh::raycast( const Vec3& origin, const Vec3& direction, const float max_distance, Hit& hit ) const
+{
+	return raycast( Ray( origin, direction ), max_distance, hit );
+}
+
+
+}  // namespace spot::math
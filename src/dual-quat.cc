@@ -0,0 +1,108 @@
+#include "spot/math/dual-quat.h"
+
+
+namespace spot::math
+{
+
+
+const DualQuat DualQuat::Identity = { Quat::Identity, {} };
+
+
+DualQuat::DualQuat( const Quat& r, const Quat& d )
+: real { r }
+, dual { d }
+{
+}
+
+
+DualQuat::DualQuat( const Mat4& m )
+: DualQuat( from_tr( m.get_translation(), Quat( m ) ) )
+{
+}
+
+
+DualQuat DualQuat::from_tr( const Vec3& t, const Quat& r )
+{
+	return { r, 0.5f * compose( Quat( 0.0f, t.x, t.y, t.z ), r ) };
+}
+
+
+Mat4 DualQuat::get_mat4() const
+{
+	return Mat4::from_trs( get_translation(), real, Vec3::One );
+}
+
+
+void DualQuat::normalize()
+{
+	const float k = rsqrt( dot( real, real ) );
+	real = k * real;
+	dual = k * dual;
+}
+
+
+DualQuat& DualQuat::operator*=( const DualQuat& other )
+{
+	return *this = *this * other;
+}
+
+
+DualQuat DualQuat::operator*( const DualQuat& other ) const
+{
+	return { compose( real, other.real ), compose( real, other.dual ) + compose( dual, other.real ) };
+}
+
+
+Vec3 DualQuat::operator*( const Vec3& p ) const
+{
+	return rotate( real, p ) + get_translation();
+}
+
+
+Vec3 DualQuat::transform_vector( const Vec3& v ) const
+{
+	return rotate( real, v );
+}
+
+
+Vec3 DualQuat::get_translation() const
+{
+	// Vector part of 2 * dual * conjugate( real ), its scalar part is zero when normalized
+	const auto u = Vec3( real.x, real.y, real.z );
+	const auto d = Vec3( dual.x, dual.y, dual.z );
+	auto t = real.w * d - dual.w * u + Vec3::cross( u, d );
+	return t + t;
+}
+
+
+DualQuat DualQuat::get_inverse() const
+{
+	return { Quat( real.w, -real.x, -real.y, -real.z ), Quat( dual.w, -dual.x, -dual.y, -dual.z ) };
+}
+
+
+DualQuat blend( const DualQuat* const dqs, const float* const weights, const size_t count )
+{
+	// The heaviest transform is the pivot, as unused ones with no weight may be anything
+	size_t pivot = 0;
+	for ( size_t i = 1; i < count; ++i )
+	{
+		if ( weights[i] > weights[pivot] )
+		{
+			pivot = i;
+		}
+	}
+
+	DualQuat ret;
+	for ( size_t i = 0; i < count; ++i )
+	{
+		const float w = dot( dqs[i].real, dqs[pivot].real ) < 0.0f ? -weights[i] : weights[i];
+		ret.real += w * dqs[i].real;
+		ret.dual += w * dqs[i].dual;
+	}
+	ret.normalize();
+	return ret;
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,269 @@
+#include "spot/math/frustum.h"
+
+#include <cmath>
+#include <limits>
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+/// Plane indices fit in a byte of the cache
+static_assert( Frustum::Count < 256 );
+
+
+Plane get_plane( const Mat4& m, const size_t row, const float sign )
+{
+	return Plane {
+		{ m( 3, 0 ) + sign * m( row, 0 ), m( 3, 1 ) + sign * m( row, 1 ), m( 3, 2 ) + sign * m( row, 2 ) },
+		m( 3, 3 ) + sign * m( row, 3 ),
+	};
+}
+
+
+/// @brief Center and half extent of a box, the corners may be in any order
+struct Bounds
+{
+	Bounds( const Box& box )
+	: center { ( box.a + box.b ) * 0.5f }
+	, extent { std::abs( box.b.x - box.a.x ) * 0.5f, std::abs( box.b.y - box.a.y ) * 0.5f, std::abs( box.b.z - box.a.z ) * 0.5f }
+	{}
+
+	/// @return The distance from the center to the farthest corner along the normal of a plane
+	float get_radius( const Plane& plane ) const
+	{
+		return std::abs( plane.n.x ) * extent.x + std::abs( plane.n.y ) * extent.y + std::abs( plane.n.z ) * extent.z;
+	}
+
+	Vec3 center;
+	Vec3 extent;
+};
+
+
+struct Ball
+{
+	Ball( const Sphere& sphere )
+	: center { sphere.o }
+	, radius { sphere.r }
+	{}
+
+	float get_radius( const Plane& ) const { return radius; }
+
+	Vec3 center;
+	float radius;
+};
+
+
+/// @brief Bits of the planes a volume is behind of, and of those it crosses
+struct Sides
+{
+	uint32_t outside = 0;
+	uint32_t crossing = 0;
+};
+
+
+template <typename Volume>
+Sides get_sides( const Plane* planes, const Volume& volume )
+{
+	Sides sides;
+	for ( uint32_t i = 0; i < Frustum::Count; ++i )
+	{
+		const float distance = planes[i].distance( volume.center );
+		const float radius   = volume.get_radius( planes[i] );
+		sides.outside |= uint32_t( distance < -radius ) << i;
+		sides.crossing |= uint32_t( distance < radius ) << i;
+	}
+	return sides;
+}
+
+
+uint8_t get_first( uint32_t bits )
+{
+	uint8_t i = 0;
+	for ( ; ( bits & 1 ) == 0; bits >>= 1 )
+	{
+		++i;
+	}
+	return i;
+}
+
+
+Cull get_cull( const Sides& sides )
+{
+	return sides.outside ? Cull::Outside : sides.crossing ? Cull::Intersecting : Cull::Inside;
+}
+
+
+#ifdef SPOT_SSE2
+
+/// @brief The six planes as structures of arrays in two registers,
+/// padded with two planes every point is in front of
+struct Planes8
+{
+	Planes8( const Plane* planes )
+	{
+		alignas( 16 ) float v[7][8];
+		for ( uint32_t i = 0; i < 8; ++i )
+		{
+			auto plane = i < Frustum::Count ? planes[i] : Plane { {}, std::numeric_limits<float>::infinity() };
+			v[0][i] = plane.n.x;
+			v[1][i] = plane.n.y;
+			v[2][i] = plane.n.z;
+			v[3][i] = plane.d;
+			v[4][i] = std::abs( plane.n.x );
+			v[5][i] = std::abs( plane.n.y );
+			v[6][i] = std::abs( plane.n.z );
+		}
+		for ( uint32_t j = 0; j < 2; ++j )
+		{
+			nx[j] = _mm_load_ps( v[0] + 4 * j );
+			ny[j] = _mm_load_ps( v[1] + 4 * j );
+			nz[j] = _mm_load_ps( v[2] + 4 * j );
+			d[j]  = _mm_load_ps( v[3] + 4 * j );
+			ax[j] = _mm_load_ps( v[4] + 4 * j );
+			ay[j] = _mm_load_ps( v[5] + 4 * j );
+			az[j] = _mm_load_ps( v[6] + 4 * j );
+		}
+	}
+
+	__m128 get_radius( const uint32_t j, const Bounds& bounds ) const
+	{
+		__m128 r = _mm_add_ps( _mm_mul_ps( ax[j], _mm_set1_ps( bounds.extent.x ) ),
+		                       _mm_mul_ps( ay[j], _mm_set1_ps( bounds.extent.y ) ) );
+		return _mm_add_ps( r, _mm_mul_ps( az[j], _mm_set1_ps( bounds.extent.z ) ) );
+	}
+
+	__m128 get_radius( const uint32_t, const Ball& ball ) const
+	{
+		return _mm_set1_ps( ball.radius );
+	}
+
+	/// @brief Same operations, in the same order, of the scalar version
+	template <typename Volume>
+	Sides get_sides( const Volume& volume ) const
+	{
+		const __m128 cx = _mm_set1_ps( volume.center.x );
+		const __m128 cy = _mm_set1_ps( volume.center.y );
+		const __m128 cz = _mm_set1_ps( volume.center.z );
+
+		Sides sides;
+		for ( uint32_t j = 0; j < 2; ++j )
+		{
+			__m128 distance = _mm_add_ps( _mm_mul_ps( nx[j], cx ), _mm_mul_ps( ny[j], cy ) );
+			distance = _mm_add_ps( _mm_add_ps( distance, _mm_mul_ps( nz[j], cz ) ), d[j] );
+
+			const __m128 radius   = get_radius( j, volume );
+			const __m128 negative = _mm_xor_ps( radius, _mm_set1_ps( -0.0f ) );
+			sides.outside |= uint32_t( _mm_movemask_ps( _mm_cmplt_ps( distance, negative ) ) ) << ( 4 * j );
+			sides.crossing |= uint32_t( _mm_movemask_ps( _mm_cmplt_ps( distance, radius ) ) ) << ( 4 * j );
+		}
+		return sides;
+	}
+
+	__m128 nx[2];
+	__m128 ny[2];
+	__m128 nz[2];
+	__m128 d[2];
+	/// Absolute values of the normals, to project the extent of boxes
+	__m128 ax[2];
+	__m128 ay[2];
+	__m128 az[2];
+};
+
+#endif  // SPOT_SSE2
+
+
+template <typename Volume, typename Shape>
+void classify( const Plane* planes, const Shape* shapes, const size_t count, Cull* out, uint8_t* cache )
+{
+#ifdef SPOT_SSE2
+	const Planes8 planes8 = planes;
+#endif
+
+	for ( size_t i = 0; i < count; ++i )
+	{
+		const Volume volume = shapes[i];
+
+		// Most shapes rejected last frame are still behind the same plane
+		if ( cache && cache[i] < Frustum::Count )
+		{
+			const Plane& plane = planes[cache[i]];
+			if ( plane.distance( volume.center ) < -volume.get_radius( plane ) )
+			{
+				out[i] = Cull::Outside;
+				continue;
+			}
+		}
+
+#ifdef SPOT_SSE2
+		const Sides sides = planes8.get_sides( volume );
+#else
+		const Sides sides = get_sides( planes, volume );
+#endif
+
+		if ( cache && sides.outside )
+		{
+			cache[i] = get_first( sides.outside );
+		}
+		out[i] = get_cull( sides );
+	}
+}
+
+
+}  // namespace
+
+
+Frustum::Frustum( const Mat4& m, const ClipDepth depth )
+{
+	planes[Left]   = get_plane( m, 0, 1.0f );
+	planes[Right]  = get_plane( m, 0, -1.0f );
+	planes[Bottom] = get_plane( m, 1, 1.0f );
+	planes[Top]    = get_plane( m, 1, -1.0f );
+	planes[Near]   = depth == ClipDepth::ZeroToOne
+		? Plane { { m( 2, 0 ), m( 2, 1 ), m( 2, 2 ) }, m( 2, 3 ) }
+		: get_plane( m, 2, 1.0f );
+	planes[Far]    = get_plane( m, 2, -1.0f );
+
+	for ( auto& plane : planes )
+	{
+		const float length = std::sqrt( Vec3::dot( plane.n, plane.n ) );
+		if ( length > 0.0f )
+		{
+			plane.n /= length;
+			plane.d /= length;
+		}
+	}
+}
+
+
+Cull Frustum::classify( const Box& box ) const
+{
+	return get_cull( get_sides( planes, Bounds( box ) ) );
+}
+
+
+Cull Frustum::classify( const Sphere& sphere ) const
+{
+	return get_cull( get_sides( planes, Ball( sphere ) ) );
+}
+
+
+void Frustum::classify( const Box* boxes, const size_t count, Cull* out, uint8_t* cache ) const
+{
+	math::classify<Bounds>( planes, boxes, count, out, cache );
+}
+
+
+void Frustum::classify( const Sphere* spheres, const size_t count, Cull* out, uint8_t* cache ) const
+{
+	math::classify<Ball>( planes, spheres, count, out, cache );
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,317 @@
+#include "spot/math/grid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+/// @brief Strict test as Rect::intersects, touching edges do not overlap
+bool overlaps( const Vec2& amin, const Vec2& amax, const Vec2& bmin, const Vec2& bmax )
+{
+	return amin.x < bmax.x && amax.x > bmin.x && amin.y < bmax.y && amax.y > bmin.y;
+}
+
+
+/// @return The maximum corner of a rect, as get_offset is the minimum one
+Vec2 get_max( const Rect& rect )
+{
+	return { std::max( rect.a.x, rect.b.x ), std::max( rect.a.y, rect.b.y ) };
+}
+
+
+/// @return The cell of a coordinate, clamped so that it fits in int32 with
+/// room for one more cell, and the lowest one for NaN
+int32_t get_cell( const float coordinate )
+{
+	const float cell = std::floor( coordinate );
+	if ( !( cell > float( -RectGrid::MaxCell ) ) )
+	{
+		return -RectGrid::MaxCell;
+	}
+	if ( cell >= float( RectGrid::MaxCell ) )
+	{
+		return RectGrid::MaxCell;
+	}
+	return int32_t( cell );
+}
+
+
+}  // namespace
+
+
+bool RectGrid::Cells::is_large() const
+{
+	return ( int64_t( x1 ) - x0 + 1 ) * ( int64_t( y1 ) - y0 + 1 ) > MaxCells;
+}
+
+
+bool RectGrid::Cells::operator==( const Cells& other ) const
+{
+	return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+}
+
+
+RectGrid::RectGrid( const float cell_size )
+: inv_cell_size { 1.0f / cell_size }
+{
+	assert( cell_size > 0.0f && "Cell size must be positive" );
+}
+
+
+RectGrid::Cells RectGrid::get_cells( const Vec2& min, const Vec2& max ) const
+{
+	return {
+		get_cell( min.x * inv_cell_size ),
+		get_cell( min.y * inv_cell_size ),
+		get_cell( max.x * inv_cell_size ),
+		get_cell( max.y * inv_cell_size ),
+	};
+}
+
+
+uint64_t RectGrid::get_key( const int32_t x, const int32_t y )
+{
+	return ( uint64_t( uint32_t( x ) ) << 32 ) | uint32_t( y );
+}
+
+
+void RectGrid::add_to_cells( const Id id )
+{
+	if ( entries[id].large )
+	{
+		large.push_back( id );
+		return;
+	}
+
+	auto& c = entries[id].cells;
+	for ( int32_t y = c.y0; y <= c.y1; ++y )
+	{
+		for ( int32_t x = c.x0; x <= c.x1; ++x )
+		{
+			auto [list, added] = cells.emplace( get_key( x, y ) );
+			if ( added )
+			{
+				if ( free_lists.empty() )
+				{
+					*list = uint32_t( lists.size() );
+					lists.emplace_back();
+				}
+				else
+				{
+					*list = free_lists.back();
+					free_lists.pop_back();
+				}
+			}
+			lists[*list].push_back( id );
+		}
+	}
+}
+
+
+void RectGrid::remove_from_cells( const Id id )
+{
+	if ( entries[id].large )
+	{
+		auto pos = std::find( large.begin(), large.end(), id );
+		assert( pos != large.end() && "Rect not found in the large ones" );
+		*pos = large.back();
+		large.pop_back();
+		return;
+	}
+
+	auto& c = entries[id].cells;
+	for ( int32_t y = c.y0; y <= c.y1; ++y )
+	{
+		for ( int32_t x = c.x0; x <= c.x1; ++x )
+		{
+			const uint64_t key  = get_key( x, y );
+			const uint32_t* list = cells.find( key );
+			assert( list && "Rect not found in its cell" );
+
+			// Cells are small, order does not matter
+			auto& ids = lists[*list];
+			auto  pos = std::find( ids.begin(), ids.end(), id );
+			*pos      = ids.back();
+			ids.pop_back();
+			if ( ids.empty() )
+			{
+				free_lists.push_back( *list );
+				cells.erase( key );
+			}
+		}
+	}
+}
+
+
+RectGrid::Id RectGrid::insert( const Rect& rect )
+{
+	Id id;
+	if ( free_ids.empty() )
+	{
+		id = Id( entries.size() );
+		entries.emplace_back();
+	}
+	else
+	{
+		id = free_ids.back();
+		free_ids.pop_back();
+	}
+
+	auto& entry = entries[id];
+	entry.min   = rect.get_offset();
+	entry.max   = get_max( rect );
+	entry.cells = get_cells( entry.min, entry.max );
+	entry.alive = true;
+	entry.large = entry.cells.is_large();
+	add_to_cells( id );
+
+	++count;
+	return id;
+}
+
+
+void RectGrid::move( const Id id, const Rect& rect )
+{
+	assert( id < entries.size() && entries[id].alive && "Invalid rect id" );
+	auto& entry = entries[id];
+	entry.min   = rect.get_offset();
+	entry.max   = get_max( rect );
+
+	// Small movements usually stay within the same cells, large rects are in no cell
+	auto       range    = get_cells( entry.min, entry.max );
+	const bool is_large = range.is_large();
+	if ( is_large != entry.large || ( !is_large && !( range == entry.cells ) ) )
+	{
+		remove_from_cells( id );
+		entry.large = is_large;
+		entry.cells = range;
+		add_to_cells( id );
+	}
+}
+
+
+void RectGrid::remove( const Id id )
+{
+	assert( id < entries.size() && entries[id].alive && "Invalid rect id" );
+	remove_from_cells( id );
+	entries[id].alive = false;
+	free_ids.push_back( id );
+	--count;
+}
+
+
+Rect RectGrid::get_rect( const Id id ) const
+{
+	assert( id < entries.size() && entries[id].alive && "Invalid rect id" );
+	return { entries[id].min, entries[id].max };
+}
+
+
+void RectGrid::query( const Rect& rect, std::vector<Id>& out ) const
+{
+	const Vec2 min = rect.get_offset();
+	const Vec2 max = get_max( rect );
+	const auto range = get_cells( min, max );
+
+	// Large rects are in no cell, and a large query tests every rect instead of so many cells
+	if ( range.is_large() )
+	{
+		for ( Id id = 0; id < entries.size(); ++id )
+		{
+			auto& entry = entries[id];
+			if ( entry.alive && overlaps( entry.min, entry.max, min, max ) )
+			{
+				out.push_back( id );
+			}
+		}
+		return;
+	}
+	for ( Id id : large )
+	{
+		if ( overlaps( entries[id].min, entries[id].max, min, max ) )
+		{
+			out.push_back( id );
+		}
+	}
+
+	for ( int32_t y = range.y0; y <= range.y1; ++y )
+	{
+		for ( int32_t x = range.x0; x <= range.x1; ++x )
+		{
+			const uint32_t* list = cells.find( get_key( x, y ) );
+			if ( !list )
+			{
+				continue;
+			}
+
+			for ( Id id : lists[*list] )
+			{
+				auto& entry = entries[id];
+				// A rect spanning more cells is only reported from the first one shared with the query
+				if ( x != std::max( range.x0, entry.cells.x0 ) || y != std::max( range.y0, entry.cells.y0 ) )
+				{
+					continue;
+				}
+				if ( overlaps( entry.min, entry.max, min, max ) )
+				{
+					out.push_back( id );
+				}
+			}
+		}
+	}
+}
+
+
+void RectGrid::get_pairs( std::vector<std::pair<Id, Id>>& out ) const
+{
+	cells.for_each( [&]( const uint64_t key, const uint32_t list ) {
+		const auto x   = int32_t( uint32_t( key >> 32 ) );
+		const auto y   = int32_t( uint32_t( key ) );
+		auto&      ids = lists[list];
+
+		for ( size_t i = 0; i < ids.size(); ++i )
+		{
+			auto& a = entries[ids[i]];
+			for ( size_t j = i + 1; j < ids.size(); ++j )
+			{
+				auto& b = entries[ids[j]];
+				// Pairs sharing several cells are only reported from the first one
+				if ( x != std::max( a.cells.x0, b.cells.x0 ) || y != std::max( a.cells.y0, b.cells.y0 ) )
+				{
+					continue;
+				}
+				if ( overlaps( a.min, a.max, b.min, b.max ) )
+				{
+					out.emplace_back( std::min( ids[i], ids[j] ), std::max( ids[i], ids[j] ) );
+				}
+			}
+		}
+	} );
+	// Large rects against every other one, pairs of them from the smaller id
+	for ( Id a : large )
+	{
+		for ( Id b = 0; b < entries.size(); ++b )
+		{
+			auto& entry = entries[b];
+			if ( !entry.alive || b == a || ( entry.large && b < a ) )
+			{
+				continue;
+			}
+			if ( overlaps( entries[a].min, entries[a].max, entry.min, entry.max ) )
+			{
+				out.emplace_back( std::min( a, b ), std::max( a, b ) );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
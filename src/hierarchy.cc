@@ -0,0 +1,155 @@
+#include "spot/math/hierarchy.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace spot::math
+{
+
+
+Hierarchy::Id Hierarchy::add( const Id parent, const Vec3& translation, const Quat& rotation, const Vec3& scale )
+{
+	assert( ( parent == None || parent < size() ) && "Parents come before their children" );
+
+	const Id id = Id( size() );
+	parents.push_back( parent );
+	translations.push_back( translation );
+	rotations.push_back( rotation );
+	scales.push_back( scale );
+	worlds.push_back( Mat4::Identity );
+	dirty.push_back( 1 );
+	versions.push_back( version - 1 );
+
+	const uint32_t depth = parent == None ? 0 : depths[parent] + 1;
+	depths.push_back( depth );
+	if ( levels.size() <= depth )
+	{
+		levels.resize( depth + 1 );
+	}
+	levels[depth].push_back( id );
+
+	first_dirty     = std::min( first_dirty, id );
+	min_dirty_depth = std::min( min_dirty_depth, depth );
+	return id;
+}
+
+
+void Hierarchy::mark_dirty( const Id id )
+{
+	assert( id < size() && "Invalid node id" );
+	dirty[id]       = 1;
+	first_dirty     = std::min( first_dirty, id );
+	min_dirty_depth = std::min( min_dirty_depth, depths[id] );
+}
+
+
+void Hierarchy::set_local( const Id id, const Vec3& translation, const Quat& rotation, const Vec3& scale )
+{
+	mark_dirty( id );
+	translations[id] = translation;
+	rotations[id]    = rotation;
+	scales[id]       = scale;
+}
+
+
+void Hierarchy::set_translation( const Id id, const Vec3& translation )
+{
+	mark_dirty( id );
+	translations[id] = translation;
+}
+
+
+void Hierarchy::set_rotation( const Id id, const Quat& rotation )
+{
+	mark_dirty( id );
+	rotations[id] = rotation;
+}
+
+
+void Hierarchy::set_scale( const Id id, const Vec3& scale )
+{
+	mark_dirty( id );
+	scales[id] = scale;
+}
+
+
+void Hierarchy::update_node( const Id id )
+{
+	// A parent is always updated before its children
+	const Id parent = parents[id];
+	if ( !dirty[id] && ( parent == None || versions[parent] != version ) )
+	{
+		return;
+	}
+
+	const Mat4 local = Mat4::from_trs( translations[id], rotations[id], scales[id] );
+	worlds[id]       = parent == None ? local : worlds[parent] * local;
+	dirty[id]        = 0;
+	versions[id]     = version;
+}
+
+
+void Hierarchy::update()
+{
+	++version;
+
+	const Id count = Id( size() );
+	for ( Id id = first_dirty; id < count; ++id )
+	{
+		update_node( id );
+	}
+
+	first_dirty     = count;
+	min_dirty_depth = uint32_t( levels.size() );
+}
+
+
+void Hierarchy::update( const Executor& executor, const size_t grain )
+{
+	assert( grain > 0 && "Tasks compute at least one node" );
+
+	// Nodes which may change would not fill more than one task
+	if ( size() - first_dirty <= grain )
+	{
+		update();
+		return;
+	}
+
+	++version;
+
+	// Tasks capture a single pointer, which fits in the small buffer of std::function,
+	// so that wrapping them does not allocate for each level
+	struct
+	{
+		Hierarchy* hierarchy;
+		const Id* nodes;
+		size_t count;
+		size_t grain;
+	} state = { this, nullptr, 0, grain };
+
+	// Shallower levels only hold clean nodes with clean ancestors
+	for ( size_t depth = min_dirty_depth; depth < levels.size(); ++depth )
+	{
+		// Ids of a level are increasing, and those before the first dirty one are clean
+		const auto& level = levels[depth];
+		const auto  begin = std::lower_bound( level.begin(), level.end(), first_dirty );
+		state.nodes       = level.data() + ( begin - level.begin() );
+		state.count       = size_t( level.end() - begin );
+
+		const size_t tasks = ( state.count + grain - 1 ) / grain;
+		executor( tasks, [s = &state]( const size_t task ) {
+			const size_t end = std::min( s->count, ( task + 1 ) * s->grain );
+			for ( size_t i = task * s->grain; i < end; ++i )
+			{
+				s->hierarchy->update_node( s->nodes[i] );
+			}
+		} );
+	}
+
+	first_dirty     = Id( size() );
+	min_dirty_depth = uint32_t( levels.size() );
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,76 @@
+#pragma once
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define SPOT_X86 1
+#include <immintrin.h>
+#endif
+
+/// @brief SSE2 is always there on x86-64, so kernels can use it without runtime dispatch
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define SPOT_SSE2 1
+#endif
+
+#if defined( SPOT_X86 ) && !( defined( _MSC_VER ) && !defined( __clang__ ) )
+/// @brief Lets GCC and Clang emit instructions beyond the baseline for a single function,
+/// MSVC always accepts intrinsics so there is nothing to do there
+#define SPOT_TARGET( isa ) __attribute__( ( target( isa ) ) )
+#else
+#define SPOT_TARGET( isa )
+#endif
+
+
+#ifdef SPOT_X86
+
+namespace spot::math
+{
+
+
+/// @brief Deinterleaves x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+SPOT_TARGET( "sse2" )
+inline void load_soa( const float* const p, __m128& x, __m128& y, __m128& z )
+{
+	const __m128 a = _mm_loadu_ps( p );
+	const __m128 b = _mm_loadu_ps( p + 4 );
+	const __m128 c = _mm_loadu_ps( p + 8 );
+
+	x = _mm_shuffle_ps(
+		_mm_shuffle_ps( a, a, _MM_SHUFFLE( 3, 3, 0, 0 ) ),
+		_mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) ),
+		_MM_SHUFFLE( 2, 0, 2, 0 ) );
+	y = _mm_shuffle_ps(
+		_mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) ),
+		_mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) ),
+		_MM_SHUFFLE( 2, 0, 2, 0 ) );
+	z = _mm_shuffle_ps(
+		_mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) ),
+		_mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 3, 0, 0 ) ),
+		_MM_SHUFFLE( 2, 0, 2, 0 ) );
+}
+
+
+/// @brief Inverse of load_soa
+SPOT_TARGET( "sse2" )
+inline void store_aos( float* const p, const __m128 x, const __m128 y, const __m128 z )
+{
+	const __m128 a = _mm_shuffle_ps(
+		_mm_shuffle_ps( x, y, _MM_SHUFFLE( 0, 0, 0, 0 ) ),
+		_mm_shuffle_ps( z, x, _MM_SHUFFLE( 1, 1, 0, 0 ) ),
+		_MM_SHUFFLE( 2, 0, 2, 0 ) );
+	const __m128 b = _mm_shuffle_ps(
+		_mm_shuffle_ps( y, z, _MM_SHUFFLE( 1, 1, 1, 1 ) ),
+		_mm_shuffle_ps( x, y, _MM_SHUFFLE( 2, 2, 2, 2 ) ),
+		_MM_SHUFFLE( 2, 0, 2, 0 ) );
+	const __m128 c = _mm_shuffle_ps(
+		_mm_shuffle_ps( z, x, _MM_SHUFFLE( 3, 3, 2, 2 ) ),
+		_mm_shuffle_ps( y, z, _MM_SHUFFLE( 3, 3, 3, 3 ) ),
+		_MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+	_mm_storeu_ps( p, a );
+	_mm_storeu_ps( p + 4, b );
+	_mm_storeu_ps( p + 8, c );
+}
+
+
+}  // namespace spot::math
+
+#endif  // SPOT_X86
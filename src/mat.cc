@@ -0,0 +1,86 @@
+#include "spot/math/mat.h"
+
+#include "spot/math/simd.h"
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+/// @brief Computes out = a * b for column-major 4x4 doubles,
+/// summing the products in the same order of the generic operator
+void mul_scalar( const double* const a, const double* const b, double* const out )
+{
+	for ( size_t column = 0; column < 4; ++column )
+	{
+		for ( size_t row = 0; row < 4; ++row )
+		{
+			out[row + 4 * column] = a[row] * b[4 * column] + a[row + 4] * b[4 * column + 1] +
+				a[row + 8] * b[4 * column + 2] + a[row + 12] * b[4 * column + 3];
+		}
+	}
+}
+
+
+#ifdef SPOT_X86
+
+/// @brief Same as mul_scalar with a column of a in each register,
+/// broadcasting the elements of each column of b
+SPOT_TARGET( "avx" )
+void mul_avx( const double* const a, const double* const b, double* const out )
+{
+	const __m256d a0 = _mm256_loadu_pd( a );
+	const __m256d a1 = _mm256_loadu_pd( a + 4 );
+	const __m256d a2 = _mm256_loadu_pd( a + 8 );
+	const __m256d a3 = _mm256_loadu_pd( a + 12 );
+
+	__m256d r[4];
+	for ( size_t j = 0; j < 4; ++j )
+	{
+		const double* bj = b + 4 * j;
+		r[j] = _mm256_mul_pd( a0, _mm256_broadcast_sd( bj ) );
+		r[j] = _mm256_add_pd( r[j], _mm256_mul_pd( a1, _mm256_broadcast_sd( bj + 1 ) ) );
+		r[j] = _mm256_add_pd( r[j], _mm256_mul_pd( a2, _mm256_broadcast_sd( bj + 2 ) ) );
+		r[j] = _mm256_add_pd( r[j], _mm256_mul_pd( a3, _mm256_broadcast_sd( bj + 3 ) ) );
+	}
+
+	// Stored after all the columns are computed, as out may alias a or b
+	for ( size_t j = 0; j < 4; ++j )
+	{
+		_mm256_storeu_pd( out + 4 * j, r[j] );
+	}
+}
+
+#endif  // SPOT_X86
+
+
+}  // namespace
+
+
+template <>
+Mat<4, 4, double> operator*( const Mat<4, 4, double>& a, const Mat<4, 4, double>& b )
+{
+	// Built from a local array, so that the elements of the result are not zeroed first
+	double out[16];
+#ifdef SPOT_X86
+	static const bool avx = get_simd_support() >= Simd::Avx;
+	if ( avx )
+	{
+		mul_avx( a.matrix, b.matrix, out );
+	}
+	else
+#endif
+	{
+		mul_scalar( a.matrix, b.matrix, out );
+	}
+	return Mat<4, 4, double>::generate( [&]( size_t row, size_t column ) { return out[row + 4 * column]; } );
+}
+
+
+}  // namespace spot::math
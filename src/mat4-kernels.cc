@@ -0,0 +1,629 @@
+#include "spot/math/simd.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+void mul_scalar( const float* const a, const float* const b, float* const out )
+{
+	float temp[16];
+
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		const float c0 = a[i];
+		const float c1 = a[i+4];
+		const float c2 = a[i+8];
+		const float c3 = a[i+12];
+
+		for ( size_t j = 0; j < 4; ++j )
+		{
+			const size_t k = j * 4;
+			const float e = c0 * b[k];
+			const float f = c1 * b[k+1];
+			const float g = c2 * b[k+2];
+			const float h = c3 * b[k+3];
+			temp[i+k] = e + f + g + h;
+		}
+	}
+
+	std::memcpy( out, temp, sizeof( float ) * 16 );
+}
+
+
+void mul_vec4_scalar( const float* const m, const float* const v, float* const out )
+{
+	float temp[4];
+
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		const float e = m[i] * v[0];
+		const float f = m[i+4] * v[1];
+		const float g = m[i+8] * v[2];
+		const float h = m[i+12] * v[3];
+		temp[i] = e + f + g + h;
+	}
+
+	std::memcpy( out, temp, sizeof( float ) * 4 );
+}
+
+
+/// @brief Transforms count points of 3 floats, w is 1 for points and 0 for vectors
+template <bool Translate, bool Divide>
+void transform_scalar( const float* const m, const float* in, float* out, const size_t count )
+{
+	for ( size_t n = 0; n < count; ++n, in += 3, out += 3 )
+	{
+		const float x = in[0];
+		const float y = in[1];
+		const float z = in[2];
+
+		float r[4];
+		for ( size_t i = 0; i < 4; ++i )
+		{
+			r[i] = m[i] * x + m[i+4] * y + m[i+8] * z;
+			if ( Translate )
+			{
+				r[i] += m[i+12];
+			}
+		}
+
+		if ( Divide )
+		{
+			out[0] = r[0] / r[3];
+			out[1] = r[1] / r[3];
+			out[2] = r[2] / r[3];
+		}
+		else
+		{
+			out[0] = r[0];
+			out[1] = r[1];
+			out[2] = r[2];
+		}
+	}
+}
+
+
+void transform_points_scalar( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_scalar<true, true>( m, in, out, count );
+}
+
+
+void transform_points_affine_scalar( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_scalar<true, false>( m, in, out, count );
+}
+
+
+void transform_vectors_scalar( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_scalar<false, false>( m, in, out, count );
+}
+
+
+/// @brief Laplace expansion over 2x2 sub-determinants of the two upper
+/// and the two lower rows, which works the same for the transpose
+/// @param[out] s Sub-determinants of rows 0 and 1
+/// @param[out] c Sub-determinants of rows 2 and 3
+inline void sub_determinants( const float* const m, float s[6], float c[6] )
+{
+	// a(row, column)
+	auto a = [m]( size_t r, size_t col ) { return m[r + 4 * col]; };
+
+	s[0] = a(0,0) * a(1,1) - a(1,0) * a(0,1);
+	s[1] = a(0,0) * a(1,2) - a(1,0) * a(0,2);
+	s[2] = a(0,0) * a(1,3) - a(1,0) * a(0,3);
+	s[3] = a(0,1) * a(1,2) - a(1,1) * a(0,2);
+	s[4] = a(0,1) * a(1,3) - a(1,1) * a(0,3);
+	s[5] = a(0,2) * a(1,3) - a(1,2) * a(0,3);
+
+	c[5] = a(2,2) * a(3,3) - a(3,2) * a(2,3);
+	c[4] = a(2,1) * a(3,3) - a(3,1) * a(2,3);
+	c[3] = a(2,1) * a(3,2) - a(3,1) * a(2,2);
+	c[2] = a(2,0) * a(3,3) - a(3,0) * a(2,3);
+	c[1] = a(2,0) * a(3,2) - a(3,0) * a(2,2);
+	c[0] = a(2,0) * a(3,1) - a(3,0) * a(2,1);
+}
+
+
+float determinant_scalar( const float* const m )
+{
+	float s[6];
+	float c[6];
+	sub_determinants( m, s, c );
+	return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+}
+
+
+float inverse_scalar( const float* const m, float* const out )
+{
+	float s[6];
+	float c[6];
+	sub_determinants( m, s, c );
+
+	const float det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+	const float inv_det = 1.0f / det;
+
+	auto a = [m]( size_t r, size_t col ) { return m[r + 4 * col]; };
+
+	float r[16];
+	auto i = [&r]( size_t row, size_t col ) -> float& { return r[row + 4 * col]; };
+
+	i(0,0) = (  a(1,1) * c[5] - a(1,2) * c[4] + a(1,3) * c[3] ) * inv_det;
+	i(0,1) = ( -a(0,1) * c[5] + a(0,2) * c[4] - a(0,3) * c[3] ) * inv_det;
+	i(0,2) = (  a(3,1) * s[5] - a(3,2) * s[4] + a(3,3) * s[3] ) * inv_det;
+	i(0,3) = ( -a(2,1) * s[5] + a(2,2) * s[4] - a(2,3) * s[3] ) * inv_det;
+
+	i(1,0) = ( -a(1,0) * c[5] + a(1,2) * c[2] - a(1,3) * c[1] ) * inv_det;
+	i(1,1) = (  a(0,0) * c[5] - a(0,2) * c[2] + a(0,3) * c[1] ) * inv_det;
+	i(1,2) = ( -a(3,0) * s[5] + a(3,2) * s[2] - a(3,3) * s[1] ) * inv_det;
+	i(1,3) = (  a(2,0) * s[5] - a(2,2) * s[2] + a(2,3) * s[1] ) * inv_det;
+
+	i(2,0) = (  a(1,0) * c[4] - a(1,1) * c[2] + a(1,3) * c[0] ) * inv_det;
+	i(2,1) = ( -a(0,0) * c[4] + a(0,1) * c[2] - a(0,3) * c[0] ) * inv_det;
+	i(2,2) = (  a(3,0) * s[4] - a(3,1) * s[2] + a(3,3) * s[0] ) * inv_det;
+	i(2,3) = ( -a(2,0) * s[4] + a(2,1) * s[2] - a(2,3) * s[0] ) * inv_det;
+
+	i(3,0) = ( -a(1,0) * c[3] + a(1,1) * c[1] - a(1,2) * c[0] ) * inv_det;
+	i(3,1) = (  a(0,0) * c[3] - a(0,1) * c[1] + a(0,2) * c[0] ) * inv_det;
+	i(3,2) = ( -a(3,0) * s[3] + a(3,1) * s[1] - a(3,2) * s[0] ) * inv_det;
+	i(3,3) = (  a(2,0) * s[3] - a(2,1) * s[1] + a(2,2) * s[0] ) * inv_det;
+
+	std::memcpy( out, r, sizeof( r ) );
+	return det;
+}
+
+
+#if defined( SPOT_X86 )
+
+
+// Every column of the result is a linear combination of the columns of a
+// weighted by a column of b. Products are summed in the same order as the
+// scalar kernel, so results are bit-identical as long as FMA is not used.
+
+
+SPOT_TARGET( "sse2" )
+void mul_sse2( const float* const a, const float* const b, float* const out )
+{
+	const __m128 a0 = _mm_loadu_ps( a );
+	const __m128 a1 = _mm_loadu_ps( a + 4 );
+	const __m128 a2 = _mm_loadu_ps( a + 8 );
+	const __m128 a3 = _mm_loadu_ps( a + 12 );
+
+	__m128 b_cols[4];
+	for ( size_t j = 0; j < 4; ++j )
+	{
+		b_cols[j] = _mm_loadu_ps( b + j * 4 );
+	}
+
+	for ( size_t j = 0; j < 4; ++j )
+	{
+		const __m128 bj = b_cols[j];
+		__m128 r = _mm_mul_ps( a0, _mm_shuffle_ps( bj, bj, 0x00 ) );
+		r = _mm_add_ps( r, _mm_mul_ps( a1, _mm_shuffle_ps( bj, bj, 0x55 ) ) );
+		r = _mm_add_ps( r, _mm_mul_ps( a2, _mm_shuffle_ps( bj, bj, 0xAA ) ) );
+		r = _mm_add_ps( r, _mm_mul_ps( a3, _mm_shuffle_ps( bj, bj, 0xFF ) ) );
+		_mm_storeu_ps( out + j * 4, r );
+	}
+}
+
+
+SPOT_TARGET( "sse2" )
+void mul_vec4_sse2( const float* const m, const float* const v, float* const out )
+{
+	const __m128 vv = _mm_loadu_ps( v );
+	__m128 r = _mm_mul_ps( _mm_loadu_ps( m ), _mm_shuffle_ps( vv, vv, 0x00 ) );
+	r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 4 ), _mm_shuffle_ps( vv, vv, 0x55 ) ) );
+	r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 8 ), _mm_shuffle_ps( vv, vv, 0xAA ) ) );
+	r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 12 ), _mm_shuffle_ps( vv, vv, 0xFF ) ) );
+	_mm_storeu_ps( out, r );
+}
+
+
+/// @brief Computes two columns of the result per iteration, with the
+/// columns of a broadcast to both 128-bit lanes
+SPOT_TARGET( "avx" )
+void mul_avx( const float* const a, const float* const b, float* const out )
+{
+	const __m256 a0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a ) );
+	const __m256 a1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a + 4 ) );
+	const __m256 a2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a + 8 ) );
+	const __m256 a3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a + 12 ) );
+
+	const __m256 b01 = _mm256_loadu_ps( b );
+	const __m256 b23 = _mm256_loadu_ps( b + 8 );
+
+	__m256 r01 = _mm256_mul_ps( a0, _mm256_shuffle_ps( b01, b01, 0x00 ) );
+	r01 = _mm256_add_ps( r01, _mm256_mul_ps( a1, _mm256_shuffle_ps( b01, b01, 0x55 ) ) );
+	r01 = _mm256_add_ps( r01, _mm256_mul_ps( a2, _mm256_shuffle_ps( b01, b01, 0xAA ) ) );
+	r01 = _mm256_add_ps( r01, _mm256_mul_ps( a3, _mm256_shuffle_ps( b01, b01, 0xFF ) ) );
+
+	__m256 r23 = _mm256_mul_ps( a0, _mm256_shuffle_ps( b23, b23, 0x00 ) );
+	r23 = _mm256_add_ps( r23, _mm256_mul_ps( a1, _mm256_shuffle_ps( b23, b23, 0x55 ) ) );
+	r23 = _mm256_add_ps( r23, _mm256_mul_ps( a2, _mm256_shuffle_ps( b23, b23, 0xAA ) ) );
+	r23 = _mm256_add_ps( r23, _mm256_mul_ps( a3, _mm256_shuffle_ps( b23, b23, 0xFF ) ) );
+
+	_mm256_storeu_ps( out, r01 );
+	_mm256_storeu_ps( out + 8, r23 );
+}
+
+
+SPOT_TARGET( "avx2,fma" )
+void mul_avx2( const float* const a, const float* const b, float* const out )
+{
+	const __m256 a0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a ) );
+	const __m256 a1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a + 4 ) );
+	const __m256 a2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a + 8 ) );
+	const __m256 a3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( a + 12 ) );
+
+	const __m256 b01 = _mm256_loadu_ps( b );
+	const __m256 b23 = _mm256_loadu_ps( b + 8 );
+
+	__m256 r01 = _mm256_mul_ps( a0, _mm256_shuffle_ps( b01, b01, 0x00 ) );
+	r01 = _mm256_fmadd_ps( a1, _mm256_shuffle_ps( b01, b01, 0x55 ), r01 );
+	r01 = _mm256_fmadd_ps( a2, _mm256_shuffle_ps( b01, b01, 0xAA ), r01 );
+	r01 = _mm256_fmadd_ps( a3, _mm256_shuffle_ps( b01, b01, 0xFF ), r01 );
+
+	__m256 r23 = _mm256_mul_ps( a0, _mm256_shuffle_ps( b23, b23, 0x00 ) );
+	r23 = _mm256_fmadd_ps( a1, _mm256_shuffle_ps( b23, b23, 0x55 ), r23 );
+	r23 = _mm256_fmadd_ps( a2, _mm256_shuffle_ps( b23, b23, 0xAA ), r23 );
+	r23 = _mm256_fmadd_ps( a3, _mm256_shuffle_ps( b23, b23, 0xFF ), r23 );
+
+	_mm256_storeu_ps( out, r01 );
+	_mm256_storeu_ps( out + 8, r23 );
+}
+
+
+SPOT_TARGET( "avx2,fma" )
+void mul_vec4_avx2( const float* const m, const float* const v, float* const out )
+{
+	const __m128 vv = _mm_loadu_ps( v );
+	__m128 r = _mm_mul_ps( _mm_loadu_ps( m ), _mm_shuffle_ps( vv, vv, 0x00 ) );
+	r = _mm_fmadd_ps( _mm_loadu_ps( m + 4 ), _mm_shuffle_ps( vv, vv, 0x55 ), r );
+	r = _mm_fmadd_ps( _mm_loadu_ps( m + 8 ), _mm_shuffle_ps( vv, vv, 0xAA ), r );
+	r = _mm_fmadd_ps( _mm_loadu_ps( m + 12 ), _mm_shuffle_ps( vv, vv, 0xFF ), r );
+	_mm_storeu_ps( out, r );
+}
+
+
+// The inverse splits the matrix in four 2x2 blocks A B C D, each held
+// in one register, and builds the blocks of the adjugate from products
+// of 2x2 adjugates. Whether columns or rows are stored does not matter
+// as the inverse of the transpose is the transpose of the inverse.
+
+
+/// @brief Picks lanes x y of a and z w of b
+#define SPOT_SHUFFLE( a, b, x, y, z, w ) _mm_shuffle_ps( a, b, _MM_SHUFFLE( w, z, y, x ) )
+#define SPOT_SWIZZLE( a, x, y, z, w ) SPOT_SHUFFLE( a, a, x, y, z, w )
+
+
+/// @return 2x2 product a * b
+SPOT_TARGET( "sse2" )
+inline __m128 mat2_mul( const __m128 a, const __m128 b )
+{
+	return _mm_add_ps(
+		_mm_mul_ps( a, SPOT_SWIZZLE( b, 0, 3, 0, 3 ) ),
+		_mm_mul_ps( SPOT_SWIZZLE( a, 1, 0, 3, 2 ), SPOT_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+
+/// @return 2x2 product adj(a) * b
+SPOT_TARGET( "sse2" )
+inline __m128 mat2_adj_mul( const __m128 a, const __m128 b )
+{
+	return _mm_sub_ps(
+		_mm_mul_ps( SPOT_SWIZZLE( a, 3, 3, 0, 0 ), b ),
+		_mm_mul_ps( SPOT_SWIZZLE( a, 1, 1, 2, 2 ), SPOT_SWIZZLE( b, 2, 3, 0, 1 ) ) );
+}
+
+
+/// @return 2x2 product a * adj(b)
+SPOT_TARGET( "sse2" )
+inline __m128 mat2_mul_adj( const __m128 a, const __m128 b )
+{
+	return _mm_sub_ps(
+		_mm_mul_ps( a, SPOT_SWIZZLE( b, 3, 0, 3, 0 ) ),
+		_mm_mul_ps( SPOT_SWIZZLE( a, 1, 0, 3, 2 ), SPOT_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+
+/// @return The sum of the four lanes in every lane
+SPOT_TARGET( "sse2" )
+inline __m128 horizontal_sum( const __m128 v )
+{
+	const __m128 t = _mm_add_ps( v, SPOT_SWIZZLE( v, 2, 3, 0, 1 ) );
+	return _mm_add_ps( t, SPOT_SWIZZLE( t, 1, 0, 3, 2 ) );
+}
+
+
+/// @brief Determinants of the 2x2 blocks as |A| |B| |C| |D|
+SPOT_TARGET( "sse2" )
+inline __m128 block_determinants( const __m128 c0, const __m128 c1, const __m128 c2, const __m128 c3 )
+{
+	return _mm_sub_ps(
+		_mm_mul_ps( SPOT_SHUFFLE( c0, c2, 0, 2, 0, 2 ), SPOT_SHUFFLE( c1, c3, 1, 3, 1, 3 ) ),
+		_mm_mul_ps( SPOT_SHUFFLE( c0, c2, 1, 3, 1, 3 ), SPOT_SHUFFLE( c1, c3, 0, 2, 0, 2 ) ) );
+}
+
+
+SPOT_TARGET( "sse2" )
+float determinant_sse2( const float* const m )
+{
+	const __m128 c0 = _mm_loadu_ps( m );
+	const __m128 c1 = _mm_loadu_ps( m + 4 );
+	const __m128 c2 = _mm_loadu_ps( m + 8 );
+	const __m128 c3 = _mm_loadu_ps( m + 12 );
+
+	const __m128 a = _mm_movelh_ps( c0, c1 );
+	const __m128 b = _mm_movehl_ps( c1, c0 );
+	const __m128 c = _mm_movelh_ps( c2, c3 );
+	const __m128 d = _mm_movehl_ps( c3, c2 );
+
+	const __m128 dets = block_determinants( c0, c1, c2, c3 );
+
+	// |M| = |A| |D| + |B| |C| - tr( adj(A) B adj(D) C )
+	const __m128 tr = horizontal_sum( _mm_mul_ps( mat2_adj_mul( a, b ), SPOT_SWIZZLE( mat2_adj_mul( d, c ), 0, 2, 1, 3 ) ) );
+	const __m128 det = _mm_sub_ps(
+		_mm_add_ps(
+			_mm_mul_ps( SPOT_SWIZZLE( dets, 0, 0, 0, 0 ), SPOT_SWIZZLE( dets, 3, 3, 3, 3 ) ),
+			_mm_mul_ps( SPOT_SWIZZLE( dets, 1, 1, 1, 1 ), SPOT_SWIZZLE( dets, 2, 2, 2, 2 ) ) ),
+		tr );
+
+	return _mm_cvtss_f32( det );
+}
+
+
+SPOT_TARGET( "sse2" )
+float inverse_sse2( const float* const m, float* const out )
+{
+	const __m128 c0 = _mm_loadu_ps( m );
+	const __m128 c1 = _mm_loadu_ps( m + 4 );
+	const __m128 c2 = _mm_loadu_ps( m + 8 );
+	const __m128 c3 = _mm_loadu_ps( m + 12 );
+
+	const __m128 a = _mm_movelh_ps( c0, c1 );
+	const __m128 b = _mm_movehl_ps( c1, c0 );
+	const __m128 c = _mm_movelh_ps( c2, c3 );
+	const __m128 d = _mm_movehl_ps( c3, c2 );
+
+	const __m128 dets = block_determinants( c0, c1, c2, c3 );
+	const __m128 det_a = SPOT_SWIZZLE( dets, 0, 0, 0, 0 );
+	const __m128 det_b = SPOT_SWIZZLE( dets, 1, 1, 1, 1 );
+	const __m128 det_c = SPOT_SWIZZLE( dets, 2, 2, 2, 2 );
+	const __m128 det_d = SPOT_SWIZZLE( dets, 3, 3, 3, 3 );
+
+	const __m128 d_c = mat2_adj_mul( d, c );
+	const __m128 a_b = mat2_adj_mul( a, b );
+
+	// Adjugates of the blocks of the inverse, scaled by |M|
+	__m128 x = _mm_sub_ps( _mm_mul_ps( det_d, a ), mat2_mul( b, d_c ) );
+	__m128 w = _mm_sub_ps( _mm_mul_ps( det_a, d ), mat2_mul( c, a_b ) );
+	__m128 y = _mm_sub_ps( _mm_mul_ps( det_b, c ), mat2_mul_adj( d, a_b ) );
+	__m128 z = _mm_sub_ps( _mm_mul_ps( det_c, b ), mat2_mul_adj( a, d_c ) );
+
+	const __m128 tr = horizontal_sum( _mm_mul_ps( a_b, SPOT_SWIZZLE( d_c, 0, 2, 1, 3 ) ) );
+	const __m128 det = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( det_a, det_d ), _mm_mul_ps( det_b, det_c ) ), tr );
+
+	// Signs of the adjugate
+	const __m128 inv_det = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+	x = _mm_mul_ps( x, inv_det );
+	y = _mm_mul_ps( y, inv_det );
+	z = _mm_mul_ps( z, inv_det );
+	w = _mm_mul_ps( w, inv_det );
+
+	// Taking the adjugates and storing back as columns in one shuffle
+	_mm_storeu_ps( out, SPOT_SHUFFLE( x, y, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( out + 4, SPOT_SHUFFLE( x, y, 2, 0, 2, 0 ) );
+	_mm_storeu_ps( out + 8, SPOT_SHUFFLE( z, w, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( out + 12, SPOT_SHUFFLE( z, w, 2, 0, 2, 0 ) );
+
+	return _mm_cvtss_f32( det );
+}
+
+
+#undef SPOT_SWIZZLE
+#undef SPOT_SHUFFLE
+
+
+// Batch transforms load four packed Vec3 as three registers and shuffle
+// them to one register per component with load_soa, so each matrix
+// element is broadcast once per four points instead of once per point.
+
+
+template <bool Translate, bool Divide>
+SPOT_TARGET( "sse2" )
+void transform_sse2( const float* const m, const float* in, float* out, const size_t count )
+{
+	__m128 e[16];
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		e[i] = _mm_set1_ps( m[i] );
+	}
+
+	size_t n = 0;
+	for ( ; n + 4 <= count; n += 4, in += 12, out += 12 )
+	{
+		__m128 x, y, z;
+		load_soa( in, x, y, z );
+
+		__m128 r[4];
+		for ( size_t i = 0; i < 4; ++i )
+		{
+			r[i] = _mm_mul_ps( e[i], x );
+			r[i] = _mm_add_ps( r[i], _mm_mul_ps( e[i+4], y ) );
+			r[i] = _mm_add_ps( r[i], _mm_mul_ps( e[i+8], z ) );
+			if ( Translate )
+			{
+				r[i] = _mm_add_ps( r[i], e[i+12] );
+			}
+		}
+
+		if ( Divide )
+		{
+			r[0] = _mm_div_ps( r[0], r[3] );
+			r[1] = _mm_div_ps( r[1], r[3] );
+			r[2] = _mm_div_ps( r[2], r[3] );
+		}
+
+		store_aos( out, r[0], r[1], r[2] );
+	}
+
+	transform_scalar<Translate, Divide>( m, in, out, count - n );
+}
+
+
+void transform_points_sse2( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_sse2<true, true>( m, in, out, count );
+}
+
+
+void transform_points_affine_sse2( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_sse2<true, false>( m, in, out, count );
+}
+
+
+void transform_vectors_sse2( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_sse2<false, false>( m, in, out, count );
+}
+
+
+/// @brief Like transform_sse2, eight points at a time with fused multiply-adds
+template <bool Translate, bool Divide>
+SPOT_TARGET( "avx2,fma" )
+void transform_avx2( const float* const m, const float* in, float* out, const size_t count )
+{
+	__m256 e[16];
+	for ( size_t i = 0; i < 16; ++i )
+	{
+		e[i] = _mm256_set1_ps( m[i] );
+	}
+
+	size_t n = 0;
+	for ( ; n + 8 <= count; n += 8, in += 24, out += 24 )
+	{
+		__m128 x0, y0, z0, x1, y1, z1;
+		load_soa( in, x0, y0, z0 );
+		load_soa( in + 12, x1, y1, z1 );
+
+		const __m256 x = _mm256_insertf128_ps( _mm256_castps128_ps256( x0 ), x1, 1 );
+		const __m256 y = _mm256_insertf128_ps( _mm256_castps128_ps256( y0 ), y1, 1 );
+		const __m256 z = _mm256_insertf128_ps( _mm256_castps128_ps256( z0 ), z1, 1 );
+
+		__m256 r[4];
+		for ( size_t i = 0; i < 4; ++i )
+		{
+			r[i] = Translate ? _mm256_fmadd_ps( e[i], x, e[i+12] ) : _mm256_mul_ps( e[i], x );
+			r[i] = _mm256_fmadd_ps( e[i+4], y, r[i] );
+			r[i] = _mm256_fmadd_ps( e[i+8], z, r[i] );
+		}
+
+		if ( Divide )
+		{
+			r[0] = _mm256_div_ps( r[0], r[3] );
+			r[1] = _mm256_div_ps( r[1], r[3] );
+			r[2] = _mm256_div_ps( r[2], r[3] );
+		}
+
+		store_aos( out, _mm256_castps256_ps128( r[0] ), _mm256_castps256_ps128( r[1] ), _mm256_castps256_ps128( r[2] ) );
+		store_aos( out + 12, _mm256_extractf128_ps( r[0], 1 ), _mm256_extractf128_ps( r[1], 1 ), _mm256_extractf128_ps( r[2], 1 ) );
+	}
+
+	transform_sse2<Translate, Divide>( m, in, out, count - n );
+}
+
+
+void transform_points_avx2( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_avx2<true, true>( m, in, out, count );
+}
+
+
+void transform_points_affine_avx2( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_avx2<true, false>( m, in, out, count );
+}
+
+
+void transform_vectors_avx2( const float* const m, const float* const in, float* const out, const size_t count )
+{
+	transform_avx2<false, false>( m, in, out, count );
+}
+
+
+#endif
+
+
+const Mat4Kernels kernels[] = {
+	{
+		mul_scalar,
+		mul_vec4_scalar,
+		transform_points_scalar,
+		transform_points_affine_scalar,
+		transform_vectors_scalar,
+		determinant_scalar,
+		inverse_scalar,
+	},
+#if defined( SPOT_X86 )
+	{
+		mul_sse2,
+		mul_vec4_sse2,
+		transform_points_sse2,
+		transform_points_affine_sse2,
+		transform_vectors_sse2,
+		determinant_sse2,
+		inverse_sse2,
+	},
+	{
+		mul_avx,
+		mul_vec4_sse2,
+		transform_points_sse2,
+		transform_points_affine_sse2,
+		transform_vectors_sse2,
+		determinant_sse2,
+		inverse_sse2,
+	},
+	{
+		mul_avx2,
+		mul_vec4_avx2,
+		transform_points_avx2,
+		transform_points_affine_avx2,
+		transform_vectors_avx2,
+		determinant_sse2,
+		inverse_sse2,
+	},
+#endif
+};
+
+
+}  // namespace
+
+
+const Mat4Kernels& get_mat4_kernels( const Simd simd )
+{
+	auto support = get_simd_support();
+	auto index = static_cast<size_t>( simd < support ? simd : support );
+	return kernels[index];
+}
+
+
+const Mat4Kernels& get_mat4_kernels()
+{
+	static const Mat4Kernels& best = get_mat4_kernels( get_simd_support() );
+	return best;
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,5 @@
+#include "spot/math/mat4.h"
+
+#ifndef SPOT_MATH_INLINE
+#include "spot/math/mat4.inl"
+#endif
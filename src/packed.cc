@@ -0,0 +1,648 @@
+#include "spot/math/packed.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+uint32_t get_bits( const float f )
+{
+	uint32_t u;
+	std::memcpy( &u, &f, sizeof( u ) );
+	return u;
+}
+
+
+float from_bits( const uint32_t u )
+{
+	float f;
+	std::memcpy( &f, &u, sizeof( f ) );
+	return f;
+}
+
+
+/// Magnitudes from which halves overflow to infinity, 2^16
+constexpr uint32_t HalfOverflow = ( 127 + 16 ) << 23;
+/// Magnitudes below which halves are subnormal, 2^-14
+constexpr uint32_t HalfMinNormal = ( 127 - 14 ) << 23;
+/// Added to magnitudes of subnormal halves, so that the float addition rounds
+/// them to the mantissa bits of the half, 2^-1
+constexpr uint32_t HalfSubnormalMagic = ( ( 127 - 15 ) + ( 23 - 10 ) + 1 ) << 23;
+/// Rebiases the exponent of normal halves, adding just below half of the
+/// last place kept, so that a carry out of the dropped bits rounds up
+constexpr uint32_t HalfNormalBias = 0xfff - ( ( 127 - 15 ) << 23 );
+/// Moves exponents of halves shifted into place to the ones of floats, 2^112
+constexpr uint32_t HalfExponentMagic = ( 254 - 15 ) << 23;
+
+
+/// @brief Per axis factors of a quantization within a box, with a null scale for empty axes
+struct Quantization
+{
+	Quantization( const Box& range )
+	{
+		const float a[3] = { range.a.x, range.a.y, range.a.z };
+		const float b[3] = { range.b.x, range.b.y, range.b.z };
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			const float extent = b[i] - a[i];
+			min[i] = a[i];
+			scale[i] = extent > 0.0f ? float( QuantizedVec3::Max ) / extent : 0.0f;
+			step[i] = extent / float( QuantizedVec3::Max );
+		}
+	}
+
+	float min[3];
+	float scale[3];
+	float step[3];
+};
+
+
+uint16_t quantize( const float v, const float min, const float scale )
+{
+	float t = ( v - min ) * scale;
+	// Same as minps and maxps, NaNs becoming the last argument
+	t = t < float( QuantizedVec3::Max ) ? t : float( QuantizedVec3::Max );
+	t = t > 0.0f ? t : 0.0f;
+	return uint16_t( int32_t( t + 0.5f ) );
+}
+
+
+float dequantize( const uint16_t q, const float min, const float step )
+{
+	return min + float( q ) * step;
+}
+
+
+/// @brief Factors of the smallest three components of unit quaternions, within
+/// plus or minus 1 / sqrt( 2 ), to codes from 0 to 2 * Center with zero at Center
+template <uint32_t Center>
+struct SmallestThree
+{
+	static constexpr float Scale = float( Center ) * 1.41421356f;
+	static constexpr float Step = 0.707106781f / float( Center );
+};
+
+
+/// @return The index of the largest component of q, the first one for ties, with
+/// codes of the other three in order, negated when the largest one is negative
+template <uint32_t Center>
+uint32_t encode_smallest_three( const Quat& q, uint32_t codes[3] )
+{
+	const float c[4] = { q.w, q.x, q.y, q.z };
+
+	uint32_t index = 0;
+	float largest = std::abs( c[0] );
+	for ( uint32_t i = 1; i < 4; ++i )
+	{
+		if ( std::abs( c[i] ) > largest )
+		{
+			largest = std::abs( c[i] );
+			index = i;
+		}
+	}
+
+	const bool negative = std::signbit( c[index] );
+	for ( uint32_t i = 0, j = 0; i < 4; ++i )
+	{
+		if ( i != index )
+		{
+			float t = ( negative ? -c[i] : c[i] ) * SmallestThree<Center>::Scale + float( Center );
+			t = t < float( 2 * Center ) ? t : float( 2 * Center );
+			t = t > 0.0f ? t : 0.0f;
+			codes[j++] = uint32_t( int32_t( t + 0.5f ) );
+		}
+	}
+	return index;
+}
+
+
+/// @brief Inverse of encode_smallest_three, the largest component being recomputed from the others
+template <uint32_t Center>
+Quat decode_smallest_three( const uint32_t index, const uint32_t codes[3] )
+{
+	float smallest[3];
+	for ( size_t j = 0; j < 3; ++j )
+	{
+		smallest[j] = ( float( codes[j] ) - float( Center ) ) * SmallestThree<Center>::Step;
+	}
+	const float t = 1.0f - ( smallest[0] * smallest[0] + smallest[1] * smallest[1] + smallest[2] * smallest[2] );
+
+	float c[4];
+	for ( uint32_t i = 0, j = 0; i < 4; ++i )
+	{
+		c[i] = i == index ? std::sqrt( t > 0.0f ? t : 0.0f ) : smallest[j++];
+	}
+	return Quat( c[0], c[1], c[2], c[3] );
+}
+
+
+#ifdef SPOT_SSE2
+
+
+/// @brief Same operations of to_half on four floats, to the low 16 bits of each lane
+__m128i to_half( const __m128 f )
+{
+	const __m128i sign = _mm_and_si128( _mm_castps_si128( f ), _mm_set1_epi32( 0x80000000 ) );
+	const __m128i u = _mm_xor_si128( _mm_castps_si128( f ), sign );
+
+	// Infinity, or NaN with the top bits of its payload and the quiet bit
+	const __m128i nan = _mm_castps_si128( _mm_cmpunord_ps( _mm_castsi128_ps( u ), _mm_castsi128_ps( u ) ) );
+	const __m128i payload = _mm_or_si128( _mm_set1_epi32( 0x200 ), _mm_and_si128( _mm_srli_epi32( u, 13 ), _mm_set1_epi32( 0x3ff ) ) );
+	const __m128i special = _mm_or_si128( _mm_set1_epi32( 0x7c00 ), _mm_and_si128( nan, payload ) );
+
+	const __m128i magic = _mm_set1_epi32( HalfSubnormalMagic );
+	const __m128i subnormal = _mm_sub_epi32(
+		_mm_castps_si128( _mm_add_ps( _mm_castsi128_ps( u ), _mm_castsi128_ps( magic ) ) ), magic );
+
+	const __m128i odd = _mm_and_si128( _mm_srli_epi32( u, 13 ), _mm_set1_epi32( 1 ) );
+	const __m128i normal = _mm_srli_epi32( _mm_add_epi32( _mm_add_epi32( u, _mm_set1_epi32( HalfNormalBias ) ), odd ), 13 );
+
+	const __m128i is_subnormal = _mm_cmplt_epi32( u, _mm_set1_epi32( HalfMinNormal ) );
+	const __m128i is_regular = _mm_cmplt_epi32( u, _mm_set1_epi32( HalfOverflow ) );
+	const __m128i regular = _mm_or_si128( _mm_and_si128( is_subnormal, subnormal ), _mm_andnot_si128( is_subnormal, normal ) );
+	const __m128i h = _mm_or_si128( _mm_and_si128( is_regular, regular ), _mm_andnot_si128( is_regular, special ) );
+	return _mm_or_si128( h, _mm_srli_epi32( sign, 16 ) );
+}
+
+
+/// @brief Same operations of from_half on four halves, in the low 16 bits of each lane
+__m128 from_half( const __m128i h )
+{
+	const __m128i magnitude = _mm_and_si128( h, _mm_set1_epi32( 0x7fff ) );
+	const __m128i sign = _mm_slli_epi32( _mm_xor_si128( h, magnitude ), 16 );
+	const __m128 scaled = _mm_mul_ps( _mm_castsi128_ps( _mm_slli_epi32( magnitude, 13 ) ),
+		_mm_castsi128_ps( _mm_set1_epi32( HalfExponentMagic ) ) );
+	const __m128i special = _mm_and_si128( _mm_cmpgt_epi32( magnitude, _mm_set1_epi32( 0x7bff ) ), _mm_set1_epi32( 0x7f800000 ) );
+	const __m128i quiet = _mm_and_si128( _mm_cmpgt_epi32( magnitude, _mm_set1_epi32( 0x7c00 ) ), _mm_set1_epi32( 0x00400000 ) );
+	return _mm_castsi128_ps( _mm_or_si128( _mm_or_si128( _mm_castps_si128( scaled ), special ), _mm_or_si128( quiet, sign ) ) );
+}
+
+
+/// @brief Packs the low 16 bits of the lanes of a and b, as packs would saturate values above 0x7fff
+__m128i pack_low_16( const __m128i a, const __m128i b )
+{
+	return _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( a, 16 ), 16 ), _mm_srai_epi32( _mm_slli_epi32( b, 16 ), 16 ) );
+}
+
+
+__m128 select( const __m128 mask, const __m128 a, const __m128 b )
+{
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+
+__m128i select( const __m128i mask, const __m128i a, const __m128i b )
+{
+	return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+}
+
+
+/// @brief Same operations of encode_smallest_three on four quaternions
+template <uint32_t Center>
+__m128i encode_smallest_three( const Quat* q, __m128i codes[3] )
+{
+	__m128 w = _mm_loadu_ps( &q[0].w );
+	__m128 x = _mm_loadu_ps( &q[1].w );
+	__m128 y = _mm_loadu_ps( &q[2].w );
+	__m128 z = _mm_loadu_ps( &q[3].w );
+	_MM_TRANSPOSE4_PS( w, x, y, z );
+
+	const __m128 sign_bit = _mm_set1_ps( -0.0f );
+	__m128 largest = _mm_andnot_ps( sign_bit, w );
+	__m128 value = w;
+	__m128i index = _mm_setzero_si128();
+	const __m128 c[3] = { x, y, z };
+	for ( int32_t i = 1; i < 4; ++i )
+	{
+		const __m128 magnitude = _mm_andnot_ps( sign_bit, c[i - 1] );
+		const __m128 greater = _mm_cmpgt_ps( magnitude, largest );
+		largest = select( greater, magnitude, largest );
+		value = select( greater, c[i - 1], value );
+		index = select( _mm_castps_si128( greater ), _mm_set1_epi32( i ), index );
+	}
+
+	// The three others in order, the largest one being w, x, y, or z
+	const __m128 negate = _mm_and_ps( value, sign_bit );
+	const __m128 first = select( _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_setzero_si128() ) ), x, w );
+	const __m128 second = select( _mm_castsi128_ps( _mm_cmplt_epi32( index, _mm_set1_epi32( 2 ) ) ), y, x );
+	const __m128 third = select( _mm_castsi128_ps( _mm_cmplt_epi32( index, _mm_set1_epi32( 3 ) ) ), z, y );
+	const __m128 smallest[3] = { first, second, third };
+
+	const __m128 scale = _mm_set1_ps( SmallestThree<Center>::Scale );
+	const __m128 center = _mm_set1_ps( float( Center ) );
+	const __m128 max = _mm_set1_ps( float( 2 * Center ) );
+	for ( size_t i = 0; i < 3; ++i )
+	{
+		__m128 t = _mm_add_ps( _mm_mul_ps( _mm_xor_ps( smallest[i], negate ), scale ), center );
+		t = _mm_max_ps( _mm_min_ps( t, max ), _mm_setzero_ps() );
+		codes[i] = _mm_cvttps_epi32( _mm_add_ps( t, _mm_set1_ps( 0.5f ) ) );
+	}
+	return index;
+}
+
+
+/// @brief Same operations of decode_smallest_three on four quaternions
+template <uint32_t Center>
+void decode_smallest_three( const __m128i index, const __m128i codes[3], Quat* q )
+{
+	const __m128 step = _mm_set1_ps( SmallestThree<Center>::Step );
+	const __m128 center = _mm_set1_ps( float( Center ) );
+	const __m128 a = _mm_mul_ps( _mm_sub_ps( _mm_cvtepi32_ps( codes[0] ), center ), step );
+	const __m128 b = _mm_mul_ps( _mm_sub_ps( _mm_cvtepi32_ps( codes[1] ), center ), step );
+	const __m128 c = _mm_mul_ps( _mm_sub_ps( _mm_cvtepi32_ps( codes[2] ), center ), step );
+	const __m128 sum = _mm_add_ps( _mm_add_ps( _mm_mul_ps( a, a ), _mm_mul_ps( b, b ) ), _mm_mul_ps( c, c ) );
+	const __m128 largest = _mm_sqrt_ps( _mm_max_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), sum ), _mm_setzero_ps() ) );
+
+	const __m128 is_w = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_setzero_si128() ) );
+	const __m128 is_x = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 1 ) ) );
+	const __m128 is_y = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 2 ) ) );
+	const __m128 is_z = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 3 ) ) );
+	__m128 w = select( is_w, largest, a );
+	__m128 x = select( is_w, a, select( is_x, largest, b ) );
+	__m128 y = select( _mm_or_ps( is_w, is_x ), b, select( is_y, largest, c ) );
+	__m128 z = select( is_z, largest, c );
+
+	_MM_TRANSPOSE4_PS( w, x, y, z );
+	_mm_storeu_ps( &q[0].w, w );
+	_mm_storeu_ps( &q[1].w, x );
+	_mm_storeu_ps( &q[2].w, y );
+	_mm_storeu_ps( &q[3].w, z );
+}
+
+
+#endif  // SPOT_SSE2
+
+
+}  // namespace
+
+
+uint16_t to_half( const float f )
+{
+	const uint32_t sign = get_bits( f ) & 0x80000000;
+	const uint32_t u = get_bits( f ) ^ sign;
+
+	uint32_t h;
+	if ( u >= HalfOverflow )
+	{
+		// Infinity, or NaN with the top bits of its payload and the quiet bit
+		h = u > 0x7f800000 ? 0x7e00 | ( ( u >> 13 ) & 0x3ff ) : 0x7c00;
+	}
+	else if ( u < HalfMinNormal )
+	{
+		h = get_bits( from_bits( u ) + from_bits( HalfSubnormalMagic ) ) - HalfSubnormalMagic;
+	}
+	else
+	{
+		h = ( u + HalfNormalBias + ( ( u >> 13 ) & 1 ) ) >> 13;
+	}
+	return uint16_t( h | ( sign >> 16 ) );
+}
+
+
+float from_half( const uint16_t h )
+{
+	const uint32_t magnitude = h & 0x7fff;
+	uint32_t u = get_bits( from_bits( magnitude << 13 ) * from_bits( HalfExponentMagic ) );
+	if ( magnitude > 0x7bff )
+	{
+		u |= 0x7f800000;
+	}
+	if ( magnitude > 0x7c00 )
+	{
+		u |= 0x00400000;
+	}
+	return from_bits( u | uint32_t( h & 0x8000 ) << 16 );
+}
+
+
+HalfVec3::HalfVec3( const Vec3& v )
+: x { to_half( v.x ) }
+, y { to_half( v.y ) }
+, z { to_half( v.z ) }
+{
+}
+
+
+Vec3 HalfVec3::get_vec3() const
+{
+	return Vec3( from_half( x ), from_half( y ), from_half( z ) );
+}
+
+
+QuantizedVec3::QuantizedVec3( const Vec3& v, const Box& range )
+{
+	const Quantization q( range );
+	x = quantize( v.x, q.min[0], q.scale[0] );
+	y = quantize( v.y, q.min[1], q.scale[1] );
+	z = quantize( v.z, q.min[2], q.scale[2] );
+}
+
+
+Vec3 QuantizedVec3::get_vec3( const Box& range ) const
+{
+	const Quantization q( range );
+	return Vec3( dequantize( x, q.min[0], q.step[0] ), dequantize( y, q.min[1], q.step[1] ),
+		dequantize( z, q.min[2], q.step[2] ) );
+}
+
+
+PackedQuat48::PackedQuat48( const Quat& q )
+{
+	uint32_t codes[3];
+	const uint32_t index = encode_smallest_three<Center>( q, codes );
+	data[0] = uint16_t( codes[0] | ( index & 1 ) << Bits );
+	data[1] = uint16_t( codes[1] | ( index >> 1 ) << Bits );
+	data[2] = uint16_t( codes[2] );
+}
+
+
+Quat PackedQuat48::get_quat() const
+{
+	const uint32_t mask = ( 1 << Bits ) - 1;
+	const uint32_t index = uint32_t( data[0] >> Bits ) | uint32_t( data[1] >> Bits ) << 1;
+	const uint32_t codes[3] = { data[0] & mask, data[1] & mask, data[2] & mask };
+	return decode_smallest_three<Center>( index, codes );
+}
+
+
+PackedQuat32::PackedQuat32( const Quat& q )
+{
+	uint32_t codes[3];
+	const uint32_t index = encode_smallest_three<Center>( q, codes );
+	data = index << 3 * Bits | codes[0] << 2 * Bits | codes[1] << Bits | codes[2];
+}
+
+
+Quat PackedQuat32::get_quat() const
+{
+	const uint32_t mask = ( 1 << Bits ) - 1;
+	const uint32_t codes[3] = { ( data >> 2 * Bits ) & mask, ( data >> Bits ) & mask, data & mask };
+	return decode_smallest_three<Center>( data >> 3 * Bits, codes );
+}
+
+
+void pack( const Vec3* const in, HalfVec3* const out, const size_t count )
+{
+	// Components are converted one by one, so vectors are flat arrays of them
+	auto src = reinterpret_cast<const float*>( in );
+	auto dst = reinterpret_cast<uint16_t*>( out );
+	const size_t components = count * 3;
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i + 8 <= components; i += 8 )
+	{
+		const __m128i a = to_half( _mm_loadu_ps( src + i ) );
+		const __m128i b = to_half( _mm_loadu_ps( src + i + 4 ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), pack_low_16( a, b ) );
+	}
+#endif
+
+	for ( ; i < components; ++i )
+	{
+		dst[i] = to_half( src[i] );
+	}
+}
+
+
+void unpack( const HalfVec3* const in, Vec3* const out, const size_t count )
+{
+	auto src = reinterpret_cast<const uint16_t*>( in );
+	auto dst = reinterpret_cast<float*>( out );
+	const size_t components = count * 3;
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i + 8 <= components; i += 8 )
+	{
+		const __m128i h = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+		_mm_storeu_ps( dst + i, from_half( _mm_unpacklo_epi16( h, _mm_setzero_si128() ) ) );
+		_mm_storeu_ps( dst + i + 4, from_half( _mm_unpackhi_epi16( h, _mm_setzero_si128() ) ) );
+	}
+#endif
+
+	for ( ; i < components; ++i )
+	{
+		dst[i] = from_half( src[i] );
+	}
+}
+
+
+void pack( const Vec3* const in, const Box& range, QuantizedVec3* const out, const size_t count )
+{
+	const Quantization q( range );
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	// Four vectors are three registers, following the pattern xyzx yzxy zxyz
+	const __m128 min[3] = {
+		_mm_setr_ps( q.min[0], q.min[1], q.min[2], q.min[0] ),
+		_mm_setr_ps( q.min[1], q.min[2], q.min[0], q.min[1] ),
+		_mm_setr_ps( q.min[2], q.min[0], q.min[1], q.min[2] ),
+	};
+	const __m128 scale[3] = {
+		_mm_setr_ps( q.scale[0], q.scale[1], q.scale[2], q.scale[0] ),
+		_mm_setr_ps( q.scale[1], q.scale[2], q.scale[0], q.scale[1] ),
+		_mm_setr_ps( q.scale[2], q.scale[0], q.scale[1], q.scale[2] ),
+	};
+	const __m128 max = _mm_set1_ps( float( QuantizedVec3::Max ) );
+
+	auto src = reinterpret_cast<const float*>( in );
+	auto dst = reinterpret_cast<uint16_t*>( out );
+	for ( ; i + 4 <= count; i += 4, src += 12, dst += 12 )
+	{
+		__m128i codes[3];
+		for ( size_t j = 0; j < 3; ++j )
+		{
+			__m128 t = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( src + 4 * j ), min[j] ), scale[j] );
+			t = _mm_max_ps( _mm_min_ps( t, max ), _mm_setzero_ps() );
+			codes[j] = _mm_cvttps_epi32( _mm_add_ps( t, _mm_set1_ps( 0.5f ) ) );
+		}
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), pack_low_16( codes[0], codes[1] ) );
+		_mm_storel_epi64( reinterpret_cast<__m128i*>( dst + 8 ), pack_low_16( codes[2], codes[2] ) );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i].x = quantize( in[i].x, q.min[0], q.scale[0] );
+		out[i].y = quantize( in[i].y, q.min[1], q.scale[1] );
+		out[i].z = quantize( in[i].z, q.min[2], q.scale[2] );
+	}
+}
+
+
+void unpack( const QuantizedVec3* const in, const Box& range, Vec3* const out, const size_t count )
+{
+	const Quantization q( range );
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	const __m128 min[3] = {
+		_mm_setr_ps( q.min[0], q.min[1], q.min[2], q.min[0] ),
+		_mm_setr_ps( q.min[1], q.min[2], q.min[0], q.min[1] ),
+		_mm_setr_ps( q.min[2], q.min[0], q.min[1], q.min[2] ),
+	};
+	const __m128 step[3] = {
+		_mm_setr_ps( q.step[0], q.step[1], q.step[2], q.step[0] ),
+		_mm_setr_ps( q.step[1], q.step[2], q.step[0], q.step[1] ),
+		_mm_setr_ps( q.step[2], q.step[0], q.step[1], q.step[2] ),
+	};
+
+	auto src = reinterpret_cast<const uint16_t*>( in );
+	auto dst = reinterpret_cast<float*>( out );
+	for ( ; i + 4 <= count; i += 4, src += 12, dst += 12 )
+	{
+		const __m128i ab = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+		const __m128i c = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( src + 8 ) );
+		const __m128i codes[3] = {
+			_mm_unpacklo_epi16( ab, _mm_setzero_si128() ),
+			_mm_unpackhi_epi16( ab, _mm_setzero_si128() ),
+			_mm_unpacklo_epi16( c, _mm_setzero_si128() ),
+		};
+		for ( size_t j = 0; j < 3; ++j )
+		{
+			_mm_storeu_ps( dst + 4 * j, _mm_add_ps( min[j], _mm_mul_ps( _mm_cvtepi32_ps( codes[j] ), step[j] ) ) );
+		}
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = Vec3( dequantize( in[i].x, q.min[0], q.step[0] ), dequantize( in[i].y, q.min[1], q.step[1] ),
+			dequantize( in[i].z, q.min[2], q.step[2] ) );
+	}
+}
+
+
+void pack( const Quat* const in, PackedQuat48* const out, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	constexpr uint32_t Bits = PackedQuat48::Bits;
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128i codes[3];
+		const __m128i index = encode_smallest_three<PackedQuat48::Center>( in + i, codes );
+		const __m128i words[3] = {
+			_mm_or_si128( codes[0], _mm_slli_epi32( _mm_and_si128( index, _mm_set1_epi32( 1 ) ), Bits ) ),
+			_mm_or_si128( codes[1], _mm_slli_epi32( _mm_srli_epi32( index, 1 ), Bits ) ),
+			codes[2],
+		};
+
+		// Interleaved as the three words of each quaternion
+		alignas( 16 ) uint32_t lanes[3][4];
+		for ( size_t j = 0; j < 3; ++j )
+		{
+			_mm_store_si128( reinterpret_cast<__m128i*>( lanes[j] ), words[j] );
+		}
+		for ( size_t k = 0; k < 4; ++k )
+		{
+			for ( size_t j = 0; j < 3; ++j )
+			{
+				out[i + k].data[j] = uint16_t( lanes[j][k] );
+			}
+		}
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = PackedQuat48( in[i] );
+	}
+}
+
+
+void unpack( const PackedQuat48* const in, Quat* const out, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	constexpr uint32_t Bits = PackedQuat48::Bits;
+	const __m128i mask = _mm_set1_epi32( ( 1 << Bits ) - 1 );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		const PackedQuat48* p = in + i;
+		const __m128i words[3] = {
+			_mm_setr_epi32( p[0].data[0], p[1].data[0], p[2].data[0], p[3].data[0] ),
+			_mm_setr_epi32( p[0].data[1], p[1].data[1], p[2].data[1], p[3].data[1] ),
+			_mm_setr_epi32( p[0].data[2], p[1].data[2], p[2].data[2], p[3].data[2] ),
+		};
+		const __m128i index = _mm_or_si128( _mm_srli_epi32( words[0], Bits ), _mm_slli_epi32( _mm_srli_epi32( words[1], Bits ), 1 ) );
+		const __m128i codes[3] = {
+			_mm_and_si128( words[0], mask ),
+			_mm_and_si128( words[1], mask ),
+			_mm_and_si128( words[2], mask ),
+		};
+		decode_smallest_three<PackedQuat48::Center>( index, codes, out + i );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = in[i].get_quat();
+	}
+}
+
+
+void pack( const Quat* const in, PackedQuat32* const out, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	constexpr uint32_t Bits = PackedQuat32::Bits;
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128i codes[3];
+		const __m128i index = encode_smallest_three<PackedQuat32::Center>( in + i, codes );
+		const __m128i data = _mm_or_si128(
+			_mm_or_si128( _mm_slli_epi32( index, 3 * Bits ), _mm_slli_epi32( codes[0], 2 * Bits ) ),
+			_mm_or_si128( _mm_slli_epi32( codes[1], Bits ), codes[2] ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( &out[i].data ), data );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = PackedQuat32( in[i] );
+	}
+}
+
+
+void unpack( const PackedQuat32* const in, Quat* const out, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	constexpr uint32_t Bits = PackedQuat32::Bits;
+	const __m128i mask = _mm_set1_epi32( ( 1 << Bits ) - 1 );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		const __m128i data = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &in[i].data ) );
+		const __m128i codes[3] = {
+			_mm_and_si128( _mm_srli_epi32( data, 2 * Bits ), mask ),
+			_mm_and_si128( _mm_srli_epi32( data, Bits ), mask ),
+			_mm_and_si128( data, mask ),
+		};
+		decode_smallest_three<PackedQuat32::Center>( _mm_srli_epi32( data, 3 * Bits ), codes, out + i );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = in[i].get_quat();
+	}
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,300 @@
+#include "spot/math/ray.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "spot/math/simd.h"
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+float intersect_box( const Vec3& origin, const Vec3& inv, const Box& box, const float max_distance )
+{
+	const float x0 = ( box.a.x - origin.x ) * inv.x;
+	const float x1 = ( box.b.x - origin.x ) * inv.x;
+	const float y0 = ( box.a.y - origin.y ) * inv.y;
+	const float y1 = ( box.b.y - origin.y ) * inv.y;
+	const float z0 = ( box.a.z - origin.z ) * inv.z;
+	const float z1 = ( box.b.z - origin.z ) * inv.z;
+
+	const float enter = std::max( std::max( std::min( x0, x1 ), std::min( y0, y1 ) ), std::max( std::min( z0, z1 ), 0.0f ) );
+	const float leave = std::min( std::min( std::max( x0, x1 ), std::max( y0, y1 ) ), std::min( std::max( z0, z1 ), max_distance ) );
+	return enter <= leave ? enter : Ray::Miss;
+}
+
+
+/// @brief Finds the half chord from the point of the ray closest to the center,
+/// which is more accurate than solving the quadratic for far away spheres
+float intersect_sphere( const Vec3& origin, const Vec3& d, const Sphere& sphere, const float max_distance )
+{
+	const float ox = origin.x - sphere.o.x;
+	const float oy = origin.y - sphere.o.y;
+	const float oz = origin.z - sphere.o.z;
+
+	// Distance of the closest point
+	const float a = d.x * d.x + d.y * d.y + d.z * d.z;
+	const float k = ( ox * d.x + oy * d.y + oz * d.z ) / a;
+
+	// Offset of the closest point from the center
+	const float lx = ox - d.x * k;
+	const float ly = oy - d.y * k;
+	const float lz = oz - d.z * k;
+
+	// Negative when the ray misses, making h and then enter NaN
+	const float h2 = sphere.r * sphere.r - ( lx * lx + ly * ly + lz * lz );
+	const float h  = std::sqrt( h2 / a );
+
+	const float enter = std::max( -k - h, 0.0f );
+	const float leave = std::min( h - k, max_distance );
+	return enter <= leave ? enter : Ray::Miss;
+}
+
+
+#ifdef SPOT_SSE2
+
+// Vector min and max return their second operand for NaN, where std::min and std::max
+// return their first one, so operands are swapped to give the same results
+
+template <size_t N>
+void intersect_box_sse2( const RayPacket<N>& p, const size_t lane, const Box& box, float* out )
+{
+	const __m128 ox = _mm_load_ps( p.origin[0] + lane );
+	const __m128 oy = _mm_load_ps( p.origin[1] + lane );
+	const __m128 oz = _mm_load_ps( p.origin[2] + lane );
+	const __m128 ix = _mm_load_ps( p.inv_direction[0] + lane );
+	const __m128 iy = _mm_load_ps( p.inv_direction[1] + lane );
+	const __m128 iz = _mm_load_ps( p.inv_direction[2] + lane );
+
+	const __m128 x0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.a.x ), ox ), ix );
+	const __m128 x1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.b.x ), ox ), ix );
+	const __m128 y0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.a.y ), oy ), iy );
+	const __m128 y1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.b.y ), oy ), iy );
+	const __m128 z0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.a.z ), oz ), iz );
+	const __m128 z1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( box.b.z ), oz ), iz );
+
+	const __m128 enter = _mm_max_ps(
+		_mm_max_ps( _mm_setzero_ps(), _mm_min_ps( z1, z0 ) ),
+		_mm_max_ps( _mm_min_ps( y1, y0 ), _mm_min_ps( x1, x0 ) ) );
+	const __m128 leave = _mm_min_ps(
+		_mm_min_ps( _mm_load_ps( p.max_distance + lane ), _mm_max_ps( z1, z0 ) ),
+		_mm_min_ps( _mm_max_ps( y1, y0 ), _mm_max_ps( x1, x0 ) ) );
+
+	const __m128 hit = _mm_cmple_ps( enter, leave );
+	_mm_storeu_ps( out, _mm_or_ps( _mm_and_ps( hit, enter ), _mm_andnot_ps( hit, _mm_set1_ps( Ray::Miss ) ) ) );
+}
+
+
+template <size_t N>
+void intersect_sphere_sse2( const RayPacket<N>& p, const size_t lane, const Sphere& sphere, float* out )
+{
+	const __m128 dx = _mm_load_ps( p.direction[0] + lane );
+	const __m128 dy = _mm_load_ps( p.direction[1] + lane );
+	const __m128 dz = _mm_load_ps( p.direction[2] + lane );
+	const __m128 ox = _mm_sub_ps( _mm_load_ps( p.origin[0] + lane ), _mm_set1_ps( sphere.o.x ) );
+	const __m128 oy = _mm_sub_ps( _mm_load_ps( p.origin[1] + lane ), _mm_set1_ps( sphere.o.y ) );
+	const __m128 oz = _mm_sub_ps( _mm_load_ps( p.origin[2] + lane ), _mm_set1_ps( sphere.o.z ) );
+
+	const __m128 a = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+	const __m128 b = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ox, dx ), _mm_mul_ps( oy, dy ) ), _mm_mul_ps( oz, dz ) );
+	const __m128 k = _mm_div_ps( b, a );
+
+	const __m128 lx = _mm_sub_ps( ox, _mm_mul_ps( dx, k ) );
+	const __m128 ly = _mm_sub_ps( oy, _mm_mul_ps( dy, k ) );
+	const __m128 lz = _mm_sub_ps( oz, _mm_mul_ps( dz, k ) );
+
+	const __m128 l2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( lx, lx ), _mm_mul_ps( ly, ly ) ), _mm_mul_ps( lz, lz ) );
+	const __m128 h2 = _mm_sub_ps( _mm_set1_ps( sphere.r * sphere.r ), l2 );
+	const __m128 h  = _mm_sqrt_ps( _mm_div_ps( h2, a ) );
+
+	const __m128 negative_k = _mm_xor_ps( k, _mm_set1_ps( -0.0f ) );
+	const __m128 enter      = _mm_max_ps( _mm_setzero_ps(), _mm_sub_ps( negative_k, h ) );
+	const __m128 leave      = _mm_min_ps( _mm_load_ps( p.max_distance + lane ), _mm_sub_ps( h, k ) );
+
+	const __m128 hit = _mm_cmple_ps( enter, leave );
+	_mm_storeu_ps( out, _mm_or_ps( _mm_and_ps( hit, enter ), _mm_andnot_ps( hit, _mm_set1_ps( Ray::Miss ) ) ) );
+}
+
+
+SPOT_TARGET( "avx" )
+void intersect_box_avx( const RayPacket<8>& p, const Box& box, float* out )
+{
+	const __m256 ox = _mm256_load_ps( p.origin[0] );
+	const __m256 oy = _mm256_load_ps( p.origin[1] );
+	const __m256 oz = _mm256_load_ps( p.origin[2] );
+	const __m256 ix = _mm256_load_ps( p.inv_direction[0] );
+	const __m256 iy = _mm256_load_ps( p.inv_direction[1] );
+	const __m256 iz = _mm256_load_ps( p.inv_direction[2] );
+
+	const __m256 x0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( box.a.x ), ox ), ix );
+	const __m256 x1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( box.b.x ), ox ), ix );
+	const __m256 y0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( box.a.y ), oy ), iy );
+	const __m256 y1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( box.b.y ), oy ), iy );
+	const __m256 z0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( box.a.z ), oz ), iz );
+	const __m256 z1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( box.b.z ), oz ), iz );
+
+	const __m256 enter = _mm256_max_ps(
+		_mm256_max_ps( _mm256_setzero_ps(), _mm256_min_ps( z1, z0 ) ),
+		_mm256_max_ps( _mm256_min_ps( y1, y0 ), _mm256_min_ps( x1, x0 ) ) );
+	const __m256 leave = _mm256_min_ps(
+		_mm256_min_ps( _mm256_load_ps( p.max_distance ), _mm256_max_ps( z1, z0 ) ),
+		_mm256_min_ps( _mm256_max_ps( y1, y0 ), _mm256_max_ps( x1, x0 ) ) );
+
+	const __m256 hit = _mm256_cmp_ps( enter, leave, _CMP_LE_OQ );
+	_mm256_storeu_ps( out, _mm256_blendv_ps( _mm256_set1_ps( Ray::Miss ), enter, hit ) );
+}
+
+
+SPOT_TARGET( "avx" )
+void intersect_sphere_avx( const RayPacket<8>& p, const Sphere& sphere, float* out )
+{
+	const __m256 dx = _mm256_load_ps( p.direction[0] );
+	const __m256 dy = _mm256_load_ps( p.direction[1] );
+	const __m256 dz = _mm256_load_ps( p.direction[2] );
+	const __m256 ox = _mm256_sub_ps( _mm256_load_ps( p.origin[0] ), _mm256_set1_ps( sphere.o.x ) );
+	const __m256 oy = _mm256_sub_ps( _mm256_load_ps( p.origin[1] ), _mm256_set1_ps( sphere.o.y ) );
+	const __m256 oz = _mm256_sub_ps( _mm256_load_ps( p.origin[2] ), _mm256_set1_ps( sphere.o.z ) );
+
+	const __m256 a = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( dx, dx ), _mm256_mul_ps( dy, dy ) ), _mm256_mul_ps( dz, dz ) );
+	const __m256 b = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( ox, dx ), _mm256_mul_ps( oy, dy ) ), _mm256_mul_ps( oz, dz ) );
+	const __m256 k = _mm256_div_ps( b, a );
+
+	const __m256 lx = _mm256_sub_ps( ox, _mm256_mul_ps( dx, k ) );
+	const __m256 ly = _mm256_sub_ps( oy, _mm256_mul_ps( dy, k ) );
+	const __m256 lz = _mm256_sub_ps( oz, _mm256_mul_ps( dz, k ) );
+
+	const __m256 l2 = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( lx, lx ), _mm256_mul_ps( ly, ly ) ), _mm256_mul_ps( lz, lz ) );
+	const __m256 h2 = _mm256_sub_ps( _mm256_set1_ps( sphere.r * sphere.r ), l2 );
+	const __m256 h  = _mm256_sqrt_ps( _mm256_div_ps( h2, a ) );
+
+	const __m256 negative_k = _mm256_xor_ps( k, _mm256_set1_ps( -0.0f ) );
+	const __m256 enter      = _mm256_max_ps( _mm256_setzero_ps(), _mm256_sub_ps( negative_k, h ) );
+	const __m256 leave      = _mm256_min_ps( _mm256_load_ps( p.max_distance ), _mm256_sub_ps( h, k ) );
+
+	const __m256 hit = _mm256_cmp_ps( enter, leave, _CMP_LE_OQ );
+	_mm256_storeu_ps( out, _mm256_blendv_ps( _mm256_set1_ps( Ray::Miss ), enter, hit ) );
+}
+
+
+bool has_avx()
+{
+	static const bool avx = get_simd_support() >= Simd::Avx;
+	return avx;
+}
+
+#endif  // SPOT_SSE2
+
+
+template <size_t N>
+Vec3 get_lane( const float ( &v )[3][N], const size_t lane )
+{
+	return { v[0][lane], v[1][lane], v[2][lane] };
+}
+
+
+}  // namespace
+
+
+Ray::Ray( const Vec3& o, const Vec3& d )
+: origin { o }
+, direction { d }
+, inv_direction { 1.0f / d.x, 1.0f / d.y, 1.0f / d.z }
+{}
+
+
+Vec3 Ray::get_point( const float distance ) const
+{
+	return origin + direction * distance;
+}
+
+
+float Ray::intersect( const Box& box, const float max_distance ) const
+{
+	return intersect_box( origin, inv_direction, box, max_distance );
+}
+
+
+float Ray::intersect( const Sphere& sphere, const float max_distance ) const
+{
+	return intersect_sphere( origin, direction, sphere, max_distance );
+}
+
+
+template <size_t N>
+RayPacket<N>::RayPacket( const Ray* rays )
+{
+	for ( size_t i = 0; i < N; ++i )
+	{
+		for ( size_t axis = 0; axis < 3; ++axis )
+		{
+			origin[axis][i]        = ( &rays[i].origin.x )[axis];
+			direction[axis][i]     = ( &rays[i].direction.x )[axis];
+			inv_direction[axis][i] = ( &rays[i].inv_direction.x )[axis];
+		}
+		max_distance[i] = Ray::Miss;
+	}
+}
+
+
+template <size_t N>
+void RayPacket<N>::intersect( const Box& box, float* distances ) const
+{
+#ifdef SPOT_SSE2
+	if constexpr ( N == 8 )
+	{
+		if ( has_avx() )
+		{
+			intersect_box_avx( *this, box, distances );
+			return;
+		}
+	}
+	for ( size_t lane = 0; lane < N; lane += 4 )
+	{
+		intersect_box_sse2( *this, lane, box, distances + lane );
+	}
+#else
+	for ( size_t lane = 0; lane < N; ++lane )
+	{
+		distances[lane] = intersect_box( get_lane( origin, lane ), get_lane( inv_direction, lane ), box, max_distance[lane] );
+	}
+#endif
+}
+
+
+template <size_t N>
+void RayPacket<N>::intersect( const Sphere& sphere, float* distances ) const
+{
+#ifdef SPOT_SSE2
+	if constexpr ( N == 8 )
+	{
+		if ( has_avx() )
+		{
+			intersect_sphere_avx( *this, sphere, distances );
+			return;
+		}
+	}
+	for ( size_t lane = 0; lane < N; lane += 4 )
+	{
+		intersect_sphere_sse2( *this, lane, sphere, distances + lane );
+	}
+#else
+	for ( size_t lane = 0; lane < N; ++lane )
+	{
+		distances[lane] = intersect_sphere( get_lane( origin, lane ), get_lane( direction, lane ), sphere, max_distance[lane] );
+	}
+#endif
+}
+
+
+template struct RayPacket<4>;
+template struct RayPacket<8>;
+
+
+}  // namespace spot::math
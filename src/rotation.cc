@@ -0,0 +1,140 @@
+#include "spot/math/rotation.h"
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+#ifdef SPOT_SSE2
+
+namespace
+{
+
+
+/// @brief Loads four quaternions as one register for each of w, x, y, z
+void load_quats( const Quat* q, __m128& w, __m128& x, __m128& y, __m128& z )
+{
+	w = _mm_loadu_ps( &q[0].w );
+	x = _mm_loadu_ps( &q[1].w );
+	y = _mm_loadu_ps( &q[2].w );
+	z = _mm_loadu_ps( &q[3].w );
+	_MM_TRANSPOSE4_PS( w, x, y, z );
+}
+
+
+/// @brief Inverse of load_quats
+void store_quats( Quat* q, __m128 w, __m128 x, __m128 y, __m128 z )
+{
+	_MM_TRANSPOSE4_PS( w, x, y, z );
+	_mm_storeu_ps( &q[0].w, w );
+	_mm_storeu_ps( &q[1].w, x );
+	_mm_storeu_ps( &q[2].w, y );
+	_mm_storeu_ps( &q[3].w, z );
+}
+
+
+}  // namespace
+
+#endif  // SPOT_SSE2
+
+
+void rotate( const Quat* const q, const Vec3* const in, Vec3* const out, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	// Same operations of rotate( q, v ), four at a time
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 qw, qx, qy, qz;
+		load_quats( q + i, qw, qx, qy, qz );
+
+		__m128 vx, vy, vz;
+		load_soa( &in[i].x, vx, vy, vz );
+
+		__m128 tx = _mm_sub_ps( _mm_mul_ps( qy, vz ), _mm_mul_ps( qz, vy ) );
+		__m128 ty = _mm_sub_ps( _mm_mul_ps( qz, vx ), _mm_mul_ps( qx, vz ) );
+		__m128 tz = _mm_sub_ps( _mm_mul_ps( qx, vy ), _mm_mul_ps( qy, vx ) );
+		tx = _mm_add_ps( tx, tx );
+		ty = _mm_add_ps( ty, ty );
+		tz = _mm_add_ps( tz, tz );
+
+		const __m128 rx = _mm_add_ps( _mm_add_ps( vx, _mm_mul_ps( qw, tx ) ),
+			_mm_sub_ps( _mm_mul_ps( qy, tz ), _mm_mul_ps( qz, ty ) ) );
+		const __m128 ry = _mm_add_ps( _mm_add_ps( vy, _mm_mul_ps( qw, ty ) ),
+			_mm_sub_ps( _mm_mul_ps( qz, tx ), _mm_mul_ps( qx, tz ) ) );
+		const __m128 rz = _mm_add_ps( _mm_add_ps( vz, _mm_mul_ps( qw, tz ) ),
+			_mm_sub_ps( _mm_mul_ps( qx, ty ), _mm_mul_ps( qy, tx ) ) );
+
+		store_aos( &out[i].x, rx, ry, rz );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = rotate( q[i], in[i] );
+	}
+}
+
+
+void compose( const Quat* const a, const Quat* const b, Quat* const out, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 aw, ax, ay, az;
+		load_quats( a + i, aw, ax, ay, az );
+		__m128 bw, bx, by, bz;
+		load_quats( b + i, bw, bx, by, bz );
+
+		const __m128 w = _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( _mm_mul_ps( aw, bw ), _mm_mul_ps( ax, bx ) ),
+			_mm_mul_ps( ay, by ) ), _mm_mul_ps( az, bz ) );
+		const __m128 x = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( aw, bx ), _mm_mul_ps( ax, bw ) ),
+			_mm_mul_ps( ay, bz ) ), _mm_mul_ps( az, by ) );
+		const __m128 y = _mm_add_ps( _mm_add_ps( _mm_sub_ps( _mm_mul_ps( aw, by ), _mm_mul_ps( ax, bz ) ),
+			_mm_mul_ps( ay, bw ) ), _mm_mul_ps( az, bx ) );
+		const __m128 z = _mm_add_ps( _mm_sub_ps( _mm_add_ps( _mm_mul_ps( aw, bz ), _mm_mul_ps( ax, by ) ),
+			_mm_mul_ps( ay, bx ) ), _mm_mul_ps( az, bw ) );
+
+		store_quats( out + i, w, x, y, z );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = compose( a[i], b[i] );
+	}
+}
+
+
+void renormalize( Quat* const q, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 w, x, y, z;
+		load_quats( q + i, w, x, y, z );
+
+		const __m128 d = _mm_add_ps(
+			_mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) ),
+			_mm_mul_ps( w, w ) );
+		const __m128 k = _mm_sub_ps( _mm_set1_ps( 1.5f ), _mm_mul_ps( _mm_set1_ps( 0.5f ), d ) );
+
+		store_quats( q + i, _mm_mul_ps( w, k ), _mm_mul_ps( x, k ), _mm_mul_ps( y, k ), _mm_mul_ps( z, k ) );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		q[i].renormalize();
+	}
+}
+
+
+}  // namespace spot::math
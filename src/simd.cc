@@ -0,0 +1,124 @@
+#include "spot/math/simd.h"
+
+#include <cstdint>
+
+#include "intrinsics.h"
+
+#if defined( SPOT_X86 )
+#if defined( _MSC_VER ) && !defined( __clang__ )
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+
+namespace spot::math
+{
+
+
+#if defined( SPOT_X86 )
+
+
+namespace
+{
+
+
+/// @return Whether the leaf is available, in which case regs are eax, ebx, ecx, edx
+bool cpuid( const unsigned leaf, unsigned regs[4] )
+{
+#if defined( _MSC_VER ) && !defined( __clang__ )
+	int info[4];
+	__cpuid( info, 0 );
+	if ( static_cast<unsigned>( info[0] ) < leaf )
+	{
+		return false;
+	}
+	__cpuidex( info, leaf, 0 );
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		regs[i] = static_cast<unsigned>( info[i] );
+	}
+	return true;
+#else
+	if ( __get_cpuid_max( 0, nullptr ) < leaf )
+	{
+		return false;
+	}
+	__cpuid_count( leaf, 0, regs[0], regs[1], regs[2], regs[3] );
+	return true;
+#endif
+}
+
+
+/// @return The extended control register telling which register states the OS saves
+uint64_t xgetbv()
+{
+#if defined( _MSC_VER ) && !defined( __clang__ )
+	return _xgetbv( 0 );
+#else
+	uint32_t lo;
+	uint32_t hi;
+	__asm__ __volatile__( "xgetbv" : "=a"( lo ), "=d"( hi ) : "c"( 0 ) );
+	return ( uint64_t( hi ) << 32 ) | lo;
+#endif
+}
+
+
+Simd detect_simd_support()
+{
+	unsigned regs[4] = {};
+	if ( !cpuid( 1, regs ) )
+	{
+		return Simd::Scalar;
+	}
+
+	const bool sse2    = regs[3] & ( 1u << 26 );
+	const bool fma     = regs[2] & ( 1u << 12 );
+	const bool osxsave = regs[2] & ( 1u << 27 );
+	const bool avx     = regs[2] & ( 1u << 28 );
+
+	if ( !sse2 )
+	{
+		return Simd::Scalar;
+	}
+
+	// The OS has to save the upper halves of YMM registers on context switches
+	if ( !avx || !osxsave || ( xgetbv() & 0x6 ) != 0x6 )
+	{
+		return Simd::Sse2;
+	}
+
+	const bool avx2 = cpuid( 7, regs ) && ( regs[1] & ( 1u << 5 ) );
+	if ( !avx2 || !fma )
+	{
+		return Simd::Avx;
+	}
+
+	return Simd::Avx2;
+}
+
+
+}  // namespace
+
+
+Simd get_simd_support()
+{
+	static const Simd support = detect_simd_support();
+	return support;
+}
+
+
+#else
+
+
+Simd get_simd_support()
+{
+	return Simd::Scalar;
+}
+
+
+#endif
+
+
+}  // namespace spot::math
@@ -0,0 +1,260 @@
+#include "spot/math/skinning.h"
+
+#include <cassert>
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+/// @brief Skins vertices from begin to the end of the arrays with the scalar functions
+template <bool Normals>
+void skin_scalar( const DualQuat*       palette,
+                  const BoneInfluences* influences,
+                  const Vec3Soa&        positions,
+                  const Vec3Soa&        normals,
+                  Vec3Soa&              out_positions,
+                  Vec3Soa&              out_normals,
+                  size_t                begin )
+{
+	for ( size_t i = begin; i < positions.size(); ++i )
+	{
+		const auto& influence = influences[i];
+		DualQuat    dqs[BoneInfluences::Count];
+		for ( size_t j = 0; j < BoneInfluences::Count; ++j )
+		{
+			dqs[j] = palette[influence.bones[j]];
+		}
+		const auto dq = blend( dqs, influence.weights, BoneInfluences::Count );
+
+		out_positions.set( i, dq * positions[i] );
+		if constexpr ( Normals )
+		{
+			out_normals.set( i, dq.transform_vector( normals[i] ) );
+		}
+	}
+}
+
+
+#ifdef SPOT_SSE2
+
+/// @brief Four quaternions, one register for each component
+struct Quat4
+{
+	__m128 w = _mm_setzero_ps();
+	__m128 x = _mm_setzero_ps();
+	__m128 y = _mm_setzero_ps();
+	__m128 z = _mm_setzero_ps();
+};
+
+
+Quat4 load( const Quat& a, const Quat& b, const Quat& c, const Quat& d )
+{
+	Quat4 q = { _mm_loadu_ps( &a.w ), _mm_loadu_ps( &b.w ), _mm_loadu_ps( &c.w ), _mm_loadu_ps( &d.w ) };
+	_MM_TRANSPOSE4_PS( q.w, q.x, q.y, q.z );
+	return q;
+}
+
+
+__m128 dot( const Quat4& a, const Quat4& b )
+{
+	return _mm_add_ps(
+		_mm_add_ps( _mm_add_ps( _mm_mul_ps( a.x, b.x ), _mm_mul_ps( a.y, b.y ) ), _mm_mul_ps( a.z, b.z ) ),
+		_mm_mul_ps( a.w, b.w ) );
+}
+
+
+/// @brief Adds k * q to sum
+void accumulate( Quat4& sum, const __m128 k, const Quat4& q )
+{
+	sum.w = _mm_add_ps( sum.w, _mm_mul_ps( k, q.w ) );
+	sum.x = _mm_add_ps( sum.x, _mm_mul_ps( k, q.x ) );
+	sum.y = _mm_add_ps( sum.y, _mm_mul_ps( k, q.y ) );
+	sum.z = _mm_add_ps( sum.z, _mm_mul_ps( k, q.z ) );
+}
+
+
+/// @return Components of a where mask is set, of b elsewhere
+Quat4 select( const __m128 mask, const Quat4& a, const Quat4& b )
+{
+	return {
+		_mm_or_ps( _mm_and_ps( mask, a.w ), _mm_andnot_ps( mask, b.w ) ),
+		_mm_or_ps( _mm_and_ps( mask, a.x ), _mm_andnot_ps( mask, b.x ) ),
+		_mm_or_ps( _mm_and_ps( mask, a.y ), _mm_andnot_ps( mask, b.y ) ),
+		_mm_or_ps( _mm_and_ps( mask, a.z ), _mm_andnot_ps( mask, b.z ) ),
+	};
+}
+
+
+void scale( Quat4& q, const __m128 k )
+{
+	q.w = _mm_mul_ps( k, q.w );
+	q.x = _mm_mul_ps( k, q.x );
+	q.y = _mm_mul_ps( k, q.y );
+	q.z = _mm_mul_ps( k, q.z );
+}
+
+
+/// @brief Same operations of rotate( q, v )
+void rotate( const Quat4& q, const __m128 vx, const __m128 vy, const __m128 vz, __m128& rx, __m128& ry, __m128& rz )
+{
+	__m128 tx = _mm_sub_ps( _mm_mul_ps( q.y, vz ), _mm_mul_ps( q.z, vy ) );
+	__m128 ty = _mm_sub_ps( _mm_mul_ps( q.z, vx ), _mm_mul_ps( q.x, vz ) );
+	__m128 tz = _mm_sub_ps( _mm_mul_ps( q.x, vy ), _mm_mul_ps( q.y, vx ) );
+	tx = _mm_add_ps( tx, tx );
+	ty = _mm_add_ps( ty, ty );
+	tz = _mm_add_ps( tz, tz );
+
+	rx = _mm_add_ps( _mm_add_ps( vx, _mm_mul_ps( q.w, tx ) ), _mm_sub_ps( _mm_mul_ps( q.y, tz ), _mm_mul_ps( q.z, ty ) ) );
+	ry = _mm_add_ps( _mm_add_ps( vy, _mm_mul_ps( q.w, ty ) ), _mm_sub_ps( _mm_mul_ps( q.z, tx ), _mm_mul_ps( q.x, tz ) ) );
+	rz = _mm_add_ps( _mm_add_ps( vz, _mm_mul_ps( q.w, tz ) ), _mm_sub_ps( _mm_mul_ps( q.x, ty ), _mm_mul_ps( q.y, tx ) ) );
+}
+
+
+/// @brief Skins four vertices at a time with the same operations of skin_scalar
+/// @return The first vertex left to skin
+template <bool Normals>
+size_t skin_sse2( const DualQuat*       palette,
+                  const BoneInfluences* influences,
+                  const Vec3Soa&        positions,
+                  const Vec3Soa&        normals,
+                  Vec3Soa&              out_positions,
+                  Vec3Soa&              out_normals )
+{
+	const __m128 sign_bit = _mm_set1_ps( -0.0f );
+
+	size_t i = 0;
+	for ( ; i + 4 <= positions.size(); i += 4 )
+	{
+		const BoneInfluences* v = influences + i;
+
+		// Rows become the weights of each influence of the four vertices
+		__m128 weights[BoneInfluences::Count] = {
+			_mm_loadu_ps( v[0].weights ),
+			_mm_loadu_ps( v[1].weights ),
+			_mm_loadu_ps( v[2].weights ),
+			_mm_loadu_ps( v[3].weights ),
+		};
+		_MM_TRANSPOSE4_PS( weights[0], weights[1], weights[2], weights[3] );
+
+		// Real parts of each influence, and the heaviest one of every vertex as in blend
+		Quat4  reals[BoneInfluences::Count];
+		Quat4  pivot;
+		__m128 heaviest = weights[0];
+		for ( size_t j = 0; j < BoneInfluences::Count; ++j )
+		{
+			reals[j] = load( palette[v[0].bones[j]].real,
+				palette[v[1].bones[j]].real,
+				palette[v[2].bones[j]].real,
+				palette[v[3].bones[j]].real );
+			if ( j == 0 )
+			{
+				pivot = reals[0];
+				continue;
+			}
+			const __m128 heavier = _mm_cmpgt_ps( weights[j], heaviest );
+			pivot                = select( heavier, reals[j], pivot );
+			heaviest             = _mm_or_ps( _mm_and_ps( heavier, weights[j] ), _mm_andnot_ps( heavier, heaviest ) );
+		}
+
+		Quat4 real;
+		Quat4 dual;
+		for ( size_t j = 0; j < BoneInfluences::Count; ++j )
+		{
+			// Negative weights move a real part to the hemisphere of the pivot
+			const __m128 flip = _mm_and_ps( _mm_cmplt_ps( dot( reals[j], pivot ), _mm_setzero_ps() ), sign_bit );
+			const __m128 w    = _mm_xor_ps( weights[j], flip );
+			accumulate( real, w, reals[j] );
+			accumulate( dual,
+				w,
+				load( palette[v[0].bones[j]].dual,
+					palette[v[1].bones[j]].dual,
+					palette[v[2].bones[j]].dual,
+					palette[v[3].bones[j]].dual ) );
+		}
+
+		const __m128 k = rsqrt( dot( real, real ) );
+		scale( real, k );
+		scale( dual, k );
+
+		// Translation as in DualQuat::get_translation
+		__m128 tx = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.w, dual.x ), _mm_mul_ps( dual.w, real.x ) ),
+			_mm_sub_ps( _mm_mul_ps( real.y, dual.z ), _mm_mul_ps( real.z, dual.y ) ) );
+		__m128 ty = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.w, dual.y ), _mm_mul_ps( dual.w, real.y ) ),
+			_mm_sub_ps( _mm_mul_ps( real.z, dual.x ), _mm_mul_ps( real.x, dual.z ) ) );
+		__m128 tz = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.w, dual.z ), _mm_mul_ps( dual.w, real.z ) ),
+			_mm_sub_ps( _mm_mul_ps( real.x, dual.y ), _mm_mul_ps( real.y, dual.x ) ) );
+		tx = _mm_add_ps( tx, tx );
+		ty = _mm_add_ps( ty, ty );
+		tz = _mm_add_ps( tz, tz );
+
+		__m128 x, y, z;
+		rotate( real, _mm_load_ps( positions.x + i ), _mm_load_ps( positions.y + i ), _mm_load_ps( positions.z + i ), x, y, z );
+		_mm_store_ps( out_positions.x + i, _mm_add_ps( x, tx ) );
+		_mm_store_ps( out_positions.y + i, _mm_add_ps( y, ty ) );
+		_mm_store_ps( out_positions.z + i, _mm_add_ps( z, tz ) );
+
+		if constexpr ( Normals )
+		{
+			rotate( real, _mm_load_ps( normals.x + i ), _mm_load_ps( normals.y + i ), _mm_load_ps( normals.z + i ), x, y, z );
+			_mm_store_ps( out_normals.x + i, x );
+			_mm_store_ps( out_normals.y + i, y );
+			_mm_store_ps( out_normals.z + i, z );
+		}
+	}
+	return i;
+}
+
+#endif  // SPOT_SSE2
+
+
+template <bool Normals>
+void skin( const DualQuat*       palette,
+           const BoneInfluences* influences,
+           const Vec3Soa&        positions,
+           const Vec3Soa&        normals,
+           Vec3Soa&              out_positions,
+           Vec3Soa&              out_normals )
+{
+	out_positions.resize( positions.size() );
+	if constexpr ( Normals )
+	{
+		assert( normals.size() == positions.size() && "Arrays of different sizes" );
+		out_normals.resize( normals.size() );
+	}
+
+	size_t i = 0;
+#ifdef SPOT_SSE2
+	i = skin_sse2<Normals>( palette, influences, positions, normals, out_positions, out_normals );
+#endif
+	skin_scalar<Normals>( palette, influences, positions, normals, out_positions, out_normals, i );
+}
+
+
+}  // namespace
+
+
+void skin( const DualQuat* palette, const BoneInfluences* influences, const Vec3Soa& positions, Vec3Soa& out_positions )
+{
+	skin<false>( palette, influences, positions, positions, out_positions, out_positions );
+}
+
+
+void skin( const DualQuat*       palette,
+           const BoneInfluences* influences,
+           const Vec3Soa&        positions,
+           const Vec3Soa&        normals,
+           Vec3Soa&              out_positions,
+           Vec3Soa&              out_normals )
+{
+	skin<true>( palette, influences, positions, normals, out_positions, out_normals );
+}
+
+
+}  // namespace spot::math
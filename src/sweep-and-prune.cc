@@ -0,0 +1,293 @@
+#include "spot/math/sweep-and-prune.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+
+namespace spot::math
+{
+
+
+namespace
+{
+
+
+/// Skips no axis when testing an overlap
+constexpr uint32_t NoAxis = 3;
+
+
+uint64_t get_key( const uint32_t a, const uint32_t b )
+{
+	return a < b ? ( uint64_t( a ) << 32 ) | b : ( uint64_t( b ) << 32 ) | a;
+}
+
+
+float get( const Vec3& v, const uint32_t axis )
+{
+	return ( &v.x )[axis];
+}
+
+
+/// @brief Order of endpoints, a max comes before a min with the same value
+/// so that touching boxes are not overlapping
+template <typename Endpoint>
+bool less( const Endpoint& a, const Endpoint& b )
+{
+	return a.value < b.value || ( a.value == b.value && a.is_max() && !b.is_max() );
+}
+
+
+}  // namespace
+
+
+SweepAndPrune::SweepAndPrune( const uint32_t aa )
+: axes { aa }
+{
+	assert( axes >= 1 && axes <= 3 && "Sweep and prune works with one to three axes" );
+}
+
+
+bool SweepAndPrune::overlaps( const Object& a, const Object& b, const uint32_t skip ) const
+{
+	for ( uint32_t axis = 0; axis < axes; ++axis )
+	{
+		if ( axis != skip && ( get( a.box.a, axis ) >= get( b.box.b, axis ) || get( a.box.b, axis ) <= get( b.box.a, axis ) ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+void SweepAndPrune::record( const uint64_t key, const bool existed )
+{
+	changes.emplace( key, existed );
+}
+
+
+void SweepAndPrune::add_pair( const Id a, const Id b )
+{
+	const uint64_t key = get_key( a, b );
+	if ( pairs.emplace( key ).second )
+	{
+		record( key, false );
+	}
+}
+
+
+void SweepAndPrune::remove_pair( const Id a, const Id b )
+{
+	const uint64_t key = get_key( a, b );
+	if ( pairs.erase( key ) )
+	{
+		record( key, true );
+	}
+}
+
+
+void SweepAndPrune::on_pass( const uint32_t axis, const Endpoint& moving, const Endpoint& other, const bool down )
+{
+	if ( moving.is_max() == other.is_max() || moving.get_id() == other.get_id() )
+	{
+		return;
+	}
+
+	// A min moving down past a max, or a max moving up past a min, may start an overlap
+	const bool starts = moving.is_max() != down;
+	const Id   a      = moving.get_id();
+	const Id   b      = other.get_id();
+	if ( starts )
+	{
+		if ( overlaps( objects[a], objects[b], NoAxis ) )
+		{
+			add_pair( a, b );
+		}
+	}
+	// Boxes apart along another axis were not a pair, so the set is not touched
+	else if ( overlaps( objects[a], objects[b], axis ) )
+	{
+		remove_pair( a, b );
+	}
+}
+
+
+void SweepAndPrune::sort_down( const uint32_t axis, uint32_t index )
+{
+	auto& list = endpoints[axis];
+	const Endpoint moving = list[index];
+
+	while ( index > 0 && less( moving, list[index - 1] ) )
+	{
+		const Endpoint& other = list[index - 1];
+		on_pass( axis, moving, other, true );
+
+		auto& object = objects[other.get_id()];
+		( other.is_max() ? object.maxs : object.mins )[axis] = index;
+		list[index] = other;
+		--index;
+	}
+
+	list[index] = moving;
+	auto& object = objects[moving.get_id()];
+	( moving.is_max() ? object.maxs : object.mins )[axis] = index;
+}
+
+
+void SweepAndPrune::sort_up( const uint32_t axis, uint32_t index )
+{
+	auto& list = endpoints[axis];
+	const Endpoint moving = list[index];
+	const uint32_t last = uint32_t( list.size() - 1 );
+
+	while ( index < last && less( list[index + 1], moving ) )
+	{
+		const Endpoint& other = list[index + 1];
+		on_pass( axis, moving, other, false );
+
+		auto& object = objects[other.get_id()];
+		( other.is_max() ? object.maxs : object.mins )[axis] = index;
+		list[index] = other;
+		++index;
+	}
+
+	list[index] = moving;
+	auto& object = objects[moving.get_id()];
+	( moving.is_max() ? object.maxs : object.mins )[axis] = index;
+}
+
+
+SweepAndPrune::Id SweepAndPrune::add( const Box& box )
+{
+	Id id;
+	if ( free_ids.empty() )
+	{
+		id = Id( objects.size() );
+		objects.emplace_back();
+	}
+	else
+	{
+		id = free_ids.back();
+		free_ids.pop_back();
+	}
+
+	// Endpoints start at the end of every axis
+	constexpr float infinity = std::numeric_limits<float>::infinity();
+	auto& object = objects[id];
+	object.box   = Box( { infinity, infinity, infinity }, { infinity, infinity, infinity } );
+	object.alive = true;
+	for ( uint32_t axis = 0; axis < axes; ++axis )
+	{
+		auto& list         = endpoints[axis];
+		object.mins[axis]  = uint32_t( list.size() );
+		list.push_back( { infinity, id << 1 } );
+		object.maxs[axis]  = uint32_t( list.size() );
+		list.push_back( { infinity, ( id << 1 ) | 1 } );
+	}
+
+	++count;
+	move( id, box );
+	return id;
+}
+
+
+void SweepAndPrune::move( const Id id, const Box& box )
+{
+	assert( id < objects.size() && objects[id].alive && "Invalid box id" );
+	auto& object = objects[id];
+	const Vec3 min = { std::min( box.a.x, box.b.x ), std::min( box.a.y, box.b.y ), std::min( box.a.z, box.b.z ) };
+	const Vec3 max = { std::max( box.a.x, box.b.x ), std::max( box.a.y, box.b.y ), std::max( box.a.z, box.b.z ) };
+
+	for ( uint32_t axis = 0; axis < 3; ++axis )
+	{
+		// Bounds change one axis at a time, so that pairs always agree with the sorted lists
+		( &object.box.a.x )[axis] = get( min, axis );
+		( &object.box.b.x )[axis] = get( max, axis );
+		if ( axis >= axes )
+		{
+			continue;
+		}
+
+		auto& list = endpoints[axis];
+		auto& lower = list[object.mins[axis]];
+		auto& upper = list[object.maxs[axis]];
+		const bool min_down = get( min, axis ) < lower.value;
+		const bool min_up   = get( min, axis ) > lower.value;
+		const bool max_down = get( max, axis ) < upper.value;
+		const bool max_up   = get( max, axis ) > upper.value;
+		lower.value = get( min, axis );
+		upper.value = get( max, axis );
+
+		// A min going down passes endpoints first, and so does a max going up
+		if ( min_down )
+		{
+			sort_down( axis, object.mins[axis] );
+		}
+		if ( max_down )
+		{
+			sort_down( axis, object.maxs[axis] );
+		}
+		if ( max_up )
+		{
+			sort_up( axis, object.maxs[axis] );
+		}
+		if ( min_up )
+		{
+			sort_up( axis, object.mins[axis] );
+		}
+	}
+}
+
+
+void SweepAndPrune::remove( const Id id )
+{
+	// Moving the box past every other one removes its pairs and leaves its endpoints last
+	constexpr float infinity = std::numeric_limits<float>::infinity();
+	move( id, Box( { infinity, infinity, infinity }, { infinity, infinity, infinity } ) );
+
+	for ( uint32_t axis = 0; axis < axes; ++axis )
+	{
+		auto& list = endpoints[axis];
+		// Other boxes at infinity may follow it
+		const uint32_t lower = std::min( objects[id].mins[axis], objects[id].maxs[axis] );
+		const uint32_t upper = std::max( objects[id].mins[axis], objects[id].maxs[axis] );
+		list.erase( list.begin() + upper );
+		list.erase( list.begin() + lower );
+		for ( uint32_t i = lower; i < list.size(); ++i )
+		{
+			auto& other = objects[list[i].get_id()];
+			( list[i].is_max() ? other.maxs : other.mins )[axis] = i;
+		}
+	}
+
+	objects[id].alive = false;
+	removed_ids.push_back( id );
+	--count;
+}
+
+
+void SweepAndPrune::flush( std::vector<Pair>& added, std::vector<Pair>& removed )
+{
+	changes.for_each( [&]( const uint64_t key, const bool existed ) {
+		const bool exists = pairs.contains( key );
+		if ( exists != existed )
+		{
+			auto pair = Pair( Id( key >> 32 ), Id( key ) );
+			( exists ? added : removed ).push_back( pair );
+		}
+	} );
+	changes.clear();
+
+	free_ids.insert( free_ids.end(), removed_ids.begin(), removed_ids.end() );
+	removed_ids.clear();
+}
+
+
+void SweepAndPrune::get_pairs( std::vector<Pair>& out ) const
+{
+	pairs.for_each( [&]( const uint64_t key, NoValue ) { out.emplace_back( Id( key >> 32 ), Id( key ) ); } );
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,158 @@
+#include "spot/math/thread-pool.h"
+
+#include <cassert>
+
+
+namespace spot::math
+{
+
+
+ThreadPool::ThreadPool( const size_t count )
+: ranges { new Range[count > 0 ? count : 1] }
+{
+	for ( size_t i = 1; i < count; ++i )
+	{
+		threads.emplace_back( [this, i] { work( i ); } );
+	}
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		stop = true;
+	}
+	wake.notify_all();
+	for ( auto& thread : threads )
+	{
+		thread.join();
+	}
+}
+
+
+bool ThreadPool::pop( const size_t index, size_t& out )
+{
+	auto& own = ranges[index];
+	{
+		std::lock_guard<std::mutex> lock( own.mutex );
+		if ( own.begin < own.end )
+		{
+			out = own.begin++;
+			return true;
+		}
+	}
+
+	const size_t count = size();
+	for ( size_t offset = 1; offset < count; ++offset )
+	{
+		auto& victim = ranges[( index + offset ) % count];
+		size_t begin = 0;
+		size_t end   = 0;
+		{
+			std::lock_guard<std::mutex> lock( victim.mutex );
+			if ( victim.begin == victim.end )
+			{
+				continue;
+			}
+			// The back half is the one its owner would run last
+			end        = victim.end;
+			begin      = victim.end - ( victim.end - victim.begin + 1 ) / 2;
+			victim.end = begin;
+		}
+
+		out = begin;
+		std::lock_guard<std::mutex> lock( own.mutex );
+		own.begin = begin + 1;
+		own.end   = end;
+		return true;
+	}
+
+	return false;
+}
+
+
+void ThreadPool::drain( const size_t index )
+{
+	size_t next;
+	while ( pop( index, next ) )
+	{
+		( *task )( next );
+		if ( remaining.fetch_sub( 1 ) == 1 )
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			done.notify_all();
+		}
+	}
+}
+
+
+void ThreadPool::work( const size_t index )
+{
+	uint64_t seen = 0;
+	while ( true )
+	{
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			wake.wait( lock, [&] { return stop || batch != seen; } );
+			if ( stop )
+			{
+				return;
+			}
+			seen = batch;
+			++active;
+		}
+
+		drain( index );
+
+		std::lock_guard<std::mutex> lock( mutex );
+		if ( --active == 0 )
+		{
+			done.notify_all();
+		}
+	}
+}
+
+
+void ThreadPool::run( const size_t count, const std::function<void( size_t )>& function )
+{
+	if ( count == 0 )
+	{
+		return;
+	}
+
+	{
+		// A worker still looking for tasks of the last batch would mix up its ranges
+		std::unique_lock<std::mutex> lock( mutex );
+		done.wait( lock, [&] { return active == 0; } );
+
+		assert( remaining == 0 && "Batches do not overlap" );
+		task      = &function;
+		remaining = count;
+
+		// Contiguous tasks to each thread, as they often touch neighboring data
+		const size_t threads = size();
+		for ( size_t i = 0; i < threads; ++i )
+		{
+			std::lock_guard<std::mutex> range_lock( ranges[i].mutex );
+			ranges[i].begin = count * i / threads;
+			ranges[i].end   = count * ( i + 1 ) / threads;
+		}
+		++batch;
+	}
+	wake.notify_all();
+
+	drain( 0 );
+
+	std::unique_lock<std::mutex> lock( mutex );
+	done.wait( lock, [&] { return remaining == 0; } );
+}
+
+
+Executor ThreadPool::get_executor()
+{
+	return [this]( const size_t count, const std::function<void( size_t )>& function ) { run( count, function ); };
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,458 @@
+#include "spot/math/vec3-soa.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+/// Floats in a SIMD register, the arrays are padded to a multiple of it
+/// so element-wise kernels run over whole registers without a scalar tail
+constexpr size_t Width = Vec3Soa::Alignment / sizeof( float );
+
+
+void Vec3Soa::Free::operator()( float* data ) const
+{
+	::operator delete[]( data, std::align_val_t( Alignment ) );
+}
+
+
+size_t Vec3Soa::get_stride( const size_t size )
+{
+	return ( size + Width - 1 ) / Width * Width;
+}
+
+
+Vec3Soa::Vec3Soa( const size_t size )
+{
+	resize( size );
+}
+
+
+Vec3Soa::Vec3Soa( const std::vector<Vec3>& v )
+{
+	gather( v );
+}
+
+
+Vec3Soa::Vec3Soa( const Vec3Soa& other )
+{
+	*this = other;
+}
+
+
+Vec3Soa& Vec3Soa::operator=( const Vec3Soa& other )
+{
+	if ( this != &other )
+	{
+		resize( other.count );
+		std::memcpy( x, other.x, count * sizeof( float ) );
+		std::memcpy( y, other.y, count * sizeof( float ) );
+		std::memcpy( z, other.z, count * sizeof( float ) );
+	}
+	return *this;
+}
+
+
+Vec3Soa::Vec3Soa( Vec3Soa&& other ) noexcept
+{
+	*this = std::move( other );
+}
+
+
+Vec3Soa& Vec3Soa::operator=( Vec3Soa&& other ) noexcept
+{
+	x     = std::exchange( other.x, nullptr );
+	y     = std::exchange( other.y, nullptr );
+	z     = std::exchange( other.z, nullptr );
+	count = std::exchange( other.count, 0 );
+	data  = std::move( other.data );
+	return *this;
+}
+
+
+void Vec3Soa::resize( const size_t size )
+{
+	const size_t stride = get_stride( size );
+	if ( stride != get_stride( count ) || !data )
+	{
+		auto bytes = 3 * stride * sizeof( float );
+		auto next  = std::unique_ptr<float[], Free>(
+			static_cast<float*>( ::operator new[]( bytes, std::align_val_t( Alignment ) ) ) );
+		std::memset( next.get(), 0, bytes );
+
+		const size_t kept = std::min( size, count );
+		if ( kept > 0 )
+		{
+			std::memcpy( next.get(), x, kept * sizeof( float ) );
+			std::memcpy( next.get() + stride, y, kept * sizeof( float ) );
+			std::memcpy( next.get() + 2 * stride, z, kept * sizeof( float ) );
+		}
+
+		data = std::move( next );
+		x    = data.get();
+		y    = x + stride;
+		z    = y + stride;
+	}
+	else if ( size > count )
+	{
+		// Padding may hold results of previous operations
+		const size_t added = ( size - count ) * sizeof( float );
+		std::memset( x + count, 0, added );
+		std::memset( y + count, 0, added );
+		std::memset( z + count, 0, added );
+	}
+
+	count = size;
+}
+
+
+void Vec3Soa::gather( const Vec3* v, const size_t size )
+{
+	resize( size );
+	for ( size_t i = 0; i < size; ++i )
+	{
+		x[i] = v[i].x;
+		y[i] = v[i].y;
+		z[i] = v[i].z;
+	}
+}
+
+
+void Vec3Soa::gather( const std::vector<Vec3>& v )
+{
+	gather( v.data(), v.size() );
+}
+
+
+void Vec3Soa::scatter( Vec3* out ) const
+{
+	for ( size_t i = 0; i < count; ++i )
+	{
+		out[i] = { x[i], y[i], z[i] };
+	}
+}
+
+
+std::vector<Vec3> Vec3Soa::scatter() const
+{
+	std::vector<Vec3> ret( count );
+	scatter( ret.data() );
+	return ret;
+}
+
+
+View<Vec3> Vec3Soa::scatter( Arena& arena ) const
+{
+	auto ret = arena.allocate<Vec3>( count );
+	scatter( ret.data() );
+	return ret;
+}
+
+
+Vec3 Vec3Soa::operator[]( const size_t i ) const
+{
+	assert( i < count && "Index out of range" );
+	return { x[i], y[i], z[i] };
+}
+
+
+void Vec3Soa::set( const size_t i, const Vec3& v )
+{
+	assert( i < count && "Index out of range" );
+	x[i] = v.x;
+	y[i] = v.y;
+	z[i] = v.z;
+}
+
+
+namespace
+{
+
+
+/// @brief Reduces a component to its minimum or maximum,
+/// padding is skipped as it does not hold vectors
+template <bool Max>
+float reduce( const float* f, const size_t count )
+{
+	assert( count > 0 && "Reduction of an empty array" );
+	float  ret = f[0];
+	size_t i   = 1;
+
+#ifdef SPOT_SSE2
+	if ( count >= 4 )
+	{
+		auto op = []( __m128 a, __m128 b ) { return Max ? _mm_max_ps( a, b ) : _mm_min_ps( a, b ); };
+
+		__m128 r = _mm_load_ps( f );
+		for ( i = 4; i + 4 <= count; i += 4 )
+		{
+			r = op( r, _mm_load_ps( f + i ) );
+		}
+		r   = op( r, _mm_shuffle_ps( r, r, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+		r   = op( r, _mm_shuffle_ps( r, r, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+		ret = _mm_cvtss_f32( r );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		ret = Max ? std::max( ret, f[i] ) : std::min( ret, f[i] );
+	}
+	return ret;
+}
+
+
+/// @brief Resizes out to the operands
+/// @return Floats processed by element-wise kernels, which run over the padding
+/// with whole registers, as out is the only array written by them
+size_t prepare( const Vec3Soa& a, [[maybe_unused]] const Vec3Soa& b, Vec3Soa& out )
+{
+	assert( a.size() == b.size() && "Arrays of different sizes" );
+	out.resize( a.size() );
+#ifdef SPOT_SSE2
+	return ( a.size() + 3 ) / 4 * 4;
+#else
+	return a.size();
+#endif
+}
+
+
+}  // namespace
+
+
+Vec3 Vec3Soa::get_min() const
+{
+	return { reduce<false>( x, count ), reduce<false>( y, count ), reduce<false>( z, count ) };
+}
+
+
+Vec3 Vec3Soa::get_max() const
+{
+	return { reduce<true>( x, count ), reduce<true>( y, count ), reduce<true>( z, count ) };
+}
+
+
+void add( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out )
+{
+	const size_t n = prepare( a, b, out );
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i < n; i += 4 )
+	{
+		_mm_store_ps( out.x + i, _mm_add_ps( _mm_load_ps( a.x + i ), _mm_load_ps( b.x + i ) ) );
+		_mm_store_ps( out.y + i, _mm_add_ps( _mm_load_ps( a.y + i ), _mm_load_ps( b.y + i ) ) );
+		_mm_store_ps( out.z + i, _mm_add_ps( _mm_load_ps( a.z + i ), _mm_load_ps( b.z + i ) ) );
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		out.x[i] = a.x[i] + b.x[i];
+		out.y[i] = a.y[i] + b.y[i];
+		out.z[i] = a.z[i] + b.z[i];
+	}
+}
+
+
+void sub( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out )
+{
+	const size_t n = prepare( a, b, out );
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i < n; i += 4 )
+	{
+		_mm_store_ps( out.x + i, _mm_sub_ps( _mm_load_ps( a.x + i ), _mm_load_ps( b.x + i ) ) );
+		_mm_store_ps( out.y + i, _mm_sub_ps( _mm_load_ps( a.y + i ), _mm_load_ps( b.y + i ) ) );
+		_mm_store_ps( out.z + i, _mm_sub_ps( _mm_load_ps( a.z + i ), _mm_load_ps( b.z + i ) ) );
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		out.x[i] = a.x[i] - b.x[i];
+		out.y[i] = a.y[i] - b.y[i];
+		out.z[i] = a.z[i] - b.z[i];
+	}
+}
+
+
+void mul( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out )
+{
+	const size_t n = prepare( a, b, out );
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i < n; i += 4 )
+	{
+		_mm_store_ps( out.x + i, _mm_mul_ps( _mm_load_ps( a.x + i ), _mm_load_ps( b.x + i ) ) );
+		_mm_store_ps( out.y + i, _mm_mul_ps( _mm_load_ps( a.y + i ), _mm_load_ps( b.y + i ) ) );
+		_mm_store_ps( out.z + i, _mm_mul_ps( _mm_load_ps( a.z + i ), _mm_load_ps( b.z + i ) ) );
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		out.x[i] = a.x[i] * b.x[i];
+		out.y[i] = a.y[i] * b.y[i];
+		out.z[i] = a.z[i] * b.z[i];
+	}
+}
+
+
+void mul( const Vec3Soa& a, const float k, Vec3Soa& out )
+{
+	const size_t n = prepare( a, a, out );
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	const __m128 kk = _mm_set1_ps( k );
+	for ( ; i < n; i += 4 )
+	{
+		_mm_store_ps( out.x + i, _mm_mul_ps( _mm_load_ps( a.x + i ), kk ) );
+		_mm_store_ps( out.y + i, _mm_mul_ps( _mm_load_ps( a.y + i ), kk ) );
+		_mm_store_ps( out.z + i, _mm_mul_ps( _mm_load_ps( a.z + i ), kk ) );
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		out.x[i] = a.x[i] * k;
+		out.y[i] = a.y[i] * k;
+		out.z[i] = a.z[i] * k;
+	}
+}
+
+
+void cross( const Vec3Soa& a, const Vec3Soa& b, Vec3Soa& out )
+{
+	const size_t n = prepare( a, b, out );
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i < n; i += 4 )
+	{
+		const __m128 ax = _mm_load_ps( a.x + i );
+		const __m128 ay = _mm_load_ps( a.y + i );
+		const __m128 az = _mm_load_ps( a.z + i );
+		const __m128 bx = _mm_load_ps( b.x + i );
+		const __m128 by = _mm_load_ps( b.y + i );
+		const __m128 bz = _mm_load_ps( b.z + i );
+		_mm_store_ps( out.x + i, _mm_sub_ps( _mm_mul_ps( ay, bz ), _mm_mul_ps( az, by ) ) );
+		_mm_store_ps( out.y + i, _mm_sub_ps( _mm_mul_ps( az, bx ), _mm_mul_ps( ax, bz ) ) );
+		_mm_store_ps( out.z + i, _mm_sub_ps( _mm_mul_ps( ax, by ), _mm_mul_ps( ay, bx ) ) );
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		// Operands are read first as out may be one of them
+		const Vec3 r = Vec3::cross( a[i], b[i] );
+		out.set( i, r );
+	}
+}
+
+
+void lerp( const Vec3Soa& a, const Vec3Soa& b, const float t, Vec3Soa& out )
+{
+	const size_t n = prepare( a, b, out );
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	const __m128 tt = _mm_set1_ps( t );
+	for ( ; i < n; i += 4 )
+	{
+		const __m128 ax = _mm_load_ps( a.x + i );
+		const __m128 ay = _mm_load_ps( a.y + i );
+		const __m128 az = _mm_load_ps( a.z + i );
+		_mm_store_ps( out.x + i, _mm_add_ps( ax, _mm_mul_ps( tt, _mm_sub_ps( _mm_load_ps( b.x + i ), ax ) ) ) );
+		_mm_store_ps( out.y + i, _mm_add_ps( ay, _mm_mul_ps( tt, _mm_sub_ps( _mm_load_ps( b.y + i ), ay ) ) ) );
+		_mm_store_ps( out.z + i, _mm_add_ps( az, _mm_mul_ps( tt, _mm_sub_ps( _mm_load_ps( b.z + i ), az ) ) ) );
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		out.x[i] = a.x[i] + t * ( b.x[i] - a.x[i] );
+		out.y[i] = a.y[i] + t * ( b.y[i] - a.y[i] );
+		out.z[i] = a.z[i] + t * ( b.z[i] - a.z[i] );
+	}
+}
+
+
+void dot( const Vec3Soa& a, const Vec3Soa& b, float* out )
+{
+	assert( a.size() == b.size() && "Arrays of different sizes" );
+	const size_t n = a.size();
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	// The output is not padded
+	for ( ; i + 4 <= n; i += 4 )
+	{
+		const __m128 d = _mm_add_ps(
+			_mm_add_ps(
+				_mm_mul_ps( _mm_load_ps( a.x + i ), _mm_load_ps( b.x + i ) ),
+				_mm_mul_ps( _mm_load_ps( a.y + i ), _mm_load_ps( b.y + i ) ) ),
+			_mm_mul_ps( _mm_load_ps( a.z + i ), _mm_load_ps( b.z + i ) ) );
+		_mm_storeu_ps( out + i, d );
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+	}
+}
+
+
+void normalize( const Vec3Soa& a, Vec3Soa& out )
+{
+	const size_t n = prepare( a, a, out );
+	size_t       i = 0;
+
+#ifdef SPOT_SSE2
+	for ( ; i < n; i += 4 )
+	{
+		const __m128 x = _mm_load_ps( a.x + i );
+		const __m128 y = _mm_load_ps( a.y + i );
+		const __m128 z = _mm_load_ps( a.z + i );
+		const __m128 squared = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+		// Same operations of Vec3::normalize for either precision
+		if constexpr ( DefaultPrecision == Precision::Fast )
+		{
+			const __m128 k = rsqrt( squared );
+			_mm_store_ps( out.x + i, _mm_mul_ps( x, k ) );
+			_mm_store_ps( out.y + i, _mm_mul_ps( y, k ) );
+			_mm_store_ps( out.z + i, _mm_mul_ps( z, k ) );
+		}
+		else
+		{
+			const __m128 length = _mm_sqrt_ps( squared );
+			_mm_store_ps( out.x + i, _mm_div_ps( x, length ) );
+			_mm_store_ps( out.y + i, _mm_div_ps( y, length ) );
+			_mm_store_ps( out.z + i, _mm_div_ps( z, length ) );
+		}
+	}
+#endif
+
+	for ( ; i < n; ++i )
+	{
+		Vec3 v = a[i];
+		v.normalize();
+		out.set( i, v );
+	}
+}
+
+
+}  // namespace spot::math
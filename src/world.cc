@@ -0,0 +1,191 @@
+#include "spot/math/world.h"
+
+#include "spot/math/simd.h"
+
+#include "intrinsics.h"
+
+
+namespace spot::math
+{
+
+
+Mat4d from_trs( const Vec3d& t, const Quat& r, const Vec3& s )
+{
+	auto ret = Mat4d( Mat4::from_trs( Vec3(), r, s ) );
+	ret( 0, 3 ) = t[0];
+	ret( 1, 3 ) = t[1];
+	ret( 2, 3 ) = t[2];
+	return ret;
+}
+
+
+Vec3 rebase( const Vec3d& origin, const Vec3d& position )
+{
+	return Vec3( position - origin );
+}
+
+
+Mat4 rebase( const Vec3d& origin, const Mat4d& world )
+{
+	// Rows of a pre-multiplication by a translation, m( i, j ) - o[i] * m( 3, j )
+	Mat4 ret;
+	for ( size_t column = 0; column < 16; column += 4 )
+	{
+		const double w = world.matrix[column + 3];
+		for ( size_t row = 0; row < 3; ++row )
+		{
+			ret.matrix[column + row] = float( world.matrix[column + row] - origin[row] * w );
+		}
+		ret.matrix[column + 3] = float( w );
+	}
+	return ret;
+}
+
+
+namespace
+{
+
+
+#ifdef SPOT_SSE2
+
+/// @brief Four positions at a time, with pairs of doubles converted to pairs of floats
+void rebase_sse2( const Vec3d& origin, const double* in, float* out, const size_t count )
+{
+	// Pairs of components of four positions follow the pattern xy zx yz
+	const __m128d xy = _mm_set_pd( origin[1], origin[0] );
+	const __m128d zx = _mm_set_pd( origin[0], origin[2] );
+	const __m128d yz = _mm_set_pd( origin[2], origin[1] );
+
+	for ( size_t i = 0; i < count; i += 4, in += 12, out += 12 )
+	{
+		const __m128 a = _mm_cvtpd_ps( _mm_sub_pd( _mm_loadu_pd( in ), xy ) );
+		const __m128 b = _mm_cvtpd_ps( _mm_sub_pd( _mm_loadu_pd( in + 2 ), zx ) );
+		const __m128 c = _mm_cvtpd_ps( _mm_sub_pd( _mm_loadu_pd( in + 4 ), yz ) );
+		const __m128 d = _mm_cvtpd_ps( _mm_sub_pd( _mm_loadu_pd( in + 6 ), xy ) );
+		const __m128 e = _mm_cvtpd_ps( _mm_sub_pd( _mm_loadu_pd( in + 8 ), zx ) );
+		const __m128 f = _mm_cvtpd_ps( _mm_sub_pd( _mm_loadu_pd( in + 10 ), yz ) );
+		_mm_storeu_ps( out, _mm_movelh_ps( a, b ) );
+		_mm_storeu_ps( out + 4, _mm_movelh_ps( c, d ) );
+		_mm_storeu_ps( out + 8, _mm_movelh_ps( e, f ) );
+	}
+}
+
+
+void rebase_sse2( const Vec3d& origin, const Mat4d* in, Mat4* out, const size_t count )
+{
+	const __m128d xy = _mm_set_pd( origin[1], origin[0] );
+	const __m128d z0 = _mm_set_sd( origin[2] );
+
+	for ( size_t i = 0; i < count; ++i )
+	{
+		const double* m = in[i].matrix;
+		for ( size_t column = 0; column < 16; column += 4 )
+		{
+			const __m128d w = _mm_set1_pd( m[column + 3] );
+			const __m128d zw = _mm_loadu_pd( m + column + 2 );
+			const __m128 a = _mm_cvtpd_ps( _mm_sub_pd( _mm_loadu_pd( m + column ), _mm_mul_pd( xy, w ) ) );
+			// The bottom row is kept as it is
+			const __m128 b = _mm_cvtpd_ps( _mm_move_sd( zw, _mm_sub_pd( zw, _mm_mul_pd( z0, w ) ) ) );
+			_mm_storeu_ps( out[i].matrix + column, _mm_movelh_ps( a, b ) );
+		}
+	}
+}
+
+
+/// @brief Four positions at a time, three registers of four doubles converted to three of four floats
+SPOT_TARGET( "avx" )
+void rebase_avx( const Vec3d& origin, const double* in, float* out, const size_t count )
+{
+	const __m256d xyzx = _mm256_set_pd( origin[0], origin[2], origin[1], origin[0] );
+	const __m256d yzxy = _mm256_set_pd( origin[1], origin[0], origin[2], origin[1] );
+	const __m256d zxyz = _mm256_set_pd( origin[2], origin[1], origin[0], origin[2] );
+
+	for ( size_t i = 0; i < count; i += 4, in += 12, out += 12 )
+	{
+		_mm_storeu_ps( out, _mm256_cvtpd_ps( _mm256_sub_pd( _mm256_loadu_pd( in ), xyzx ) ) );
+		_mm_storeu_ps( out + 4, _mm256_cvtpd_ps( _mm256_sub_pd( _mm256_loadu_pd( in + 4 ), yzxy ) ) );
+		_mm_storeu_ps( out + 8, _mm256_cvtpd_ps( _mm256_sub_pd( _mm256_loadu_pd( in + 8 ), zxyz ) ) );
+	}
+}
+
+
+/// @brief A column of four doubles to a register
+SPOT_TARGET( "avx" )
+void rebase_avx( const Vec3d& origin, const Mat4d* in, Mat4* out, const size_t count )
+{
+	const __m256d o = _mm256_set_pd( 0.0, origin[2], origin[1], origin[0] );
+
+	for ( size_t i = 0; i < count; ++i )
+	{
+		const double* m = in[i].matrix;
+		for ( size_t column = 0; column < 16; column += 4 )
+		{
+			const __m256d c = _mm256_loadu_pd( m + column );
+			const __m256d w = _mm256_broadcast_sd( m + column + 3 );
+			// The bottom row is kept as it is
+			const __m256d r = _mm256_blend_pd( _mm256_sub_pd( c, _mm256_mul_pd( o, w ) ), c, 0x8 );
+			_mm_storeu_ps( out[i].matrix + column, _mm256_cvtpd_ps( r ) );
+		}
+	}
+}
+
+
+bool has_avx()
+{
+	static const bool avx = get_simd_support() >= Simd::Avx;
+	return avx;
+}
+
+#endif  // SPOT_SSE2
+
+
+}  // namespace
+
+
+void rebase( const Vec3d& origin, const Vec3d* const in, Vec3* const out, const size_t count )
+{
+	size_t i = 0;
+
+#ifdef SPOT_SSE2
+	// Vectorized kernels run over whole groups of four, the rest is scalar
+	i = count / 4 * 4;
+	auto data = reinterpret_cast<const double*>( in );
+	auto ret = reinterpret_cast<float*>( out );
+	if ( has_avx() )
+	{
+		rebase_avx( origin, data, ret, i );
+	}
+	else
+	{
+		rebase_sse2( origin, data, ret, i );
+	}
+#endif
+
+	for ( ; i < count; ++i )
+	{
+		out[i] = rebase( origin, in[i] );
+	}
+}
+
+
+void rebase( const Vec3d& origin, const Mat4d* const in, Mat4* const out, const size_t count )
+{
+#ifdef SPOT_SSE2
+	if ( has_avx() )
+	{
+		rebase_avx( origin, in, out, count );
+	}
+	else
+	{
+		rebase_sse2( origin, in, out, count );
+	}
+#else
+	for ( size_t i = 0; i < count; ++i )
+	{
+		out[i] = rebase( origin, in[i] );
+	}
+#endif
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,72 @@
+#include "test.h"
+#include "spot/math/affine3.h"
+
+namespace spot::math
+{
+
+
+bool equals( const Affine3& a, const Affine3& b )
+{
+	for ( size_t i = 0; i < 12; ++i )
+	{
+		if ( b.matrix[i] != Approx( a.matrix[i] ).margin( 1e-5f ) )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+TEST_CASE( "Affine3" )
+{
+	auto m = Mat4::Identity.scale( { 2.0f, 3.0f, 4.0f } );
+	m.rotate_y( radians( 30.0f ) );
+	m.translate( { 1.0f, 2.0f, 3.0f } );
+
+	auto n = Mat4::Identity.rotate_z( radians( 45.0f ) );
+	n.translate( { -1.0f, 0.5f, 0.0f } );
+
+	auto a = Affine3( m );
+	auto b = Affine3( n );
+
+	SECTION( "identity" )
+	{
+		REQUIRE( Affine3( Mat4::Identity ) == Affine3::Identity );
+		REQUIRE( Affine3::Identity.get_mat4() == Mat4::Identity );
+	}
+
+	SECTION( "mat4" )
+	{
+		REQUIRE( equals( m, a.get_mat4() ) );
+		REQUIRE( a( 0, 3 ) == 1.0f );
+		REQUIRE( a.get_translation() == m.get_translation() );
+	}
+
+	SECTION( "compose" )
+	{
+		REQUIRE( equals( Affine3( m * n ), a * b ) );
+	}
+
+	SECTION( "transform" )
+	{
+		auto p = Vec3( 1.0f, -2.0f, 3.0f );
+		auto expected = m * p;
+		auto result = a * p;
+		REQUIRE( result.x == Approx( expected.x ) );
+		REQUIRE( result.y == Approx( expected.y ) );
+		REQUIRE( result.z == Approx( expected.z ) );
+	}
+
+	SECTION( "inverse" )
+	{
+		REQUIRE( a.get_determinant() == Approx( 24.0f ) );
+		REQUIRE( equals( Affine3::Identity, a * a.get_inverse() ) );
+		REQUIRE( equals( Affine3::Identity, a.get_inverse() * a ) );
+		REQUIRE( equals( Affine3::Identity, b * b.get_inverse() ) );
+	}
+}
+
+
+} // namespace spot::math
@@ -0,0 +1,163 @@
+#include "test.h"
+#include "spot/math/animation.h"
+
+#include <cmath>
+#include <random>
+
+namespace spot::math
+{
+
+
+/// @return The angle of the rotation between two unit quaternions,
+/// from their chord as acos loses precision next to 1
+float angle_between( const Quat& a, const Quat& b )
+{
+	const double sign = dot( a, b ) < 0.0f ? -1.0 : 1.0;
+	const double w    = a.w - sign * b.w;
+	const double x    = a.x - sign * b.x;
+	const double y    = a.y - sign * b.y;
+	const double z    = a.z - sign * b.z;
+	return float( 4.0 * std::asin( std::sqrt( w * w + x * x + y * y + z * z ) / 2.0 ) );
+}
+
+
+Quat random_rotation( std::mt19937& gen )
+{
+	std::uniform_real_distribution<float> dist( -1.0f, 1.0f );
+	Quat q( dist( gen ), dist( gen ), dist( gen ), dist( gen ) );
+	q.normalize();
+	return q;
+}
+
+
+TEST_CASE( "Animation" )
+{
+	SECTION( "find key" )
+	{
+		std::vector<float> times = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f };
+		TrackCursor cursor;
+
+		REQUIRE( find_key( times, -1.0f, cursor ) == 0 );
+		REQUIRE( find_key( times, 0.5f, cursor ) == 0 );
+		REQUIRE( find_key( times, 1.0f, cursor ) == 1 );
+		REQUIRE( find_key( times, 2.5f, cursor ) == 2 );
+		// Far jumps fall back to a binary search
+		REQUIRE( find_key( times, 8.5f, cursor ) == 8 );
+		REQUIRE( cursor.key == 8 );
+		REQUIRE( find_key( times, 12.0f, cursor ) == 9 );
+		// Backwards
+		REQUIRE( find_key( times, 3.5f, cursor ) == 3 );
+		REQUIRE( find_key( times, -3.0f, cursor ) == 0 );
+
+		// Any cursor gives the same key of a fresh search
+		for ( size_t start = 0; start < times.size(); ++start )
+		{
+			for ( float time = -0.5f; time < 10.0f; time += 0.25f )
+			{
+				TrackCursor fresh;
+				TrackCursor cached = { start };
+				REQUIRE( find_key( times, time, cached ) == find_key( times, time, fresh ) );
+			}
+		}
+	}
+
+	SECTION( "vec3" )
+	{
+		Vec3Track track;
+		track.times  = { 1.0f, 2.0f, 4.0f };
+		track.values = { Vec3( 0.0f, 0.0f, 0.0f ), Vec3( 2.0f, 0.0f, 0.0f ), Vec3( 2.0f, 4.0f, 0.0f ) };
+		TrackCursor cursor;
+
+		REQUIRE( sample( track, 0.0f, cursor ) == Vec3( 0.0f, 0.0f, 0.0f ) );
+		REQUIRE( sample( track, 1.5f, cursor ) == Vec3( 1.0f, 0.0f, 0.0f ) );
+		REQUIRE( sample( track, 3.0f, cursor ) == Vec3( 2.0f, 2.0f, 0.0f ) );
+		REQUIRE( sample( track, 5.0f, cursor ) == Vec3( 2.0f, 4.0f, 0.0f ) );
+
+		Vec3Track single;
+		single.times  = { 1.0f };
+		single.values = { Vec3( 1.0f, 2.0f, 3.0f ) };
+		cursor        = {};
+		REQUIRE( sample( single, 0.0f, cursor ) == Vec3( 1.0f, 2.0f, 3.0f ) );
+		REQUIRE( sample( single, 2.0f, cursor ) == Vec3( 1.0f, 2.0f, 3.0f ) );
+	}
+
+	SECTION( "quat" )
+	{
+		auto a = Quat( Vec3( 0.0f, 1.0f, 0.0f ), 0.0f );
+		auto b = Quat( Vec3( 0.0f, 1.0f, 0.0f ), radians( 90.0f ) );
+
+		QuatTrack track;
+		track.times  = { 0.0f, 1.0f };
+		track.values = { a, b };
+		TrackCursor cursor;
+
+		auto half = Quat( Vec3( 0.0f, 1.0f, 0.0f ), radians( 45.0f ) );
+		for ( auto interpolation : { Interpolation::Nlerp, Interpolation::ApproxSlerp, Interpolation::Slerp } )
+		{
+			REQUIRE( angle_between( sample( track, 0.5f, cursor, interpolation ), half ) < 1e-3f );
+		}
+
+		// The shortest path goes through the negated key
+		auto r = nlerp( a, -b, 0.5f );
+		REQUIRE( angle_between( r, half ) < 1e-3f );
+	}
+
+	SECTION( "approx slerp" )
+	{
+		std::mt19937 gen( 42 );
+		float        error = 0.0f;
+
+		for ( size_t i = 0; i < 1000; ++i )
+		{
+			auto a = random_rotation( gen );
+			auto b = random_rotation( gen );
+			for ( float t = 0.0f; t <= 1.0f; t += 0.0625f )
+			{
+				error = std::max( error, angle_between( approx_slerp( a, b, t ), slerp( a, b, t ) ) );
+			}
+		}
+
+		REQUIRE( error < 1e-3f );
+	}
+
+	SECTION( "batch" )
+	{
+		std::mt19937                          gen( 42 );
+		std::uniform_real_distribution<float> step( 0.1f, 1.0f );
+
+		std::vector<QuatTrack> tracks( 37 );
+		for ( auto& track : tracks )
+		{
+			float time = -0.5f;
+			for ( size_t k = 0; k < 8; ++k )
+			{
+				track.times.push_back( time );
+				track.values.push_back( random_rotation( gen ) );
+				time += step( gen );
+			}
+		}
+
+		for ( auto interpolation : { Interpolation::Nlerp, Interpolation::ApproxSlerp } )
+		{
+			std::vector<TrackCursor> cursors( tracks.size() );
+			std::vector<TrackCursor> single( tracks.size() );
+			std::vector<Quat>        out( tracks.size() );
+
+			for ( float time = -1.0f; time < 8.0f; time += 0.125f )
+			{
+				sample( tracks.data(), cursors.data(), tracks.size(), time, out.data(), interpolation );
+				for ( size_t i = 0; i < tracks.size(); ++i )
+				{
+					auto expected = sample( tracks[i], time, single[i], interpolation );
+					REQUIRE( out[i].w == Approx( expected.w ).margin( 1e-6f ) );
+					REQUIRE( out[i].x == Approx( expected.x ).margin( 1e-6f ) );
+					REQUIRE( out[i].y == Approx( expected.y ).margin( 1e-6f ) );
+					REQUIRE( out[i].z == Approx( expected.z ).margin( 1e-6f ) );
+				}
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,117 @@
+#include "test.h"
+#include "spot/math/arena.h"
+
+#include <cstdint>
+
+namespace spot::math
+{
+
+
+bool is_aligned( const void* p, const size_t alignment )
+{
+	return reinterpret_cast<uintptr_t>( p ) % alignment == 0;
+}
+
+
+TEST_CASE( "Arena" )
+{
+	SECTION( "alignment" )
+	{
+		Arena arena( 256 );
+		REQUIRE( arena.get_used() == 0 );
+		REQUIRE( arena.get_capacity() == 0 );
+
+		for ( size_t size : { 1, 3, 12, 64, 5 } )
+		{
+			REQUIRE( is_aligned( arena.allocate( size ), Arena::Alignment ) );
+		}
+		REQUIRE( is_aligned( arena.allocate( 1, 4 ), 4 ) );
+		REQUIRE( is_aligned( arena.allocate( 8, 128 ), 128 ) );
+		REQUIRE( is_aligned( arena.allocate<Mat4>( 3 ).data(), Arena::Alignment ) );
+	}
+
+	SECTION( "reset" )
+	{
+		Arena arena( 1024 );
+		auto first = arena.allocate<Vec3>( 10 );
+		arena.allocate<Quat>( 10 );
+		REQUIRE( arena.get_used() >= 10 * sizeof( Vec3 ) + 10 * sizeof( Quat ) );
+
+		// The same memory is handed out again, without new blocks
+		arena.reset();
+		REQUIRE( arena.get_used() == 0 );
+		REQUIRE( arena.allocate<Vec3>( 10 ).data() == first.data() );
+		REQUIRE( arena.get_capacity() == 1024 );
+	}
+
+	SECTION( "growth" )
+	{
+		Arena arena( 64 );
+		std::vector<Mat4View> views;
+		for ( size_t i = 0; i < 20; ++i )
+		{
+			views.push_back( arena.allocate<Mat4>( i + 1, Mat4::Identity ) );
+		}
+
+		// Earlier allocations stay valid as blocks are added
+		for ( size_t i = 0; i < views.size(); ++i )
+		{
+			REQUIRE( views[i].size() == i + 1 );
+			for ( auto& m : views[i] )
+			{
+				REQUIRE( m == Mat4::Identity );
+			}
+		}
+
+		// Once grown, a frame of the same allocations does not add blocks
+		const size_t capacity = arena.get_capacity();
+		const size_t used = arena.get_used();
+		arena.reset();
+		for ( size_t i = 0; i < 20; ++i )
+		{
+			arena.allocate<Mat4>( i + 1 );
+		}
+		REQUIRE( arena.get_capacity() == capacity );
+		REQUIRE( arena.get_used() <= used );
+
+		// A single allocation larger than any block
+		auto large = arena.allocate<Vec3>( capacity );
+		REQUIRE( large.size() == capacity );
+		large[capacity - 1] = Vec3::One;
+	}
+
+	SECTION( "marker" )
+	{
+		Arena arena( 128 );
+		arena.allocate( 40 );
+		const auto marker = arena.get_marker();
+		const size_t used = arena.get_used();
+		auto scratch = arena.allocate( 1000 );
+		arena.rewind( marker );
+		REQUIRE( arena.get_used() == used );
+
+		// Blocks added after the marker are reused
+		REQUIRE( arena.allocate( 1000 ) == scratch );
+		REQUIRE( arena.get_capacity() == 128 + 1000 );
+	}
+
+	SECTION( "views" )
+	{
+		Arena arena;
+		QuatView quats = arena.allocate<Quat>( 4, Quat::Identity );
+		View<const Quat> constant = quats;
+		REQUIRE( constant.data() == quats.data() );
+		REQUIRE( constant.size() == 4 );
+		REQUIRE( !constant.empty() );
+		REQUIRE( constant[3] == Quat::Identity );
+		REQUIRE( View<Vec3>().empty() );
+
+		auto moved = std::move( arena );
+		REQUIRE( moved.get_used() > 0 );
+		REQUIRE( arena.get_used() == 0 );
+		REQUIRE( arena.allocate<Vec3>( 2 ).size() == 2 );
+	}
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,151 @@
+#include "test.h"
+#include "spot/math/bounds.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace spot::math
+{
+
+
+/// @return An affine matrix with rotation, non uniform scale and translation
+Mat4 random_affine( std::mt19937& gen )
+{
+	std::uniform_real_distribution<float> offset( -50.0f, 50.0f );
+	std::uniform_real_distribution<float> factor( -3.0f, 3.0f );
+	return Mat4::from_trs( Vec3( offset( gen ), offset( gen ), offset( gen ) ),
+		random_rotation( gen ),
+		Vec3( factor( gen ), factor( gen ), factor( gen ) ) );
+}
+
+
+/// @return A box with its corners in any order
+Box random_corners( std::mt19937& gen )
+{
+	std::uniform_real_distribution<float> coord( -10.0f, 10.0f );
+	return Box( Vec3( coord( gen ), coord( gen ), coord( gen ) ), Vec3( coord( gen ), coord( gen ), coord( gen ) ) );
+}
+
+
+/// @return Bounds of the eight corners of a box transformed one by one
+Box transform_corners( const Mat4& m, const Box& box )
+{
+	Box ret( Vec3( INFINITY, INFINITY, INFINITY ), Vec3( -INFINITY, -INFINITY, -INFINITY ) );
+	for ( size_t i = 0; i < 8; ++i )
+	{
+		const float p[3] = { i & 1 ? box.b.x : box.a.x, i & 2 ? box.b.y : box.a.y, i & 4 ? box.b.z : box.a.z };
+		float       t[3];
+		for ( size_t row = 0; row < 3; ++row )
+		{
+			t[row] = m.matrix[row] * p[0] + m.matrix[row + 4] * p[1] + m.matrix[row + 8] * p[2] + m.matrix[row + 12];
+		}
+		ret.a = Vec3( std::min( ret.a.x, t[0] ), std::min( ret.a.y, t[1] ), std::min( ret.a.z, t[2] ) );
+		ret.b = Vec3( std::max( ret.b.x, t[0] ), std::max( ret.b.y, t[1] ), std::max( ret.b.z, t[2] ) );
+	}
+	return ret;
+}
+
+
+TEST_CASE( "Bounds" )
+{
+	std::mt19937 gen( 25 );
+
+	SECTION( "box" )
+	{
+		auto box = Box( Vec3( -1.0f, 2.0f, 3.0f ), Vec3( 4.0f, 5.0f, 6.0f ) );
+		auto same = Mat4::Identity * box;
+		REQUIRE( std::memcmp( &same, &box, sizeof( box ) ) == 0 );
+
+		// Corners given in any order come back as min and max
+		auto swapped = Mat4::Identity * Box( box.b, box.a );
+		REQUIRE( std::memcmp( &swapped, &box, sizeof( box ) ) == 0 );
+
+		// A quarter turn about Z swaps the extents along X and Y
+		auto turned = Mat4::Identity.rotate_z( 3.14159265f / 2.0f ) * box;
+		REQUIRE( turned.a.x == Approx( -5.0f ).margin( 1.0e-5f ) );
+		REQUIRE( turned.b.x == Approx( -2.0f ).margin( 1.0e-5f ) );
+		REQUIRE( turned.a.y == Approx( -1.0f ).margin( 1.0e-5f ) );
+		REQUIRE( turned.b.y == Approx( 4.0f ).margin( 1.0e-5f ) );
+		REQUIRE( turned.a.z == 3.0f );
+		REQUIRE( turned.b.z == 6.0f );
+
+		for ( size_t i = 0; i < 1000; ++i )
+		{
+			auto m = random_affine( gen );
+			auto b = random_corners( gen );
+			auto arvo = m * b;
+			auto corners = transform_corners( m, b );
+			REQUIRE( arvo.a.x == Approx( corners.a.x ).margin( 1.0e-3f ) );
+			REQUIRE( arvo.a.y == Approx( corners.a.y ).margin( 1.0e-3f ) );
+			REQUIRE( arvo.a.z == Approx( corners.a.z ).margin( 1.0e-3f ) );
+			REQUIRE( arvo.b.x == Approx( corners.b.x ).margin( 1.0e-3f ) );
+			REQUIRE( arvo.b.y == Approx( corners.b.y ).margin( 1.0e-3f ) );
+			REQUIRE( arvo.b.z == Approx( corners.b.z ).margin( 1.0e-3f ) );
+		}
+	}
+
+	SECTION( "rect" )
+	{
+		// The unit square turned by 45 degrees is as wide as its diagonal
+		auto rect = Mat4::Identity.rotate_z( 3.14159265f / 4.0f ) * Rect( Vec2( 0.5f, 0.5f ), Vec2( -0.5f, -0.5f ) );
+		REQUIRE( rect.b.x - rect.a.x == Approx( std::sqrt( 2.0f ) ) );
+		REQUIRE( rect.b.y - rect.a.y == Approx( std::sqrt( 2.0f ) ) );
+		REQUIRE( rect.a.x == Approx( -rect.b.x ) );
+
+		// Same as the box with no depth
+		for ( size_t i = 0; i < 1000; ++i )
+		{
+			auto m = random_affine( gen );
+			auto b = random_corners( gen );
+			auto r = m * Rect( Vec2( b.a.x, b.a.y ), Vec2( b.b.x, b.b.y ) );
+			auto corners = transform_corners( m, Box( Vec3( b.a.x, b.a.y, 0.0f ), Vec3( b.b.x, b.b.y, 0.0f ) ) );
+			REQUIRE( r.a.x == Approx( corners.a.x ).margin( 1.0e-3f ) );
+			REQUIRE( r.a.y == Approx( corners.a.y ).margin( 1.0e-3f ) );
+			REQUIRE( r.b.x == Approx( corners.b.x ).margin( 1.0e-3f ) );
+			REQUIRE( r.b.y == Approx( corners.b.y ).margin( 1.0e-3f ) );
+		}
+	}
+
+	SECTION( "batch" )
+	{
+		// Batches give the same results as one at a time, also in place
+		for ( size_t count : { 0, 1, 3, 5, 17 } )
+		{
+			std::vector<Mat4> matrices( count );
+			std::vector<Box>  boxes( count );
+			std::vector<Rect> rects( count );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				matrices[i] = random_affine( gen );
+				boxes[i]    = random_corners( gen );
+				rects[i]    = Rect( Vec2( boxes[i].a.x, boxes[i].a.y ), Vec2( boxes[i].b.x, boxes[i].b.y ) );
+			}
+			const Mat4 shared = random_affine( gen );
+
+			std::vector<Box>  shared_boxes( count );
+			std::vector<Box>  own_boxes( boxes );
+			std::vector<Rect> shared_rects( count );
+			std::vector<Rect> own_rects( rects );
+			transform_boxes( shared, boxes.data(), shared_boxes.data(), count );
+			transform_boxes( matrices.data(), own_boxes.data(), own_boxes.data(), count );
+			transform_rects( shared, rects.data(), shared_rects.data(), count );
+			transform_rects( matrices.data(), own_rects.data(), own_rects.data(), count );
+
+			for ( size_t i = 0; i < count; ++i )
+			{
+				auto sb = shared * boxes[i];
+				auto ob = matrices[i] * boxes[i];
+				auto sr = shared * rects[i];
+				auto orr = matrices[i] * rects[i];
+				REQUIRE( std::memcmp( &shared_boxes[i], &sb, sizeof( sb ) ) == 0 );
+				REQUIRE( std::memcmp( &own_boxes[i], &ob, sizeof( ob ) ) == 0 );
+				REQUIRE( std::memcmp( &shared_rects[i], &sr, sizeof( sr ) ) == 0 );
+				REQUIRE( std::memcmp( &own_rects[i], &orr, sizeof( orr ) ) == 0 );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,78 @@
+#include "test.h"
+#include "spot/math/box-soa.h"
+
+#include <random>
+
+namespace spot::math
+{
+
+
+TEST_CASE( "Box" )
+{
+	SECTION( "intersects" )
+	{
+		auto a = Box( { 0.0f, 0.0f, 0.0f }, { 2.0f, 2.0f, 2.0f } );
+
+		REQUIRE( a.intersects( Box( { 1.0f, 1.0f, 1.0f }, { 3.0f, 3.0f, 3.0f } ) ) );
+		REQUIRE( a.intersects( Box( { 0.5f, 0.5f, 0.5f }, { 1.0f, 1.0f, 1.0f } ) ) );
+
+		// Apart along a single axis
+		REQUIRE( !a.intersects( Box( { 3.0f, 0.0f, 0.0f }, { 4.0f, 2.0f, 2.0f } ) ) );
+		REQUIRE( !a.intersects( Box( { 0.0f, 3.0f, 0.0f }, { 2.0f, 4.0f, 2.0f } ) ) );
+		REQUIRE( !a.intersects( Box( { 0.0f, 0.0f, 3.0f }, { 2.0f, 2.0f, 4.0f } ) ) );
+		REQUIRE( !a.intersects( Box( { 0.0f, 0.0f, -2.0f }, { 2.0f, 2.0f, -1.0f } ) ) );
+
+		// Touching faces
+		REQUIRE( !a.intersects( Box( { 0.0f, 0.0f, 2.0f }, { 2.0f, 2.0f, 3.0f } ) ) );
+	}
+
+	SECTION( "batch" )
+	{
+		std::mt19937 gen( 42 );
+		std::uniform_real_distribution<float> position( -10.0f, 10.0f );
+		std::uniform_real_distribution<float> size( -4.0f, 4.0f );
+
+		// Sizes around the SIMD width and the mask words
+		for ( size_t count : { 0, 1, 3, 4, 5, 63, 64, 65, 200 } )
+		{
+			std::vector<Box> boxes( count );
+			for ( auto& box : boxes )
+			{
+				box.a = { position( gen ), position( gen ), position( gen ) };
+				box.b = box.a + Vec3( size( gen ), size( gen ), size( gen ) );
+			}
+			auto soa = BoxSoa( boxes );
+
+			auto query = Box( { -3.0f, -3.0f, -3.0f }, { 3.0f, 3.0f, 3.0f } );
+
+			std::vector<uint64_t> mask( ( count + 63 ) / 64, ~uint64_t( 0 ) );
+			intersects( query, soa, mask.data() );
+
+			std::vector<uint32_t> indices( count );
+			size_t found = intersects( query, soa, indices.data() );
+
+			std::vector<uint32_t> expected;
+			for ( uint32_t i = 0; i < count; ++i )
+			{
+				bool hit = Box( soa.min[i], soa.max[i] ).intersects( query );
+				REQUIRE( bool( ( mask[i / 64] >> ( i % 64 ) ) & 1 ) == hit );
+				if ( hit )
+				{
+					expected.push_back( i );
+				}
+			}
+
+			// Padding bits are clear
+			if ( count % 64 )
+			{
+				REQUIRE( ( mask.back() >> ( count % 64 ) ) == 0 );
+			}
+
+			indices.resize( found );
+			REQUIRE( indices == expected );
+		}
+	}
+}
+
+
+}  // namespace spot::math
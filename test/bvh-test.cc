@@ -0,0 +1,229 @@
+#include "test.h"
+#include "spot/math/bvh.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+
+namespace spot::math
+{
+
+
+std::vector<Box> random_boxes( std::mt19937& gen, const size_t count )
+{
+	std::uniform_real_distribution<float> position( -50.0f, 50.0f );
+	std::uniform_real_distribution<float> size( -2.0f, 2.0f );
+
+	std::vector<Box> ret( count );
+	for ( auto& box : ret )
+	{
+		// Some boxes have their corners swapped
+		box.a = { position( gen ), position( gen ), position( gen ) };
+		box.b = box.a + Vec3( size( gen ), size( gen ), size( gen ) );
+	}
+	return ret;
+}
+
+
+bool overlaps( const Box& a, const Box& b )
+{
+	for ( size_t i = 0; i < 3; ++i )
+	{
+		float amin = std::min( ( &a.a.x )[i], ( &a.b.x )[i] );
+		float amax = std::max( ( &a.a.x )[i], ( &a.b.x )[i] );
+		float bmin = std::min( ( &b.a.x )[i], ( &b.b.x )[i] );
+		float bmax = std::max( ( &b.a.x )[i], ( &b.b.x )[i] );
+		if ( amin >= bmax || amax <= bmin )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/// @return Distance where a ray enters a box, or a negative value when it misses it
+float hit_distance( const Box& box, const Vec3& origin, const Vec3& direction, float max_distance )
+{
+	float enter = 0.0f;
+	float leave = max_distance;
+	for ( size_t i = 0; i < 3; ++i )
+	{
+		float lo = std::min( ( &box.a.x )[i], ( &box.b.x )[i] );
+		float hi = std::max( ( &box.a.x )[i], ( &box.b.x )[i] );
+		float t0 = ( lo - ( &origin.x )[i] ) / ( &direction.x )[i];
+		float t1 = ( hi - ( &origin.x )[i] ) / ( &direction.x )[i];
+		enter    = std::max( enter, std::min( t0, t1 ) );
+		leave    = std::min( leave, std::max( t0, t1 ) );
+	}
+	return enter <= leave ? enter : -1.0f;
+}
+
+
+std::vector<uint32_t> brute_force( const std::vector<Box>& boxes, const Box& box )
+{
+	std::vector<uint32_t> ret;
+	for ( uint32_t i = 0; i < boxes.size(); ++i )
+	{
+		if ( overlaps( boxes[i], box ) )
+		{
+			ret.push_back( i );
+		}
+	}
+	return ret;
+}
+
+
+void check( const Bvh& bvh, const std::vector<Box>& boxes, std::mt19937& gen )
+{
+	std::uniform_real_distribution<float> position( -60.0f, 60.0f );
+	std::uniform_real_distribution<float> unit( -1.0f, 1.0f );
+
+	for ( size_t q = 0; q < 100; ++q )
+	{
+		auto min = Vec3( position( gen ), position( gen ), position( gen ) );
+		auto box = Box( min, min + Vec3( 10.0f, 10.0f, 10.0f ) );
+
+		std::vector<uint32_t> found;
+		bvh.query( box, found );
+		std::sort( found.begin(), found.end() );
+		REQUIRE( found == brute_force( boxes, box ) );
+
+		auto origin    = Vec3( position( gen ), position( gen ), position( gen ) );
+		auto direction = Vec3( unit( gen ), unit( gen ), unit( gen ) );
+		float max_distance = 100.0f;
+
+		std::vector<uint32_t> expected;
+		float closest = std::numeric_limits<float>::max();
+		for ( uint32_t i = 0; i < boxes.size(); ++i )
+		{
+			float distance = hit_distance( boxes[i], origin, direction, max_distance );
+			if ( distance >= 0.0f )
+			{
+				expected.push_back( i );
+				closest = std::min( closest, distance );
+			}
+		}
+
+		found.clear();
+		bvh.query( origin, direction, max_distance, found );
+		std::sort( found.begin(), found.end() );
+		REQUIRE( found == expected );
+
+		Bvh::Hit hit;
+		REQUIRE( bvh.raycast( origin, direction, max_distance, hit ) == !expected.empty() );
+		if ( !expected.empty() )
+		{
+			REQUIRE( hit.distance == Approx( closest ) );
+			REQUIRE( hit_distance( boxes[hit.index], origin, direction, max_distance ) == Approx( closest ) );
+		}
+	}
+}
+
+
+TEST_CASE( "Bvh" )
+{
+	std::mt19937 gen( 42 );
+	auto boxes = random_boxes( gen, 2000 );
+
+	SECTION( "empty" )
+	{
+		Bvh bvh;
+		bvh.build( {} );
+		std::vector<uint32_t> found;
+		bvh.query( Box( {}, Vec3::One ), found );
+		REQUIRE( found.empty() );
+		Bvh::Hit hit;
+		REQUIRE( !bvh.raycast( {}, Vec3::X, 10.0f, hit ) );
+	}
+
+	SECTION( "layout" )
+	{
+		Bvh bvh( boxes );
+		REQUIRE( sizeof( Bvh::Node ) == 32 );
+		REQUIRE( bvh.indices.size() == boxes.size() );
+		REQUIRE( bvh.nodes.size() < 2 * boxes.size() );
+
+		// Every primitive is in exactly one leaf, and inner nodes contain their children
+		std::vector<uint32_t> seen;
+		for ( size_t n = 0; n < bvh.nodes.size(); ++n )
+		{
+			auto& node = bvh.nodes[n];
+			if ( node.is_leaf() )
+			{
+				REQUIRE( node.count <= 4 );
+				for ( uint32_t i = node.offset; i < node.offset + node.count; ++i )
+				{
+					seen.push_back( bvh.indices[i] );
+				}
+				continue;
+			}
+
+			for ( auto child : { uint32_t( n + 1 ), node.offset } )
+			{
+				REQUIRE( child > n );
+				REQUIRE( bvh.nodes[child].min.x >= node.min.x );
+				REQUIRE( bvh.nodes[child].max.z <= node.max.z );
+			}
+		}
+		std::sort( seen.begin(), seen.end() );
+		for ( uint32_t i = 0; i < seen.size(); ++i )
+		{
+			REQUIRE( seen[i] == i );
+		}
+	}
+
+	SECTION( "queries" )
+	{
+		for ( uint32_t max_leaf : { 1, 4, 16 } )
+		{
+			Bvh bvh( boxes, max_leaf );
+			check( bvh, boxes, gen );
+		}
+	}
+
+	SECTION( "arena" )
+	{
+		// Scratch memory from an arena gives the same hierarchy, and is given back
+		Bvh reference( boxes );
+		Arena arena( 1024 );
+		Bvh bvh;
+		for ( size_t frame = 0; frame < 3; ++frame )
+		{
+			bvh.build( boxes, arena );
+			REQUIRE( arena.get_used() == 0 );
+			REQUIRE( bvh.nodes.size() == reference.nodes.size() );
+			REQUIRE( std::memcmp( bvh.nodes.data(), reference.nodes.data(), sizeof( Bvh::Node ) * bvh.nodes.size() ) == 0 );
+			REQUIRE( bvh.indices == reference.indices );
+		}
+		check( bvh, boxes, gen );
+	}
+
+	SECTION( "refit" )
+	{
+		Bvh bvh( boxes );
+
+		std::uniform_real_distribution<float> offset( -5.0f, 5.0f );
+		for ( auto& box : boxes )
+		{
+			auto delta = Vec3( offset( gen ), offset( gen ), offset( gen ) );
+			box.a += delta;
+			box.b += delta;
+		}
+
+		bvh.refit( boxes );
+		check( bvh, boxes, gen );
+	}
+
+	SECTION( "degenerate" )
+	{
+		// Equal centroids can not be split by SAH
+		std::vector<Box> same( 1000, Box( Vec3::Zero, Vec3::One ) );
+		Bvh bvh( same );
+		check( bvh, same, gen );
+	}
+}
+
+
+}  // namespace spot::math
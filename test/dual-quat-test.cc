@@ -0,0 +1,257 @@
+#include "test.h"
+#include "spot/math/skinning.h"
+
+#include <cstring>
+
+namespace spot::math
+{
+
+
+bool close_to( const Vec3& a, const Vec3& b, const float margin = 1e-5f )
+{
+	return a.x == Approx( b.x ).margin( margin ) &&
+		a.y == Approx( b.y ).margin( margin ) &&
+		a.z == Approx( b.z ).margin( margin );
+}
+
+
+Vec3 random_point( std::mt19937& gen )
+{
+	std::uniform_real_distribution<float> dist( -10.0f, 10.0f );
+	return { dist( gen ), dist( gen ), dist( gen ) };
+}
+
+
+DualQuat random_transform( std::mt19937& gen )
+{
+	return DualQuat::from_tr( random_point( gen ), random_rotation( gen ) );
+}
+
+
+TEST_CASE( "DualQuat" )
+{
+	std::mt19937 gen( 20 );
+
+	SECTION( "identity" )
+	{
+		auto p = Vec3( 1.0f, 2.0f, 3.0f );
+		REQUIRE( DualQuat::Identity * p == p );
+		REQUIRE( DualQuat::Identity.get_translation() == Vec3() );
+		REQUIRE( equals( DualQuat::Identity.get_mat4(), Mat4::Identity ) );
+	}
+
+	SECTION( "transform" )
+	{
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto t = random_point( gen );
+			auto r = random_rotation( gen );
+			auto dq = DualQuat::from_tr( t, r );
+			auto m = Mat4::from_trs( t, r, Vec3::One );
+			auto p = random_point( gen );
+
+			REQUIRE( close_to( dq.get_translation(), t ) );
+			REQUIRE( close_to( dq * p, m * p ) );
+			REQUIRE( close_to( dq.transform_vector( p ), rotate( r, p ) ) );
+			REQUIRE( equals( dq.get_mat4(), m, 1e-5f ) );
+
+			// Back from the matrix, the rotation may come back negated
+			auto from_m = DualQuat( m );
+			REQUIRE( close_to( from_m * p, dq * p, 1e-4f ) );
+		}
+	}
+
+	SECTION( "compose" )
+	{
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto a = random_transform( gen );
+			auto b = random_transform( gen );
+			auto p = random_point( gen );
+
+			REQUIRE( close_to( ( a * b ) * p, a * ( b * p ), 1e-4f ) );
+			REQUIRE( close_to( a.get_inverse() * ( a * p ), p, 1e-4f ) );
+
+			auto c = a;
+			c *= b;
+			REQUIRE( close_to( c * p, ( a * b ) * p ) );
+		}
+	}
+
+	SECTION( "blend" )
+	{
+		auto a = random_transform( gen );
+		auto p = random_point( gen );
+
+		float one = 1.0f;
+		REQUIRE( close_to( blend( &a, &one, 1 ) * p, a * p ) );
+
+		// A negated real part is the same rotation, blending it must not cancel out
+		DualQuat negated = { -a.real, -a.dual };
+		DualQuat both[] = { a, negated };
+		float halves[] = { 0.5f, 0.5f };
+		REQUIRE( close_to( blend( both, halves, 2 ) * p, a * p ) );
+
+		// Same rotation, translation halfway
+		auto r = random_rotation( gen );
+		DualQuat moved[] = { DualQuat::from_tr( Vec3( 2.0f, 0.0f, 0.0f ), r ), DualQuat::from_tr( Vec3( 0.0f, 4.0f, 0.0f ), r ) };
+		REQUIRE( close_to( blend( moved, halves, 2 ).get_translation(), Vec3( 1.0f, 2.0f, 0.0f ) ) );
+
+		// Unused transforms with no weight are not the pivot of the hemisphere, here
+		// two rotations close to half a turn about X blend to half a turn about X
+		auto turn = Quat( 0.1f, 0.99f, 0.0f, 0.0f );
+		auto back = Quat( -0.1f, 0.99f, 0.0f, 0.0f );
+		turn.normalize();
+		back.normalize();
+		DualQuat unused[] = { DualQuat::Identity, DualQuat::from_tr( Vec3(), turn ), DualQuat::from_tr( Vec3(), back ) };
+		float second_third[] = { 0.0f, 0.5f, 0.5f };
+		REQUIRE( close_to( blend( unused, second_third, 3 ).transform_vector( Vec3::Y ), -Vec3::Y ) );
+
+		// Blends are rigid, unlike linear blends of matrices
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			DualQuat dqs[] = { random_transform( gen ), random_transform( gen ) };
+			float weights[] = { 0.3f, 0.7f };
+			auto blended = blend( dqs, weights, 2 );
+
+			auto x = blended.transform_vector( Vec3::X );
+			auto y = blended.transform_vector( Vec3::Y );
+			REQUIRE( dot( blended.real, blended.real ) == Approx( 1.0f ) );
+			REQUIRE( Vec3::dot( x, x ) == Approx( 1.0f ) );
+			REQUIRE( Vec3::dot( x, y ) == Approx( 0.0f ).margin( 1e-6f ) );
+		}
+	}
+}
+
+
+TEST_CASE( "Skinning" )
+{
+	std::mt19937 gen( 21 );
+	std::uniform_real_distribution<float> weight( 0.0f, 1.0f );
+
+	std::vector<DualQuat> palette( 8 );
+	for ( auto& dq : palette )
+	{
+		dq = random_transform( gen );
+	}
+
+	// Counts covering whole SIMD registers, a tail, and less than one register
+	for ( size_t count : { 0, 3, 4, 9, 32 } )
+	{
+		DYNAMIC_SECTION( "count " << count )
+		{
+			std::vector<BoneInfluences> influences( count );
+			Vec3Soa positions( count );
+			Vec3Soa normals( count );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				auto& influence = influences[i];
+				float sum = 0.0f;
+				for ( size_t j = 0; j < BoneInfluences::Count; ++j )
+				{
+					influence.bones[j] = uint16_t( gen() % palette.size() );
+					influence.weights[j] = weight( gen );
+					sum += influence.weights[j];
+				}
+				for ( auto& w : influence.weights )
+				{
+					w /= sum;
+				}
+				// Some vertices with a single bone and unused influences
+				if ( i % 3 == 0 )
+				{
+					influence = {};
+					influence.bones[0] = uint16_t( i % palette.size() );
+					influence.weights[0] = 1.0f;
+				}
+				// Others with the first influence unused
+				else if ( i % 3 == 1 )
+				{
+					for ( size_t j = 1; j < BoneInfluences::Count; ++j )
+					{
+						influence.weights[j] /= 1.0f - influence.weights[0];
+					}
+					influence.weights[0] = 0.0f;
+				}
+
+				positions.set( i, random_point( gen ) );
+				auto n = random_point( gen );
+				n.normalize();
+				normals.set( i, n );
+			}
+
+			Vec3Soa out_positions;
+			Vec3Soa out_normals;
+			skin( palette.data(), influences.data(), positions, normals, out_positions, out_normals );
+			REQUIRE( out_positions.size() == count );
+			REQUIRE( out_normals.size() == count );
+
+			Vec3Soa only_positions;
+			skin( palette.data(), influences.data(), positions, only_positions );
+
+			for ( size_t i = 0; i < count; ++i )
+			{
+				// Vectorized vertices give the same bits of the scalar functions
+				DualQuat dqs[BoneInfluences::Count];
+				for ( size_t j = 0; j < BoneInfluences::Count; ++j )
+				{
+					dqs[j] = palette[influences[i].bones[j]];
+				}
+				auto dq = blend( dqs, influences[i].weights, BoneInfluences::Count );
+				auto p = dq * positions[i];
+				auto n = dq.transform_vector( normals[i] );
+				auto out_p = out_positions[i];
+				auto out_n = out_normals[i];
+				REQUIRE( std::memcmp( &p, &out_p, sizeof( Vec3 ) ) == 0 );
+				REQUIRE( std::memcmp( &n, &out_n, sizeof( Vec3 ) ) == 0 );
+				REQUIRE( out_p == only_positions[i] );
+				REQUIRE( Vec3::dot( out_n, out_n ) == Approx( 1.0f ) );
+
+				if ( i % 3 == 0 )
+				{
+					REQUIRE( close_to( out_positions[i], palette[influences[i].bones[0]] * positions[i] ) );
+				}
+			}
+
+			// Outputs may be the inputs
+			skin( palette.data(), influences.data(), positions, normals, positions, normals );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( positions[i] == out_positions[i] );
+				REQUIRE( normals[i] == out_normals[i] );
+			}
+		}
+	}
+
+	SECTION( "unused first influence" )
+	{
+		// Same as the blend test, for a whole register of vertices
+		auto turn = Quat( 0.1f, 0.99f, 0.0f, 0.0f );
+		auto back = Quat( -0.1f, 0.99f, 0.0f, 0.0f );
+		turn.normalize();
+		back.normalize();
+		DualQuat turns[] = { DualQuat::Identity, DualQuat::from_tr( Vec3(), turn ), DualQuat::from_tr( Vec3(), back ) };
+
+		BoneInfluences influence;
+		influence.bones[1] = 1;
+		influence.bones[2] = 2;
+		influence.weights[1] = 0.5f;
+		influence.weights[2] = 0.5f;
+		std::vector<BoneInfluences> influences( 5, influence );
+
+		Vec3Soa positions( influences.size() );
+		for ( size_t i = 0; i < positions.size(); ++i )
+		{
+			positions.set( i, Vec3::Y );
+		}
+		Vec3Soa out_positions;
+		skin( turns, influences.data(), positions, out_positions );
+		for ( size_t i = 0; i < out_positions.size(); ++i )
+		{
+			REQUIRE( close_to( out_positions[i], -Vec3::Y ) );
+		}
+	}
+}
+
+
+}  // namespace spot::math
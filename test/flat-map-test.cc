@@ -0,0 +1,82 @@
+#include "test.h"
+#include "spot/math/flat-map.h"
+
+#include <unordered_map>
+
+namespace spot::math
+{
+
+
+TEST_CASE( "FlatMap" )
+{
+	SECTION( "basics" )
+	{
+		FlatMap<int> map;
+		REQUIRE( map.empty() );
+		REQUIRE( map.find( 1 ) == nullptr );
+		REQUIRE( !map.erase( 1 ) );
+
+		REQUIRE( map.emplace( 1, 10 ).second );
+		REQUIRE( !map.emplace( 1, 20 ).second );
+		REQUIRE( *map.find( 1 ) == 10 );
+		*map.emplace( 2 ).first = 30;
+		REQUIRE( *map.find( 2 ) == 30 );
+		REQUIRE( map.size() == 2 );
+
+		// Any key is valid, there is no reserved one
+		REQUIRE( map.emplace( ~uint64_t( 0 ), 40 ).second );
+		REQUIRE( map.emplace( 0, 50 ).second );
+		REQUIRE( *map.find( ~uint64_t( 0 ) ) == 40 );
+		REQUIRE( *map.find( 0 ) == 50 );
+
+		REQUIRE( map.erase( 1 ) );
+		REQUIRE( !map.contains( 1 ) );
+		REQUIRE( map.size() == 3 );
+
+		map.clear();
+		REQUIRE( map.empty() );
+		REQUIRE( !map.contains( 2 ) );
+
+		FlatSet set;
+		REQUIRE( set.emplace( 7 ).second );
+		REQUIRE( set.contains( 7 ) );
+	}
+
+	SECTION( "random" )
+	{
+		// Few keys with many collisions and removals, against the standard map
+		std::mt19937 gen( 26 );
+		std::uniform_int_distribution<uint64_t> key( 0, 300 );
+
+		FlatMap<uint32_t> map;
+		std::unordered_map<uint64_t, uint32_t> expected;
+		for ( uint32_t i = 0; i < 20000; ++i )
+		{
+			const uint64_t k = key( gen ) << ( i % 2 ? 32 : 0 );
+			if ( gen() % 3 == 0 )
+			{
+				REQUIRE( map.erase( k ) == ( expected.erase( k ) > 0 ) );
+			}
+			else
+			{
+				REQUIRE( map.emplace( k, i ).second == expected.emplace( k, i ).second );
+			}
+			REQUIRE( map.size() == expected.size() );
+
+			const uint64_t probe = key( gen ) << ( i % 3 ? 32 : 0 );
+			auto it = expected.find( probe );
+			auto found = map.find( probe );
+			REQUIRE( ( it == expected.end() ? found == nullptr : found && *found == it->second ) );
+		}
+
+		size_t visited = 0;
+		map.for_each( [&]( const uint64_t k, const uint32_t value ) {
+			REQUIRE( expected.at( k ) == value );
+			++visited;
+		} );
+		REQUIRE( visited == expected.size() );
+	}
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,189 @@
+#include "test.h"
+#include "spot/math/frustum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace spot::math
+{
+
+
+/// @brief Right-handed perspective looking down -z
+Mat4 perspective( const float z_near, const float z_far, const ClipDepth depth )
+{
+	auto m = Mat4::Zero;
+	m( 0, 0 ) = 1.0f;
+	m( 1, 1 ) = 1.5f;
+	m( 3, 2 ) = -1.0f;
+	if ( depth == ClipDepth::ZeroToOne )
+	{
+		m( 2, 2 ) = z_far / ( z_near - z_far );
+		m( 2, 3 ) = z_far * z_near / ( z_near - z_far );
+	}
+	else
+	{
+		m( 2, 2 ) = ( z_far + z_near ) / ( z_near - z_far );
+		m( 2, 3 ) = 2.0f * z_far * z_near / ( z_near - z_far );
+	}
+	return m;
+}
+
+
+/// @brief Classifies a box by the clip coordinates of its corners, in double precision
+/// @param[out] ambiguous Whether a corner is too close to a plane to tell
+Cull classify_corners( const Mat4& m, const ClipDepth depth, const Box& box, bool& ambiguous )
+{
+	bool outside  = false;
+	bool crossing = false;
+	ambiguous     = false;
+
+	for ( size_t plane = 0; plane < Frustum::Count; ++plane )
+	{
+		double lowest  = INFINITY;
+		double highest = -INFINITY;
+		for ( size_t corner = 0; corner < 8; ++corner )
+		{
+			double p[4] = {
+				( corner & 1 ) ? box.b.x : box.a.x,
+				( corner & 2 ) ? box.b.y : box.a.y,
+				( corner & 4 ) ? box.b.z : box.a.z,
+				1.0,
+			};
+			double clip[4] = {};
+			for ( size_t row = 0; row < 4; ++row )
+			{
+				for ( size_t column = 0; column < 4; ++column )
+				{
+					clip[row] += m( row, column ) * p[column];
+				}
+			}
+
+			// Planes in the order of Frustum::Side
+			const double sign  = ( plane % 2 ) ? -1.0 : 1.0;
+			const double w     = ( plane == Frustum::Near && depth == ClipDepth::ZeroToOne ) ? 0.0 : clip[3];
+			const double value = w + sign * clip[plane / 2];
+			lowest             = std::min( lowest, value );
+			highest            = std::max( highest, value );
+		}
+
+		ambiguous |= std::abs( lowest ) < 1e-3 || std::abs( highest ) < 1e-3;
+		outside |= highest < 0.0;
+		crossing |= lowest < 0.0;
+	}
+
+	return outside ? Cull::Outside : crossing ? Cull::Intersecting : Cull::Inside;
+}
+
+
+TEST_CASE( "Frustum" )
+{
+	std::mt19937 gen( 42 );
+	std::uniform_real_distribution<float> position( -30.0f, 30.0f );
+	std::uniform_real_distribution<float> size( -6.0f, 6.0f );
+
+	SECTION( "planes" )
+	{
+		auto frustum = Frustum( perspective( 1.0f, 100.0f, ClipDepth::NegativeOneToOne ) );
+		for ( auto& plane : frustum.planes )
+		{
+			REQUIRE( Vec3::dot( plane.n, plane.n ) == Approx( 1.0f ) );
+		}
+		REQUIRE( frustum.planes[Frustum::Near].distance( Vec3( 0.0f, 0.0f, -1.0f ) ) == Approx( 0.0f ).margin( 1e-5 ) );
+		REQUIRE( frustum.planes[Frustum::Far].distance( Vec3( 0.0f, 0.0f, -100.0f ) ) == Approx( 0.0f ).margin( 1e-3 ) );
+		REQUIRE( frustum.planes[Frustum::Near].distance( Vec3( 0.0f, 0.0f, -2.0f ) ) == Approx( 1.0f ) );
+
+		auto zero_to_one = Frustum( perspective( 1.0f, 100.0f, ClipDepth::ZeroToOne ), ClipDepth::ZeroToOne );
+		REQUIRE( zero_to_one.planes[Frustum::Near].distance( Vec3( 0.0f, 0.0f, -1.0f ) ) == Approx( 0.0f ).margin( 1e-5 ) );
+		REQUIRE( zero_to_one.planes[Frustum::Far].distance( Vec3( 0.0f, 0.0f, -100.0f ) ) == Approx( 0.0f ).margin( 1e-3 ) );
+	}
+
+	SECTION( "spheres" )
+	{
+		auto frustum = Frustum( perspective( 1.0f, 100.0f, ClipDepth::NegativeOneToOne ) );
+		REQUIRE( frustum.classify( Sphere( { 0.0f, 0.0f, -10.0f }, 1.0f ) ) == Cull::Inside );
+		REQUIRE( frustum.classify( Sphere( { 0.0f, 0.0f, 10.0f }, 1.0f ) ) == Cull::Outside );
+		REQUIRE( frustum.classify( Sphere( { 0.0f, 0.0f, -1.0f }, 0.5f ) ) == Cull::Intersecting );
+		REQUIRE( frustum.classify( Sphere( { 0.0f, 0.0f, -120.0f }, 10.0f ) ) == Cull::Outside );
+		REQUIRE( frustum.classify( Sphere( { 20.0f, 0.0f, -10.0f }, 1.0f ) ) == Cull::Outside );
+		REQUIRE( frustum.classify( Sphere( { 10.0f, 0.0f, -10.0f }, 1.0f ) ) == Cull::Intersecting );
+	}
+
+	for ( auto depth : { ClipDepth::NegativeOneToOne, ClipDepth::ZeroToOne } )
+	{
+		DYNAMIC_SECTION( "boxes " << int( depth ) )
+		{
+			auto view = Mat4( Quat( Vec3( 1.0f, 2.0f, 0.5f ), 0.7f ) );
+			view.translate( Vec3( 3.0f, -2.0f, -10.0f ) );
+			auto view_projection = perspective( 0.5f, 50.0f, depth ) * view;
+			auto frustum         = Frustum( view_projection, depth );
+
+			std::vector<Box> boxes( 2000 );
+			for ( auto& box : boxes )
+			{
+				box.a = { position( gen ), position( gen ), position( gen ) };
+				box.b = box.a + Vec3( size( gen ), size( gen ), size( gen ) );
+			}
+
+			std::vector<Cull> culls( boxes.size() );
+			frustum.classify( boxes.data(), boxes.size(), culls.data() );
+
+			size_t counts[3] = {};
+			for ( size_t i = 0; i < boxes.size(); ++i )
+			{
+				REQUIRE( culls[i] == frustum.classify( boxes[i] ) );
+				++counts[size_t( culls[i] )];
+
+				bool ambiguous = false;
+				auto expected  = classify_corners( view_projection, depth, boxes[i], ambiguous );
+				if ( !ambiguous )
+				{
+					REQUIRE( culls[i] == expected );
+				}
+			}
+
+			// Every case is covered
+			REQUIRE( counts[0] > 0 );
+			REQUIRE( counts[1] > 0 );
+			REQUIRE( counts[2] > 0 );
+		}
+	}
+
+	SECTION( "cache" )
+	{
+		auto frustum = Frustum( perspective( 0.5f, 50.0f, ClipDepth::NegativeOneToOne ) );
+		auto step    = std::uniform_real_distribution<float>( -1.0f, 1.0f );
+
+		std::vector<Sphere> spheres( 1000 );
+		for ( auto& sphere : spheres )
+		{
+			sphere = Sphere( { position( gen ), position( gen ), position( gen ) }, std::abs( size( gen ) ) );
+		}
+
+		std::vector<uint8_t> cache( spheres.size() );
+		std::vector<Cull> cached( spheres.size() );
+		std::vector<Cull> culls( spheres.size() );
+
+		for ( size_t frame = 0; frame < 10; ++frame )
+		{
+			frustum.classify( spheres.data(), spheres.size(), cached.data(), cache.data() );
+			frustum.classify( spheres.data(), spheres.size(), culls.data() );
+			REQUIRE( cached == culls );
+
+			for ( size_t i = 0; i < spheres.size(); ++i )
+			{
+				REQUIRE( culls[i] == frustum.classify( spheres[i] ) );
+				if ( culls[i] == Cull::Outside )
+				{
+					// The cached plane rejects the sphere
+					auto& plane = frustum.planes[cache[i]];
+					REQUIRE( plane.distance( spheres[i].o ) < -spheres[i].r );
+				}
+				spheres[i].o += Vec3( step( gen ), step( gen ), step( gen ) );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
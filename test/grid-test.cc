@@ -0,0 +1,190 @@
+#include "test.h"
+#include "spot/math/grid.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace spot::math
+{
+
+
+using Pairs = std::vector<std::pair<RectGrid::Id, RectGrid::Id>>;
+
+
+bool overlaps( const Rect& a, const Rect& b )
+{
+	return std::min( a.a.x, a.b.x ) < std::max( b.a.x, b.b.x ) &&
+	       std::max( a.a.x, a.b.x ) > std::min( b.a.x, b.b.x ) &&
+	       std::min( a.a.y, a.b.y ) < std::max( b.a.y, b.b.y ) &&
+	       std::max( a.a.y, a.b.y ) > std::min( b.a.y, b.b.y );
+}
+
+
+TEST_CASE( "RectGrid" )
+{
+	std::mt19937 gen( 42 );
+	std::uniform_real_distribution<float> position( -100.0f, 100.0f );
+	std::uniform_real_distribution<float> size( -8.0f, 8.0f );
+
+	auto random_rect = [&]() {
+		auto a = Vec2( position( gen ), position( gen ) );
+		// Corners may be swapped, and some rects span several cells
+		return Rect( a, a + Vec2( size( gen ), size( gen ) ) );
+	};
+
+	SECTION( "normalized" )
+	{
+		RectGrid grid( 4.0f );
+		auto id = grid.insert( Rect( { 2.0f, 3.0f }, { -1.0f, 1.0f } ) );
+		REQUIRE( grid.get_rect( id ) == Rect( { -1.0f, 1.0f }, { 2.0f, 3.0f } ) );
+		REQUIRE( grid.size() == 1 );
+
+		std::vector<RectGrid::Id> found;
+		grid.query( Rect( { 0.0f, 0.0f }, { 1.0f, 2.0f } ), found );
+		REQUIRE( found == std::vector<RectGrid::Id> { id } );
+
+		// Touching edges do not overlap
+		found.clear();
+		grid.query( Rect( { 2.0f, 0.0f }, { 3.0f, 2.0f } ), found );
+		REQUIRE( found.empty() );
+
+		grid.remove( id );
+		REQUIRE( grid.size() == 0 );
+		REQUIRE( grid.insert( Rect() ) == id );
+	}
+
+	SECTION( "large" )
+	{
+		constexpr float inf = std::numeric_limits<float>::infinity();
+
+		RectGrid grid( 1.0f );
+		auto small = grid.insert( Rect( { 0.0f, 0.0f }, { 2.0f, 2.0f } ) );
+		auto far   = grid.insert( Rect( { 1.0e12f, 1.0e12f }, { 1.1e12f, 1.1e12f } ) );
+		auto huge  = grid.insert( Rect( { -1.0e30f, -1.0e30f }, { 1.0e30f, 1.0e30f } ) );
+		auto whole = grid.insert( Rect( { -inf, -inf }, { inf, inf } ) );
+
+		// Far rects are in the clamped cells, and large ones in no cell
+		std::vector<RectGrid::Id> found;
+		grid.query( Rect( { 1.0f, 1.0f }, { 1.5f, 1.5f } ), found );
+		std::sort( found.begin(), found.end() );
+		REQUIRE( found == std::vector<RectGrid::Id> { small, huge, whole } );
+
+		found.clear();
+		grid.query( Rect( { 1.05e12f, 1.05e12f }, { 1.06e12f, 1.06e12f } ), found );
+		std::sort( found.begin(), found.end() );
+		REQUIRE( found == std::vector<RectGrid::Id> { far, huge, whole } );
+
+		// A query over more cells than the grid looks at tests every rect
+		found.clear();
+		grid.query( Rect( { -inf, -inf }, { inf, inf } ), found );
+		std::sort( found.begin(), found.end() );
+		REQUIRE( found == std::vector<RectGrid::Id> { small, far, huge, whole } );
+
+		Pairs pairs;
+		grid.get_pairs( pairs );
+		std::sort( pairs.begin(), pairs.end() );
+		REQUIRE( pairs == Pairs { { small, huge }, { small, whole }, { far, huge }, { far, whole }, { huge, whole } } );
+
+		// Moving between the cells and the large rects
+		grid.move( small, Rect( { -100.0f, -100.0f }, { 100.0f, 100.0f } ) );
+		grid.move( huge, Rect( { 4.0f, 4.0f }, { 5.0f, 5.0f } ) );
+		pairs.clear();
+		grid.get_pairs( pairs );
+		std::sort( pairs.begin(), pairs.end() );
+		REQUIRE( pairs == Pairs { { small, huge }, { small, whole }, { far, whole }, { huge, whole } } );
+
+		grid.remove( whole );
+		grid.remove( small );
+		pairs.clear();
+		grid.get_pairs( pairs );
+		REQUIRE( pairs.empty() );
+		REQUIRE( grid.size() == 2 );
+	}
+
+	SECTION( "incremental" )
+	{
+		RectGrid grid( 5.0f );
+		std::vector<Rect> rects;
+		std::vector<RectGrid::Id> ids;
+		std::vector<bool> alive;
+
+		for ( size_t i = 0; i < 500; ++i )
+		{
+			rects.push_back( random_rect() );
+			ids.push_back( grid.insert( rects.back() ) );
+			alive.push_back( true );
+		}
+
+		std::uniform_int_distribution<size_t> pick( 0, rects.size() - 1 );
+		std::uniform_real_distribution<float> step( -2.0f, 2.0f );
+
+		for ( size_t frame = 0; frame < 10; ++frame )
+		{
+			for ( size_t i = 0; i < rects.size(); ++i )
+			{
+				if ( alive[i] )
+				{
+					auto delta = Vec2( step( gen ), step( gen ) );
+					rects[i].a += delta;
+					rects[i].b += delta;
+					grid.move( ids[i], rects[i] );
+				}
+			}
+
+			// Remove and reinsert a few rects
+			for ( size_t r = 0; r < 20; ++r )
+			{
+				auto i = pick( gen );
+				if ( alive[i] )
+				{
+					grid.remove( ids[i] );
+				}
+				else
+				{
+					rects[i] = random_rect();
+					ids[i]   = grid.insert( rects[i] );
+				}
+				alive[i] = !alive[i];
+			}
+
+			Pairs expected;
+			for ( size_t i = 0; i < rects.size(); ++i )
+			{
+				for ( size_t j = i + 1; j < rects.size(); ++j )
+				{
+					if ( alive[i] && alive[j] && overlaps( rects[i], rects[j] ) )
+					{
+						expected.emplace_back( std::min( ids[i], ids[j] ), std::max( ids[i], ids[j] ) );
+					}
+				}
+			}
+			std::sort( expected.begin(), expected.end() );
+
+			Pairs pairs;
+			grid.get_pairs( pairs );
+			std::sort( pairs.begin(), pairs.end() );
+			REQUIRE( !expected.empty() );
+			REQUIRE( pairs == expected );
+
+			auto query = random_rect();
+			std::vector<RectGrid::Id> found;
+			grid.query( query, found );
+			std::sort( found.begin(), found.end() );
+
+			std::vector<RectGrid::Id> brute;
+			for ( size_t i = 0; i < rects.size(); ++i )
+			{
+				if ( alive[i] && overlaps( rects[i], query ) )
+				{
+					brute.push_back( ids[i] );
+				}
+			}
+			std::sort( brute.begin(), brute.end() );
+			REQUIRE( found == brute );
+		}
+	}
+}
+
+
+}  // namespace spot::math
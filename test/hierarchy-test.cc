@@ -0,0 +1,259 @@
+#include "test.h"
+#include "spot/math/hierarchy.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+
+
+/// Calls of operator new by every test, to check that frames do not allocate
+std::atomic<size_t> allocations = 0;
+
+
+void* operator new( const size_t size )
+{
+	++allocations;
+	if ( void* ptr = std::malloc( size > 0 ? size : 1 ) )
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+
+void operator delete( void* const ptr ) noexcept
+{
+	std::free( ptr );
+}
+
+
+void operator delete( void* const ptr, size_t ) noexcept
+{
+	std::free( ptr );
+}
+
+
+namespace spot::math
+{
+
+
+/// @brief Computes every world matrix from scratch
+std::vector<Mat4> get_worlds( const Hierarchy& hierarchy )
+{
+	std::vector<Mat4> worlds( hierarchy.size() );
+	for ( Hierarchy::Id id = 0; id < hierarchy.size(); ++id )
+	{
+		auto local = Mat4::from_trs( hierarchy.get_translation( id ), hierarchy.get_rotation( id ), hierarchy.get_scale( id ) );
+		auto parent = hierarchy.get_parent( id );
+		worlds[id] = parent == Hierarchy::None ? local : worlds[parent] * local;
+	}
+	return worlds;
+}
+
+
+/// @brief Bitwise comparison, as Mat4::operator== has a large tolerance
+bool same( const std::vector<Mat4>& a, const std::vector<Mat4>& b )
+{
+	return a.size() == b.size() && std::memcmp( a.data(), b.data(), a.size() * sizeof( Mat4 ) ) == 0;
+}
+
+
+bool is_descendant( const Hierarchy& hierarchy, Hierarchy::Id id, const Hierarchy::Id ancestor )
+{
+	for ( ; id != Hierarchy::None; id = hierarchy.get_parent( id ) )
+	{
+		if ( id == ancestor )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+TEST_CASE( "Hierarchy" )
+{
+	std::mt19937 gen( 42 );
+	std::uniform_real_distribution<float> value( -2.0f, 2.0f );
+
+	auto random_rotation = [&]() { return Quat( Vec3( value( gen ), value( gen ), value( gen ) ), value( gen ) ); };
+	auto random_vec = [&]() { return Vec3( value( gen ), value( gen ), value( gen ) ); };
+
+	SECTION( "chain" )
+	{
+		Hierarchy hierarchy;
+		auto root  = hierarchy.add( Hierarchy::None, { 1.0f, 0.0f, 0.0f } );
+		auto child = hierarchy.add( root, { 0.0f, 2.0f, 0.0f } );
+		hierarchy.update();
+		REQUIRE( hierarchy.get_world( child ).get_translation() == Vec3( 1.0f, 2.0f, 0.0f ) );
+
+		hierarchy.set_scale( root, { 2.0f, 2.0f, 2.0f } );
+		hierarchy.update();
+		REQUIRE( hierarchy.get_world( child ).get_translation() == Vec3( 1.0f, 4.0f, 0.0f ) );
+		REQUIRE( hierarchy.is_updated( child ) );
+
+		hierarchy.update();
+		REQUIRE( !hierarchy.is_updated( root ) );
+		REQUIRE( !hierarchy.is_updated( child ) );
+	}
+
+	SECTION( "random" )
+	{
+		Hierarchy hierarchy;
+		for ( Hierarchy::Id id = 0; id < 1000; ++id )
+		{
+			// Shallow and deep branches
+			auto parent = Hierarchy::None;
+			if ( id > 0 && id % 50 != 0 )
+			{
+				parent = std::uniform_int_distribution<Hierarchy::Id>( id > 10 ? id - 10 : 0, id - 1 )( gen );
+			}
+			hierarchy.add( parent, random_vec(), random_rotation(), random_vec() );
+		}
+
+		hierarchy.update();
+		REQUIRE( same( hierarchy.get_worlds(), get_worlds( hierarchy ) ) );
+
+		std::uniform_int_distribution<Hierarchy::Id> pick( 0, Hierarchy::Id( hierarchy.size() - 1 ) );
+		for ( size_t frame = 0; frame < 10; ++frame )
+		{
+			std::vector<Hierarchy::Id> changed;
+			for ( size_t i = 0; i < 5; ++i )
+			{
+				auto id = pick( gen );
+				switch ( i % 3 )
+				{
+				case 0: hierarchy.set_translation( id, random_vec() ); break;
+				case 1: hierarchy.set_rotation( id, random_rotation() ); break;
+				default: hierarchy.set_local( id, random_vec(), random_rotation(), random_vec() ); break;
+				}
+				changed.push_back( id );
+			}
+
+			hierarchy.update();
+			REQUIRE( same( hierarchy.get_worlds(), get_worlds( hierarchy ) ) );
+
+			// Only the changed subtrees are recomputed
+			for ( Hierarchy::Id id = 0; id < hierarchy.size(); ++id )
+			{
+				bool expected = false;
+				for ( auto ancestor : changed )
+				{
+					expected |= is_descendant( hierarchy, id, ancestor );
+				}
+				REQUIRE( hierarchy.is_updated( id ) == expected );
+			}
+		}
+	}
+
+	SECTION( "parallel" )
+	{
+		Hierarchy serial;
+		for ( Hierarchy::Id id = 0; id < 5000; ++id )
+		{
+			auto parent = id < 8 ? Hierarchy::None : std::uniform_int_distribution<Hierarchy::Id>( id / 2, id - 1 )( gen );
+			serial.add( parent, random_vec(), random_rotation(), random_vec() );
+		}
+		auto parallel = serial;
+
+		ThreadPool pool( 4 );
+		for ( size_t frame = 0; frame < 5; ++frame )
+		{
+			serial.update();
+			parallel.update( pool.get_executor(), 64 );
+			REQUIRE( same( parallel.get_worlds(), serial.get_worlds() ) );
+
+			for ( Hierarchy::Id id = 0; id < serial.size(); ++id )
+			{
+				REQUIRE( parallel.is_updated( id ) == serial.is_updated( id ) );
+			}
+
+			// Half of the nodes dirty, then only a few
+			std::uniform_int_distribution<Hierarchy::Id> pick( 0, Hierarchy::Id( serial.size() - 1 ) );
+			for ( size_t i = 0; i < ( frame % 2 ? 10 : serial.size() / 2 ); ++i )
+			{
+				auto id          = pick( gen );
+				auto translation = random_vec();
+				serial.set_translation( id, translation );
+				parallel.set_translation( id, translation );
+			}
+		}
+
+		// Once built, updates allocate nothing, for any number of levels
+		auto executor = pool.get_executor();
+		parallel.set_translation( 0, random_vec() );
+		const size_t before = allocations;
+		parallel.update( executor, 64 );
+		REQUIRE( allocations == before );
+
+		// Tasks are only given the nodes from the first dirty one, at the depths of dirty ones
+		size_t tasks = 0;
+		auto counting = [&tasks]( size_t count, const std::function<void( size_t )>& task ) {
+			for ( size_t i = 0; i < count; ++i )
+			{
+				task( i );
+				++tasks;
+			}
+		};
+		const Hierarchy::Id late = Hierarchy::Id( serial.size() - 1000 );
+		serial.set_translation( 0, parallel.get_translation( 0 ) );
+		serial.set_scale( late, random_vec() );
+		parallel.set_scale( late, serial.get_scale( late ) );
+		serial.update();
+		parallel.update( counting, 64 );
+		REQUIRE( same( parallel.get_worlds(), serial.get_worlds() ) );
+		// A pass over every node takes at least size / grain tasks
+		REQUIRE( tasks > 0 );
+		REQUIRE( tasks < serial.size() / 64 / 4 );
+
+		// A few dirty nodes at the end are updated serially
+		tasks = 0;
+		const Hierarchy::Id last = Hierarchy::Id( serial.size() - 1 );
+		serial.set_scale( last, random_vec() );
+		parallel.set_scale( last, serial.get_scale( last ) );
+		serial.update();
+		parallel.update( counting, 64 );
+		REQUIRE( same( parallel.get_worlds(), serial.get_worlds() ) );
+		REQUIRE( tasks == 0 );
+
+		// Any executor running every task works, even a serial one
+		serial.set_translation( 0, random_vec() );
+		parallel.set_translation( 0, serial.get_translation( 0 ) );
+		serial.update();
+		parallel.update( []( size_t count, const std::function<void( size_t )>& task ) {
+			for ( size_t i = count; i > 0; --i )
+			{
+				task( i - 1 );
+			}
+		} );
+		REQUIRE( same( parallel.get_worlds(), serial.get_worlds() ) );
+	}
+}
+
+
+TEST_CASE( "ThreadPool" )
+{
+	for ( size_t threads : { 1, 2, 8 } )
+	{
+		ThreadPool pool( threads );
+		REQUIRE( pool.size() == threads );
+
+		for ( size_t count : { 0, 1, 7, 1000 } )
+		{
+			std::vector<std::atomic<uint32_t>> runs( count );
+			for ( size_t batch = 0; batch < 20; ++batch )
+			{
+				pool.run( count, [&]( size_t i ) { ++runs[i]; } );
+			}
+			for ( auto& run : runs )
+			{
+				REQUIRE( run == 20 );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
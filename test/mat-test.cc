@@ -0,0 +1,119 @@
+#include "test.h"
+#include "spot/math/mat.h"
+
+#include <cstring>
+
+namespace spot::math
+{
+
+
+static_assert( std::is_same_v<Mat4f, Mat4> );
+static_assert( sizeof( Mat4 ) == 16 * sizeof( float ) );
+
+// Elements are in column-major order
+static_assert( Mat2i( 1, 2, 3, 4 )( 0, 1 ) == 3 );
+static_assert( Mat2i( 1, 2, 3, 4 ).get_transposed() == Mat2i( 1, 3, 2, 4 ) );
+static_assert( Mat<2, 3, int>( 1, 2, 3, 4, 5, 6 ).get_transposed()( 2, 1 ) == 6 );
+static_assert( Mat2i( 1, 2, 3, 4 ) * Mat2i( 5, 6, 7, 8 ) == Mat2i( 23, 34, 31, 46 ) );
+static_assert( Mat2i( 1, 2, 3, 4 ) * Vec2i( 1, 1 ) == Vec2i( 4, 6 ) );
+static_assert( Mat<2, 3, int>( 1, 2, 3, 4, 5, 6 ) * Vec3i( 1, 0, 1 ) == Vec2i( 6, 8 ) );
+static_assert( Mat3i::Identity * Vec3i( 1, 2, 3 ) == Vec3i( 1, 2, 3 ) );
+static_assert( Mat2i( 1, 2, 3, 4 ) + Mat2i::Identity - 2 * Mat2i::Identity == Mat2i( 0, 2, 3, 3 ) );
+static_assert( Mat2i( 1, 2, 3, 4 ).get_determinant() == -2 );
+static_assert( Mat3i( 2, 0, 0, 0, 3, 0, 0, 0, 4 ).get_determinant() == 24 );
+static_assert( Mat4i::Identity.get_determinant() == 1 );
+static_assert( Mat3d( 2, 0, 0, 0, 4, 0, 0, 0, 8 ).get_inverse() == Mat3d( 0.5, 0, 0, 0, 0.25, 0, 0, 0, 0.125 ) );
+static_assert( Mat3i( Mat3d::Identity * 2.0 ) == Mat3i::Identity * 2 );
+static_assert( Mat<5, 5, int>::Identity.get_determinant() == 1 );
+
+
+/// @return A 4x4 matrix of small integers, whose products are exact in floating point
+Mat4i random_mat4i( std::mt19937& gen )
+{
+	std::uniform_int_distribution<int32_t> dist( -8, 8 );
+	return Mat4i::generate( [&]( size_t, size_t ) { return dist( gen ); } );
+}
+
+
+TEST_CASE( "Mat" )
+{
+	std::mt19937 gen( 21 );
+
+	SECTION( "rows and columns" )
+	{
+		auto m = Mat<2, 3, int>( 1, 2, 3, 4, 5, 6 );
+		REQUIRE( m.get_column( 1 ) == Vec2i( 3, 4 ) );
+		REQUIRE( m.get_row( 1 ) == Vec3i( 2, 4, 6 ) );
+		m( 1, 2 ) = 0;
+		REQUIRE( m.matrix[5] == 0 );
+	}
+
+	SECTION( "mat4" )
+	{
+		auto m = Mat4::Identity.translate( Vec3( 1.0f, 2.0f, 3.0f ) );
+		m.rotate_y( 0.3f );
+		REQUIRE( m( 0, 3 ) == m.matrix[12] );
+		REQUIRE( m.get_column( 3 ) == Vec4( m.get_translation() ) );
+		REQUIRE( m.get_row( 3 ) == Vec4( 0.0f, 0.0f, 0.0f, 1.0f ) );
+		REQUIRE( m.get_transposed().get_row( 3 ) == m.get_column( 3 ) );
+
+		auto d = Mat4d( m );
+		auto back = Mat4( d );
+		REQUIRE( std::memcmp( &back, &m, sizeof( Mat4 ) ) == 0 );
+		REQUIRE( Mat3f( m.get_minor( 3, 3 ) ) == Mat3f( d.get_minor( 3, 3 ) ) );
+
+		// The generic operators of Mat apply to Mat4 as well
+		auto zero = m - m;
+		REQUIRE( std::memcmp( &zero, &Mat4::Zero, sizeof( Mat4 ) ) == 0 );
+		auto twice = m * 2.0f;
+		REQUIRE( twice.matrix[12] == 2.0f * m.matrix[12] );
+
+		// Rotations of double matrices
+		auto q = Quat( Vec3( 0.0f, 1.0f, 0.0f ), 0.3f );
+		auto qd = Quatd( Mat4d( Mat4( q ) ) );
+		REQUIRE( std::abs( qd.w - double( q.w ) ) < 1e-6 );
+		REQUIRE( std::abs( qd.y - double( q.y ) ) < 1e-6 );
+	}
+
+	SECTION( "products" )
+	{
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto a = random_mat4i( gen );
+			auto b = random_mat4i( gen );
+			auto expected = a * b;
+
+			REQUIRE( Mat4i( Mat4d( a ) * Mat4d( b ) ) == expected );
+			REQUIRE( Mat4i( Mat4f( a ) * Mat4f( b ) ) == expected );
+
+			auto c = Mat4d( a );
+			c *= Mat4d( b );
+			REQUIRE( Mat4i( c ) == expected );
+
+			// Outputs computed before being stored
+			auto d = Mat4d( a );
+			d = d * d;
+			REQUIRE( Mat4i( d ) == a * a );
+		}
+	}
+
+	SECTION( "inverse" )
+	{
+		std::uniform_real_distribution<double> dist( -1.0, 1.0 );
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto m = Mat4d::generate( [&]( size_t row, size_t column ) { return dist( gen ) + ( row == column ? 4.0 : 0.0 ); } );
+			auto identity = m * m.get_inverse();
+			for ( size_t e = 0; e < 16; ++e )
+			{
+				REQUIRE( identity.matrix[e] == Approx( Mat4d::Identity.matrix[e] ).margin( 1e-12 ) );
+			}
+
+			auto m3 = Mat3d::generate( [&]( size_t row, size_t column ) { return m( row, column ); } );
+			REQUIRE( m3.get_determinant() * m3.get_inverse().get_determinant() == Approx( 1.0 ) );
+		}
+	}
+}
+
+
+}  // namespace spot::math
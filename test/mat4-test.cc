@@ -1,14 +1,19 @@
 #include "test.h"
 
+#include <cstring>
+#include <random>
+
+#include <spot/math/simd.h>
+
 
 namespace spot::math
 {
 
-bool equals( const Mat4& a, const Mat4& b )
+bool equals( const Mat4& a, const Mat4& b, const float margin )
 {
 	for ( size_t i = 0; i < 16; ++i )
 	{
-		auto target = Approx( a.matrix[i] ).margin( std::numeric_limits<float>::epsilon() * 2.0f );
+		auto target = Approx( a.matrix[i] ).margin( margin );
 		if ( b.matrix[i] != target )
 		{
 			return false;
@@ -91,6 +96,285 @@ TEST_CASE( "Mat4" )
 
 		REQUIRE( tr == Mat4::Identity.translate( { 2.0f, 3.0f, 4.0f } ) );
 	}
+
+	SECTION( "trs" )
+	{
+		auto t = Vec3( 1.0f, 2.0f, 3.0f );
+		auto r = Quat( Vec3( 1.0f, 1.0f, 0.0f ) / std::sqrt( 2.0f ), radians( 60.0f ) );
+		auto s = Vec3( 2.0f, 0.5f, 3.0f );
+
+		auto tr = Mat4::Identity.translate( t );
+		auto rot = Mat4( r );
+		auto sc = Mat4::Identity.scale( s );
+
+		auto trs = tr * rot * sc;
+		REQUIRE( equals( trs, Mat4::from_trs( t, r, s ) ) );
+
+		auto m = trs;
+		m.matrix[3] = 0.25f;
+
+		SECTION( "pre" )
+		{
+			REQUIRE( equals( tr * m, Mat4( m ).pre_translate( t ) ) );
+			REQUIRE( equals( rot * m, Mat4( m ).pre_rotate( r ) ) );
+			REQUIRE( equals( sc * m, Mat4( m ).pre_scale( s ) ) );
+			REQUIRE( equals( rot * m, Mat4( m ).rotate( r ) ) );
+		}
+
+		SECTION( "post" )
+		{
+			REQUIRE( equals( m * tr, Mat4( m ).post_translate( t ) ) );
+#ifdef SPOT_MATH_FAST
+			// Fast normalization leaves r a few ULP away from the unit length post_rotate
+			// expects, while Mat4( r ) divides by its length
+			REQUIRE( equals( m * rot, Mat4( m ).post_rotate( r ), 1e-6f ) );
+#else
+			REQUIRE( equals( m * rot, Mat4( m ).post_rotate( r ) ) );
+#endif
+			REQUIRE( equals( m * sc, Mat4( m ).post_scale( s ) ) );
+		}
+
+		SECTION( "axis" )
+		{
+			// Rotation matrices written out in column-major order, right-handed
+			const float c = std::cos( radians( 30.0f ) );
+			const float s = std::sin( radians( 30.0f ) );
+			auto x = Mat4{
+				1.0f, 0.0f, 0.0f, 0.0f,
+				0.0f, c, s, 0.0f,
+				0.0f, -s, c, 0.0f,
+				0.0f, 0.0f, 0.0f, 1.0f
+			};
+			auto y = Mat4{
+				c, 0.0f, -s, 0.0f,
+				0.0f, 1.0f, 0.0f, 0.0f,
+				s, 0.0f, c, 0.0f,
+				0.0f, 0.0f, 0.0f, 1.0f
+			};
+			auto z = Mat4{
+				c, s, 0.0f, 0.0f,
+				-s, c, 0.0f, 0.0f,
+				0.0f, 0.0f, 1.0f, 0.0f,
+				0.0f, 0.0f, 0.0f, 1.0f
+			};
+
+			// The const overloads return a rotated copy
+			const Mat4& copy = m;
+
+			auto a = m;
+			a.rotate_x( radians( 30.0f ) );
+			REQUIRE( equals( x * m, a ) );
+			REQUIRE( equals( x * m, copy.rotate_x( radians( 30.0f ) ) ) );
+
+			a = m;
+			a.rotate_y( radians( 30.0f ) );
+			REQUIRE( equals( y * m, a ) );
+			REQUIRE( equals( y * m, copy.rotate_y( radians( 30.0f ) ) ) );
+
+			a = m;
+			a.rotate_z( radians( 30.0f ) );
+			REQUIRE( equals( z * m, a ) );
+			REQUIRE( equals( z * m, copy.rotate_z( radians( 30.0f ) ) ) );
+		}
+	}
+
+	SECTION( "inverse" )
+	{
+		auto m = Mat4::Identity.rotate_z( radians( 30.0f ) );
+		m.translate( { 1.0f, 2.0f, 3.0f } );
+		REQUIRE( m.get_determinant() == Approx( 1.0f ) );
+		REQUIRE( equals( Mat4::Identity, m * m.get_inverse() ) );
+		REQUIRE( equals( m.get_inverse(), m.get_inverse_rigid() ) );
+		REQUIRE( equals( m.get_inverse(), m.get_inverse_affine() ) );
+
+		auto projective = Mat4{
+			2.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 3.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, -1.0f, -1.0f,
+			0.0f, 0.0f, -0.2f, 0.0f
+		};
+		REQUIRE( projective.get_determinant() == Approx( -1.2f ) );
+		REQUIRE( equals( Mat4::Identity, projective.get_inverse() * projective ) );
+
+		Mat4 batch[] = { m, projective };
+		invert( batch, batch, 2 );
+		REQUIRE( equals( m.get_inverse(), batch[0] ) );
+		REQUIRE( equals( projective.get_inverse(), batch[1] ) );
+	}
+
+	SECTION( "vec4" )
+	{
+		auto tr = Mat4::Identity.translate( { 2.0f, 3.0f, 4.0f } );
+		REQUIRE( tr * Vec4( 1.0f, 1.0f, 1.0f, 1.0f ) == Vec4( 3.0f, 4.0f, 5.0f, 1.0f ) );
+		REQUIRE( tr * Vec4( 1.0f, 1.0f, 1.0f, 0.0f ) == Vec4( 1.0f, 1.0f, 1.0f, 0.0f ) );
+	}
+}
+
+
+TEST_CASE( "Mat4 kernels" )
+{
+	std::mt19937 gen( 42 );
+	std::uniform_real_distribution<float> dist( -10.0f, 10.0f );
+
+	auto random_floats = [&]( float* f, size_t count ) {
+		for ( size_t i = 0; i < count; ++i )
+		{
+			f[i] = dist( gen );
+		}
+	};
+
+	const auto& scalar = get_mat4_kernels( Simd::Scalar );
+
+	for ( auto simd : { Simd::Sse2, Simd::Avx, Simd::Avx2 } )
+	{
+		if ( simd > get_simd_support() )
+		{
+			continue;
+		}
+
+		const auto& kernels = get_mat4_kernels( simd );
+
+		// FMA skips the rounding of the products
+		const bool exact = simd != Simd::Avx2;
+
+		for ( size_t n = 0; n < 256; ++n )
+		{
+			Mat4 a;
+			Mat4 b;
+			Vec4 v;
+			random_floats( a.matrix, 16 );
+			random_floats( b.matrix, 16 );
+			random_floats( &v.x, 4 );
+
+			Mat4 expected;
+			Mat4 result;
+			scalar.mul( a.matrix, b.matrix, expected.matrix );
+			kernels.mul( a.matrix, b.matrix, result.matrix );
+
+			Vec4 expected_v;
+			Vec4 result_v;
+			scalar.mul_vec4( a.matrix, &v.x, &expected_v.x );
+			kernels.mul_vec4( a.matrix, &v.x, &result_v.x );
+
+			if ( exact )
+			{
+				REQUIRE( std::memcmp( expected.matrix, result.matrix, sizeof( expected.matrix ) ) == 0 );
+				REQUIRE( std::memcmp( &expected_v, &result_v, sizeof( Vec4 ) ) == 0 );
+			}
+			else
+			{
+				for ( size_t i = 0; i < 16; ++i )
+				{
+					REQUIRE( result.matrix[i] == Approx( expected.matrix[i] ).margin( 1e-3f ) );
+				}
+				for ( size_t i = 0; i < 4; ++i )
+				{
+					REQUIRE( ( &result_v.x )[i] == Approx( ( &expected_v.x )[i] ).margin( 1e-3f ) );
+				}
+			}
+
+			// Output aliasing an operand
+			kernels.mul( a.matrix, b.matrix, b.matrix );
+			REQUIRE( std::memcmp( result.matrix, b.matrix, sizeof( b.matrix ) ) == 0 );
+			kernels.mul( a.matrix, a.matrix, result.matrix );
+			kernels.mul( a.matrix, a.matrix, a.matrix );
+			REQUIRE( std::memcmp( result.matrix, a.matrix, sizeof( a.matrix ) ) == 0 );
+		}
+	}
+
+	SECTION( "inverse" )
+	{
+		for ( size_t n = 0; n < 64; ++n )
+		{
+			Mat4 m;
+			random_floats( m.matrix, 16 );
+
+			Mat4 expected;
+			auto expected_det = scalar.inverse( m.matrix, expected.matrix );
+			REQUIRE( scalar.determinant( m.matrix ) == expected_det );
+
+			for ( auto simd : { Simd::Sse2, Simd::Avx, Simd::Avx2 } )
+			{
+				const auto& kernels = get_mat4_kernels( simd );
+
+				Mat4 result = m;
+				auto det = kernels.inverse( result.matrix, result.matrix );
+				REQUIRE( det == Approx( expected_det ).epsilon( 1e-4f ) );
+				REQUIRE( kernels.determinant( m.matrix ) == Approx( expected_det ).epsilon( 1e-4f ) );
+				for ( size_t i = 0; i < 16; ++i )
+				{
+					REQUIRE( result.matrix[i] == Approx( expected.matrix[i] ).epsilon( 1e-3f ).margin( 1e-5f ) );
+				}
+			}
+		}
+	}
+
+	SECTION( "transform" )
+	{
+		auto m = Mat4::Identity.rotate_x( radians( 30.0f ) ).translate( { 1.0f, 2.0f, 3.0f } );
+		m.matrix[3] = 0.01f;
+
+		std::vector<Vec3> points( 37 );
+		random_floats( &points[0].x, points.size() * 3 );
+
+		std::vector<Vec3> expected( points.size() );
+		transform_points( m, points.data(), expected.data(), points.size() );
+		for ( size_t i = 0; i < points.size(); ++i )
+		{
+			auto p = m * points[i];
+			REQUIRE( expected[i].x == Approx( p.x ) );
+			REQUIRE( expected[i].y == Approx( p.y ) );
+			REQUIRE( expected[i].z == Approx( p.z ) );
+		}
+
+		std::vector<Vec3> expected_affine( points.size() );
+		std::vector<Vec3> expected_vectors( points.size() );
+		scalar.transform_points( m.matrix, &points[0].x, &expected[0].x, points.size() );
+		scalar.transform_points_affine( m.matrix, &points[0].x, &expected_affine[0].x, points.size() );
+		scalar.transform_vectors( m.matrix, &points[0].x, &expected_vectors[0].x, points.size() );
+
+		auto vector = m * Vec4( points[5], 0.0f );
+		REQUIRE( expected_vectors[5].x == Approx( vector.x ) );
+		REQUIRE( expected_vectors[5].y == Approx( vector.y ) );
+		REQUIRE( expected_vectors[5].z == Approx( vector.z ) );
+
+		for ( auto simd : { Simd::Sse2, Simd::Avx, Simd::Avx2 } )
+		{
+			if ( simd > get_simd_support() )
+			{
+				continue;
+			}
+
+			const auto& kernels = get_mat4_kernels( simd );
+
+			auto check = [&]( const std::vector<Vec3>& a, const std::vector<Vec3>& b ) {
+				if ( simd != Simd::Avx2 )
+				{
+					REQUIRE( std::memcmp( a.data(), b.data(), a.size() * sizeof( Vec3 ) ) == 0 );
+					return;
+				}
+				for ( size_t i = 0; i < a.size(); ++i )
+				{
+					REQUIRE( b[i].x == Approx( a[i].x ).margin( 1e-4f ) );
+					REQUIRE( b[i].y == Approx( a[i].y ).margin( 1e-4f ) );
+					REQUIRE( b[i].z == Approx( a[i].z ).margin( 1e-4f ) );
+				}
+			};
+
+			// In place
+			auto result = points;
+			kernels.transform_points( m.matrix, &result[0].x, &result[0].x, result.size() );
+			check( expected, result );
+
+			result = points;
+			kernels.transform_points_affine( m.matrix, &result[0].x, &result[0].x, result.size() );
+			check( expected_affine, result );
+
+			result = points;
+			kernels.transform_vectors( m.matrix, &result[0].x, &result[0].x, result.size() );
+			check( expected_vectors, result );
+		}
+	}
 }
 
 
@@ -0,0 +1,229 @@
+#include "test.h"
+#include "spot/math/packed.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace spot::math
+{
+
+
+static_assert( sizeof( HalfVec3 ) == 6 );
+static_assert( sizeof( QuantizedVec3 ) == 6 );
+static_assert( sizeof( PackedQuat48 ) == 6 );
+static_assert( sizeof( PackedQuat32 ) == 4 );
+
+
+float from_bits( const uint32_t u )
+{
+	float f;
+	std::memcpy( &f, &u, sizeof( f ) );
+	return f;
+}
+
+
+/// @return The largest difference of the components of two quaternions, up to a sign
+float get_distance( const Quat& a, const Quat& b )
+{
+	const float s = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z < 0.0f ? -1.0f : 1.0f;
+	return std::max( std::max( std::abs( a.w - s * b.w ), std::abs( a.x - s * b.x ) ),
+		std::max( std::abs( a.y - s * b.y ), std::abs( a.z - s * b.z ) ) );
+}
+
+
+TEST_CASE( "Packed" )
+{
+	std::mt19937 gen( 23 );
+
+	SECTION( "half" )
+	{
+		REQUIRE( to_half( 1.0f ) == 0x3c00 );
+		REQUIRE( to_half( -2.0f ) == 0xc000 );
+		REQUIRE( to_half( -0.0f ) == 0x8000 );
+		REQUIRE( to_half( 65504.0f ) == 0x7bff );
+		// Ties to even, the last one up to infinity
+		REQUIRE( to_half( 1.0f + 1.0f / 2048.0f ) == 0x3c00 );
+		REQUIRE( to_half( 1.0f + 3.0f / 2048.0f ) == 0x3c02 );
+		REQUIRE( to_half( 65520.0f ) == 0x7c00 );
+		REQUIRE( to_half( 1.0e10f ) == 0x7c00 );
+		REQUIRE( to_half( -INFINITY ) == 0xfc00 );
+		// Subnormals, the smallest being 2^-24
+		REQUIRE( to_half( std::ldexp( 1.0f, -24 ) ) == 0x0001 );
+		REQUIRE( to_half( std::ldexp( 1.0f, -25 ) ) == 0x0000 );
+		REQUIRE( to_half( std::ldexp( 3.0f, -25 ) ) == 0x0002 );
+		REQUIRE( to_half( std::ldexp( 1.0f, -15 ) ) == 0x0200 );
+		REQUIRE( ( to_half( NAN ) & 0x7e00 ) == 0x7e00 );
+		REQUIRE( to_half( from_bits( 0x7f802000 ) ) == 0x7e01 );
+
+		// Every half goes back to itself, NaNs becoming quiet
+		for ( uint32_t h = 0; h < 0x10000; ++h )
+		{
+			const float f = from_half( uint16_t( h ) );
+			if ( ( h & 0x7fff ) > 0x7c00 )
+			{
+				REQUIRE( std::isnan( f ) );
+				REQUIRE( to_half( f ) == ( h | 0x200 ) );
+			}
+			else
+			{
+				REQUIRE( to_half( f ) == h );
+			}
+		}
+
+		// Error bounds, relative for normal halves and absolute for subnormal ones
+		std::uniform_real_distribution<float> exponent( -30.0f, 15.9f );
+		for ( size_t i = 0; i < 10000; ++i )
+		{
+			const float f = std::exp2( exponent( gen ) ) * ( i % 2 ? -1.0f : 1.0f );
+			const float error = std::abs( from_half( to_half( f ) ) - f );
+			if ( std::abs( f ) >= std::ldexp( 1.0f, -14 ) )
+			{
+				REQUIRE( error <= std::abs( f ) * std::ldexp( 1.0f, -11 ) );
+			}
+			else
+			{
+				REQUIRE( error <= std::ldexp( 1.0f, -25 ) );
+			}
+		}
+	}
+
+	SECTION( "half vec3" )
+	{
+		auto v = Vec3( 0.5f, -3.25f, 1024.0f );
+		REQUIRE( HalfVec3( v ).get_vec3() == v );
+		REQUIRE( HalfVec3().get_vec3() == Vec3::Zero );
+
+		// Batches give the same results as one at a time, for any bits
+		std::uniform_int_distribution<uint32_t> bits;
+		for ( size_t count : { 0, 1, 2, 3, 5, 8, 17 } )
+		{
+			std::vector<Vec3> in( count );
+			for ( auto& p : in )
+			{
+				p = Vec3( from_bits( bits( gen ) ), from_bits( bits( gen ) >> 4 ), from_bits( bits( gen ) >> 8 ) );
+			}
+			std::vector<HalfVec3> packed( count );
+			pack( in.data(), packed.data(), count );
+			std::vector<Vec3> out( count );
+			unpack( packed.data(), out.data(), count );
+
+			for ( size_t i = 0; i < count; ++i )
+			{
+				auto h = HalfVec3( in[i] );
+				auto u = h.get_vec3();
+				REQUIRE( std::memcmp( &packed[i], &h, sizeof( h ) ) == 0 );
+				REQUIRE( std::memcmp( &out[i], &u, sizeof( u ) ) == 0 );
+			}
+		}
+	}
+
+	SECTION( "quantized vec3" )
+	{
+		auto range = Box( Vec3( -100.0f, 0.0f, -1.0f ), Vec3( 100.0f, 50.0f, 1.0f ) );
+		REQUIRE( QuantizedVec3( range.a, range ).get_vec3( range ) == range.a );
+		REQUIRE( QuantizedVec3( range.b, range ).get_vec3( range ) == range.b );
+
+		// Out of the box is clamped to its faces
+		auto clamped = QuantizedVec3( Vec3( -200.0f, 60.0f, 0.0f ), range ).get_vec3( range );
+		REQUIRE( clamped.x == -100.0f );
+		REQUIRE( clamped.y == 50.0f );
+
+		// A flat box keeps its only value
+		auto flat = Box( Vec3( 1.0f, 2.0f, 3.0f ), Vec3( 1.0f, 4.0f, 5.0f ) );
+		REQUIRE( QuantizedVec3( Vec3( 1.0f, 2.0f, 3.0f ), flat ).get_vec3( flat ).x == 1.0f );
+
+		std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+		const float bound[3] = { 200.0f / 131070.0f, 50.0f / 131070.0f, 2.0f / 131070.0f };
+		for ( size_t count : { 0, 1, 3, 4, 5, 17 } )
+		{
+			std::vector<Vec3> in( count );
+			for ( auto& p : in )
+			{
+				p = Vec3( -100.0f + 200.0f * unit( gen ), 50.0f * unit( gen ), -1.0f + 2.0f * unit( gen ) );
+			}
+			std::vector<QuantizedVec3> packed( count );
+			pack( in.data(), range, packed.data(), count );
+			std::vector<Vec3> out( count );
+			unpack( packed.data(), range, out.data(), count );
+
+			for ( size_t i = 0; i < count; ++i )
+			{
+				auto q = QuantizedVec3( in[i], range );
+				auto u = q.get_vec3( range );
+				REQUIRE( std::memcmp( &packed[i], &q, sizeof( q ) ) == 0 );
+				REQUIRE( std::memcmp( &out[i], &u, sizeof( u ) ) == 0 );
+
+				// Half a step, with a float rounding of the result
+				REQUIRE( std::abs( u.x - in[i].x ) <= bound[0] + 1.0e-5f );
+				REQUIRE( std::abs( u.y - in[i].y ) <= bound[1] + 5.0e-6f );
+				REQUIRE( std::abs( u.z - in[i].z ) <= bound[2] + 1.0e-7f );
+			}
+		}
+	}
+
+	SECTION( "smallest three" )
+	{
+		REQUIRE( PackedQuat48().get_quat() == Quat::Identity );
+		REQUIRE( PackedQuat32().get_quat() == Quat::Identity );
+		REQUIRE( PackedQuat48( Quat::Identity ).get_quat() == Quat::Identity );
+		REQUIRE( PackedQuat32( Quat::Identity ).get_quat() == Quat::Identity );
+
+		// The negation of a rotation packs the same
+		auto q = Quat( Vec3::Y, 2.0f );
+		auto n = Quat( -q.w, -q.x, -q.y, -q.z );
+		REQUIRE( PackedQuat32( q ).data == PackedQuat32( n ).data );
+
+		// Largest components at each index, with both signs
+		for ( size_t i = 0; i < 8; ++i )
+		{
+			float c[4] = { 0.1f, -0.2f, 0.3f, 0.0f };
+			c[3] = std::sqrt( 1.0f - 0.14f ) * ( i % 2 ? -1.0f : 1.0f );
+			std::swap( c[3], c[i / 2] );
+			auto r = Quat( c[0], c[1], c[2], c[3] );
+			REQUIRE( get_distance( PackedQuat48( r ).get_quat(), r ) <= 6.5e-5f );
+			REQUIRE( get_distance( PackedQuat32( r ).get_quat(), r ) <= 2.1e-3f );
+		}
+
+		float worst_angle = 0.0f;
+		for ( size_t count : { 0, 1, 3, 4, 5, 17, 1000 } )
+		{
+			std::vector<Quat> in( count );
+			for ( auto& r : in )
+			{
+				r = random_rotation( gen );
+			}
+
+			std::vector<PackedQuat48> packed48( count );
+			std::vector<PackedQuat32> packed32( count );
+			pack( in.data(), packed48.data(), count );
+			pack( in.data(), packed32.data(), count );
+			std::vector<Quat> out48( count );
+			std::vector<Quat> out32( count );
+			unpack( packed48.data(), out48.data(), count );
+			unpack( packed32.data(), out32.data(), count );
+
+			for ( size_t i = 0; i < count; ++i )
+			{
+				auto p48 = PackedQuat48( in[i] );
+				auto p32 = PackedQuat32( in[i] );
+				auto u48 = p48.get_quat();
+				auto u32 = p32.get_quat();
+				REQUIRE( std::memcmp( &packed48[i], &p48, sizeof( p48 ) ) == 0 );
+				REQUIRE( std::memcmp( &packed32[i], &p32, sizeof( p32 ) ) == 0 );
+				REQUIRE( std::memcmp( &out48[i], &u48, sizeof( u48 ) ) == 0 );
+				REQUIRE( std::memcmp( &out32[i], &u32, sizeof( u32 ) ) == 0 );
+
+				REQUIRE( get_distance( u48, in[i] ) <= 6.5e-5f );
+				REQUIRE( get_distance( u32, in[i] ) <= 2.1e-3f );
+
+				const float d = std::abs( u32.w * in[i].w + u32.x * in[i].x + u32.y * in[i].y + u32.z * in[i].z );
+				worst_angle = std::max( worst_angle, 2.0f * std::acos( std::min( d, 1.0f ) ) );
+			}
+		}
+		REQUIRE( worst_angle < 0.3f * 3.14159265f / 180.0f );
+	}
+}
+
+
+}  // namespace spot::math
@@ -0,0 +1,109 @@
+#include "test.h"
+#include "spot/math/precision.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+namespace spot::math
+{
+
+
+/// @return The distance of a float from the exact value, in units of the last place of the rounded value
+double get_ulps( const float value, const double exact )
+{
+	const float  rounded = float( exact );
+	const double ulp     = std::nextafter( std::abs( rounded ), INFINITY ) - std::abs( rounded );
+	return std::abs( value - exact ) / ulp;
+}
+
+
+template <Precision P>
+void check_bounds( const double rsqrt_ulps, const double reciprocal_ulps )
+{
+	// The relative error repeats every two binades, which are walked with a prime stride
+	for ( uint32_t bits = 0x3f800000; bits < 0x40800000; bits += 61 )
+	{
+		for ( float scale : { 1.0f / 1024.0f, 1.0f, 4096.0f } )
+		{
+			float x;
+			std::memcpy( &x, &bits, sizeof( x ) );
+			x *= scale;
+
+			REQUIRE( get_ulps( rsqrt<P>( x ), 1.0 / std::sqrt( double( x ) ) ) <= rsqrt_ulps );
+			REQUIRE( get_ulps( reciprocal<P>( x ), 1.0 / double( x ) ) <= reciprocal_ulps );
+			REQUIRE( get_ulps( reciprocal<P>( -x ), -1.0 / double( x ) ) <= reciprocal_ulps );
+		}
+	}
+}
+
+
+template <Precision P>
+void check_vector()
+{
+#ifdef SPOT_MATH_RSQRT
+	alignas( 16 ) float in[4] = { 0.25f, 1.0f, 3.0f, 12345.0f };
+	alignas( 16 ) float out[4];
+	_mm_store_ps( out, rsqrt<P>( _mm_load_ps( in ) ) );
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		REQUIRE( out[i] == rsqrt<P>( in[i] ) );
+	}
+#endif
+}
+
+
+TEST_CASE( "Precision" )
+{
+	SECTION( "exact" )
+	{
+		check_bounds<Precision::Exact>( 1.5, 0.5 );
+		check_vector<Precision::Exact>();
+		REQUIRE( rsqrt<Precision::Exact>( 4.0f ) == 0.5f );
+	}
+
+	SECTION( "fast" )
+	{
+		check_bounds<Precision::Fast>( 4.0, 3.0 );
+		check_vector<Precision::Fast>();
+	}
+
+	SECTION( "default" )
+	{
+		// Functions use the precision the library is built with, bounds hold for both
+		std::mt19937 gen( 42 );
+		std::uniform_real_distribution<float> value( -10.0f, 10.0f );
+
+		for ( size_t i = 0; i < 1000; ++i )
+		{
+			auto v = Vec3( value( gen ), value( gen ), value( gen ) );
+			v.normalize();
+			REQUIRE( std::sqrt( double( v.x ) * v.x + double( v.y ) * v.y + double( v.z ) * v.z ) == Approx( 1.0 ).epsilon( 1e-6 ) );
+
+			auto u = Vec2( value( gen ), value( gen ) );
+			u.normalize();
+			REQUIRE( std::sqrt( double( u.x ) * u.x + double( u.y ) * u.y ) == Approx( 1.0 ).epsilon( 1e-6 ) );
+
+			auto q = Quat( value( gen ), value( gen ), value( gen ), value( gen ) );
+			auto d = double( q.w ) * q.w + double( q.x ) * q.x + double( q.y ) * q.y + double( q.z ) * q.z;
+			REQUIRE( length( q ) == Approx( std::sqrt( d ) ).epsilon( 1e-6 ) );
+			q.normalize();
+			REQUIRE( length( q ) == Approx( 1.0f ).epsilon( 1e-6 ) );
+		}
+		REQUIRE( length( Quat( 0.0f, 0.0f, 0.0f, 0.0f ) ) == 0.0f );
+
+		// Slerp halfway between two rotations around the same axis
+		auto a = Quat( Vec3::Z, 0.2f );
+		auto b = Quat( Vec3::Z, 1.4f );
+		auto r = slerp( a, b, 0.5f );
+		auto expected = Quat( Vec3::Z, 0.8f );
+		REQUIRE( r.w == Approx( expected.w ).epsilon( 1e-6 ) );
+		REQUIRE( r.z == Approx( expected.z ).epsilon( 1e-6 ) );
+		REQUIRE( r.x == 0.0f );
+		REQUIRE( r.y == 0.0f );
+	}
+}
+
+
+}  // namespace spot::math
@@ -1,5 +1,10 @@
 #include "test.h"
 
+#include <cstring>
+#include <random>
+
+#include <spot/math/rotation.h>
+
 namespace spot::math
 {
 
@@ -46,7 +51,12 @@ TEST_CASE( "Quat" )
 	SECTION( "from-matrix" )
 	{
 		auto q = Quat( Mat4::Identity );
+#ifdef SPOT_MATH_FAST
+		// Fast normalization is only within a few ULP
+		REQUIRE( equals( q, Quat::Identity ) );
+#else
 		REQUIRE( q == Quat::Identity );
+#endif
 
 		SECTION( "rotation" )
 		{
@@ -88,6 +98,137 @@ TEST_CASE( "Quat" )
 			}
 		}
 	}
+
+	std::mt19937 gen( 19 );
+	std::uniform_real_distribution<float> value( -1.0f, 1.0f );
+	auto random_quat = [&] {
+		auto q = Quat( value( gen ), value( gen ), value( gen ), value( gen ) );
+		q.normalize();
+		return q;
+	};
+
+	SECTION( "compose" )
+	{
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto a = random_quat();
+			auto b = random_quat();
+			auto c = compose( a, b );
+
+			auto expected = a;
+			expected *= b;
+			c.normalize();
+			REQUIRE( c == expected );
+		}
+
+		// Drift of a long chain stays small enough for renormalize
+		auto axis = Vec3( 1.0f, 2.0f, 3.0f );
+		axis.normalize();
+		auto step = Quat( axis, 0.01f );
+		auto q = Quat::Identity;
+		for ( size_t i = 0; i < 1000; ++i )
+		{
+			q = compose( step, q );
+		}
+		REQUIRE( std::abs( dot( q, q ) - 1.0f ) < 1e-4f );
+		q.renormalize();
+		REQUIRE( dot( q, q ) == Approx( 1.0f ).margin( 4.0f * std::numeric_limits<float>::epsilon() ) );
+	}
+
+	SECTION( "renormalize" )
+	{
+		for ( float scale : { 0.9995f, 1.0f, 1.0005f } )
+		{
+			auto q = scale * random_quat();
+			auto expected = q;
+			expected.normalize();
+			q.renormalize();
+			REQUIRE( q.w == Approx( expected.w ).margin( 4e-7f ) );
+			REQUIRE( q.x == Approx( expected.x ).margin( 4e-7f ) );
+			REQUIRE( q.y == Approx( expected.y ).margin( 4e-7f ) );
+			REQUIRE( q.z == Approx( expected.z ).margin( 4e-7f ) );
+		}
+	}
+
+	SECTION( "rotate" )
+	{
+		REQUIRE( rotate( Quat::Identity, Vec3( 1.0f, 2.0f, 3.0f ) ) == Vec3( 1.0f, 2.0f, 3.0f ) );
+
+		auto v = rotate( Quat( Vec3::Z, radians( 90.0f ) ), Vec3::X );
+		REQUIRE( v.x == Approx( 0.0f ).margin( 1e-6f ) );
+		REQUIRE( v.y == Approx( 1.0f ) );
+		REQUIRE( v.z == Approx( 0.0f ).margin( 1e-6f ) );
+
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto q = random_quat();
+			auto p = Vec3( value( gen ), value( gen ), value( gen ) ) * 10.0f;
+			auto expected = Mat4( q ) * p;
+			auto r = rotate( q, p );
+			REQUIRE( r.x == Approx( expected.x ).margin( 1e-5f ) );
+			REQUIRE( r.y == Approx( expected.y ).margin( 1e-5f ) );
+			REQUIRE( r.z == Approx( expected.z ).margin( 1e-5f ) );
+
+			// Rotating by a composition is rotating by b then by a
+			auto b = random_quat();
+			auto twice = rotate( q, rotate( b, p ) );
+			auto once = rotate( compose( q, b ), p );
+			REQUIRE( once.x == Approx( twice.x ).margin( 1e-5f ) );
+			REQUIRE( once.y == Approx( twice.y ).margin( 1e-5f ) );
+			REQUIRE( once.z == Approx( twice.z ).margin( 1e-5f ) );
+		}
+	}
+
+	SECTION( "batch" )
+	{
+		// Counts covering whole SIMD registers, a tail, and less than one register
+		for ( size_t count : { 0, 3, 4, 17 } )
+		{
+			DYNAMIC_SECTION( "count " << count )
+			{
+				std::vector<Quat> a( count );
+				std::vector<Quat> b( count );
+				std::vector<Vec3> v( count );
+				for ( size_t i = 0; i < count; ++i )
+				{
+					a[i] = random_quat();
+					b[i] = random_quat();
+					v[i] = Vec3( value( gen ), value( gen ), value( gen ) );
+				}
+
+				// Batches give the same bits of the single versions
+				std::vector<Vec3> rotated( count );
+				rotate( a.data(), v.data(), rotated.data(), count );
+				std::vector<Quat> composed( count );
+				compose( a.data(), b.data(), composed.data(), count );
+				for ( size_t i = 0; i < count; ++i )
+				{
+					auto r = rotate( a[i], v[i] );
+					REQUIRE( std::memcmp( &rotated[i], &r, sizeof( Vec3 ) ) == 0 );
+					auto c = compose( a[i], b[i] );
+					REQUIRE( std::memcmp( &composed[i], &c, sizeof( Quat ) ) == 0 );
+				}
+
+				auto renormalized = composed;
+				renormalize( renormalized.data(), count );
+				for ( size_t i = 0; i < count; ++i )
+				{
+					auto c = composed[i];
+					c.renormalize();
+					REQUIRE( std::memcmp( &renormalized[i], &c, sizeof( Quat ) ) == 0 );
+				}
+
+				// Outputs may be the inputs
+				rotate( a.data(), v.data(), v.data(), count );
+				compose( a.data(), b.data(), a.data(), count );
+				for ( size_t i = 0; i < count; ++i )
+				{
+					REQUIRE( std::memcmp( &v[i], &rotated[i], sizeof( Vec3 ) ) == 0 );
+					REQUIRE( std::memcmp( &a[i], &composed[i], sizeof( Quat ) ) == 0 );
+				}
+			}
+		}
+	}
 }
 
 
@@ -0,0 +1,103 @@
+#include "test.h"
+#include "spot/math/ray.h"
+
+#include <random>
+
+namespace spot::math
+{
+
+
+TEST_CASE( "Ray" )
+{
+	SECTION( "box" )
+	{
+		auto box = Box( { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } );
+
+		REQUIRE( Ray( { -5.0f, 0.0f, 0.0f }, Vec3::X ).intersect( box ) == Approx( 4.0f ) );
+		REQUIRE( Ray( { -5.0f, 0.0f, 0.0f }, Vec3::X * 2.0f ).intersect( box ) == Approx( 2.0f ) );
+		REQUIRE( Ray( { 0.0f, 0.0f, 0.0f }, Vec3::Y ).intersect( box ) == 0.0f );
+
+		// Corners in any order
+		REQUIRE( Ray( { 0.0f, 0.0f, 5.0f }, -Vec3::Z ).intersect( Box( box.b, box.a ) ) == Approx( 4.0f ) );
+
+		// Behind, beside, and beyond the maximum distance
+		REQUIRE( Ray( { 5.0f, 0.0f, 0.0f }, Vec3::X ).intersect( box ) == Ray::Miss );
+		REQUIRE( Ray( { -5.0f, 2.0f, 0.0f }, Vec3::X ).intersect( box ) == Ray::Miss );
+		REQUIRE( Ray( { -5.0f, 0.0f, 0.0f }, Vec3::X ).intersect( box, 3.0f ) == Ray::Miss );
+
+		auto ray = Ray( { -5.0f, 0.5f, 0.5f }, Vec3( 1.0f, 0.0f, 0.0f ) );
+		REQUIRE( ray.get_point( ray.intersect( box ) ) == Vec3( -1.0f, 0.5f, 0.5f ) );
+	}
+
+	SECTION( "sphere" )
+	{
+		auto sphere = Sphere( { 0.0f, 0.0f, -10.0f }, 2.0f );
+
+		REQUIRE( Ray( {}, -Vec3::Z ).intersect( sphere ) == Approx( 8.0f ) );
+		REQUIRE( Ray( {}, -Vec3::Z * 4.0f ).intersect( sphere ) == Approx( 2.0f ) );
+		REQUIRE( Ray( { 0.0f, 0.0f, -9.0f }, Vec3::X ).intersect( sphere ) == 0.0f );
+		REQUIRE( Ray( {}, Vec3::Z ).intersect( sphere ) == Ray::Miss );
+		REQUIRE( Ray( { 0.0f, 3.0f, 0.0f }, -Vec3::Z ).intersect( sphere ) == Ray::Miss );
+		REQUIRE( Ray( {}, -Vec3::Z ).intersect( sphere, 7.0f ) == Ray::Miss );
+
+		// Tangent to a far away sphere
+		auto far_away = Sphere( { 0.0f, 1.0f, -10000.0f }, 1.0f );
+		REQUIRE( Ray( {}, -Vec3::Z ).intersect( far_away ) == Approx( 10000.0f ) );
+		REQUIRE( Ray( { 0.0f, 0.0f, 0.0f }, Vec3( 0.0f, 0.0f, -1.0f ) ).intersect( Sphere( far_away.o, 0.999f ) ) == Ray::Miss );
+	}
+
+	SECTION( "packets" )
+	{
+		std::mt19937 gen( 42 );
+		std::uniform_real_distribution<float> position( -4.0f, 4.0f );
+
+		auto random_vec = [&]() { return Vec3( position( gen ), position( gen ), position( gen ) ); };
+
+		for ( size_t i = 0; i < 200; ++i )
+		{
+			Ray rays[8];
+			for ( auto& ray : rays )
+			{
+				auto direction = random_vec();
+				// Some rays are parallel to an axis
+				( &direction.x )[i % 4 % 3] *= float( i % 4 != 3 );
+				ray = Ray( random_vec(), direction );
+			}
+			auto box    = Box( random_vec(), random_vec() );
+			auto sphere = Sphere( random_vec(), std::abs( position( gen ) ) );
+
+			RayPacket4 packet4( rays );
+			RayPacket8 packet8( rays );
+			for ( size_t lane = 0; lane < 4; ++lane )
+			{
+				packet4.max_distance[lane] = std::abs( position( gen ) );
+			}
+
+			float distances[8];
+			packet4.intersect( box, distances );
+			for ( size_t lane = 0; lane < 4; ++lane )
+			{
+				REQUIRE( distances[lane] == rays[lane].intersect( box, packet4.max_distance[lane] ) );
+			}
+			packet4.intersect( sphere, distances );
+			for ( size_t lane = 0; lane < 4; ++lane )
+			{
+				REQUIRE( distances[lane] == rays[lane].intersect( sphere, packet4.max_distance[lane] ) );
+			}
+
+			packet8.intersect( box, distances );
+			for ( size_t lane = 0; lane < 8; ++lane )
+			{
+				REQUIRE( distances[lane] == rays[lane].intersect( box ) );
+			}
+			packet8.intersect( sphere, distances );
+			for ( size_t lane = 0; lane < 8; ++lane )
+			{
+				REQUIRE( distances[lane] == rays[lane].intersect( sphere ) );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
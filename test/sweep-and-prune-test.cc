@@ -0,0 +1,156 @@
+#include "test.h"
+#include "spot/math/sweep-and-prune.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+namespace spot::math
+{
+
+
+using Pairs = std::set<SweepAndPrune::Pair>;
+
+
+bool overlaps( const Box& a, const Box& b, const uint32_t axes )
+{
+	for ( uint32_t i = 0; i < axes; ++i )
+	{
+		float amin = std::min( ( &a.a.x )[i], ( &a.b.x )[i] );
+		float amax = std::max( ( &a.a.x )[i], ( &a.b.x )[i] );
+		float bmin = std::min( ( &b.a.x )[i], ( &b.b.x )[i] );
+		float bmax = std::max( ( &b.a.x )[i], ( &b.b.x )[i] );
+		if ( amin >= bmax || amax <= bmin )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+TEST_CASE( "SweepAndPrune" )
+{
+	std::mt19937 gen( 42 );
+	std::uniform_real_distribution<float> position( -20.0f, 20.0f );
+	std::uniform_real_distribution<float> size( -3.0f, 3.0f );
+	std::uniform_real_distribution<float> step( -0.5f, 0.5f );
+
+	auto random_box = [&]() {
+		auto a = Vec3( position( gen ), position( gen ), position( gen ) );
+		return Box( a, a + Vec3( size( gen ), size( gen ), size( gen ) ) );
+	};
+
+	SECTION( "touching" )
+	{
+		SweepAndPrune sap;
+		auto a = sap.add( Box( Vec3::Zero, Vec3::One ) );
+		auto b = sap.add( Box( Vec3( 1.0f, 0.0f, 0.0f ), Vec3( 2.0f, 1.0f, 1.0f ) ) );
+
+		std::vector<SweepAndPrune::Pair> added;
+		std::vector<SweepAndPrune::Pair> removed;
+		sap.flush( added, removed );
+		REQUIRE( added.empty() );
+
+		sap.move( b, Box( Vec3( 0.5f, 0.0f, 0.0f ), Vec3( 1.5f, 1.0f, 1.0f ) ) );
+		sap.flush( added, removed );
+		REQUIRE( added == std::vector<SweepAndPrune::Pair> { { a, b } } );
+
+		// Overlapping and back within a frame is not reported
+		added.clear();
+		sap.move( a, Box( Vec3( -5.0f, 0.0f, 0.0f ), Vec3( -4.0f, 1.0f, 1.0f ) ) );
+		sap.move( a, Box( Vec3::Zero, Vec3::One ) );
+		sap.flush( added, removed );
+		REQUIRE( added.empty() );
+		REQUIRE( removed.empty() );
+
+		sap.remove( a );
+		sap.flush( added, removed );
+		REQUIRE( removed == std::vector<SweepAndPrune::Pair> { { a, b } } );
+		REQUIRE( sap.size() == 1 );
+	}
+
+	for ( uint32_t axes : { 1, 2, 3 } )
+	{
+		DYNAMIC_SECTION( "incremental " << axes )
+		{
+			SweepAndPrune sap( axes );
+			std::vector<Box> boxes;
+			std::vector<SweepAndPrune::Id> ids;
+			std::vector<bool> alive;
+
+			for ( size_t i = 0; i < 300; ++i )
+			{
+				boxes.push_back( random_box() );
+				ids.push_back( sap.add( boxes.back() ) );
+				alive.push_back( true );
+			}
+
+			// Pairs known from the deltas
+			Pairs known;
+			std::uniform_int_distribution<size_t> pick( 0, boxes.size() - 1 );
+
+			for ( size_t frame = 0; frame < 20; ++frame )
+			{
+				for ( size_t i = 0; i < boxes.size(); ++i )
+				{
+					if ( alive[i] )
+					{
+						auto delta = Vec3( step( gen ), step( gen ), step( gen ) );
+						boxes[i].a += delta;
+						boxes[i].b += delta;
+						sap.move( ids[i], boxes[i] );
+					}
+				}
+
+				for ( size_t r = 0; r < 10; ++r )
+				{
+					auto i = pick( gen );
+					if ( alive[i] )
+					{
+						sap.remove( ids[i] );
+					}
+					else
+					{
+						boxes[i] = random_box();
+						ids[i]   = sap.add( boxes[i] );
+					}
+					alive[i] = !alive[i];
+				}
+
+				std::vector<SweepAndPrune::Pair> added;
+				std::vector<SweepAndPrune::Pair> removed;
+				sap.flush( added, removed );
+				for ( auto& pair : removed )
+				{
+					REQUIRE( known.erase( pair ) == 1 );
+				}
+				for ( auto& pair : added )
+				{
+					REQUIRE( known.insert( pair ).second );
+				}
+
+				Pairs expected;
+				for ( size_t i = 0; i < boxes.size(); ++i )
+				{
+					for ( size_t j = i + 1; j < boxes.size(); ++j )
+					{
+						if ( alive[i] && alive[j] && overlaps( boxes[i], boxes[j], axes ) )
+						{
+							expected.emplace( std::min( ids[i], ids[j] ), std::max( ids[i], ids[j] ) );
+						}
+					}
+				}
+				REQUIRE( !expected.empty() );
+				REQUIRE( known == expected );
+
+				std::vector<SweepAndPrune::Pair> pairs;
+				sap.get_pairs( pairs );
+				REQUIRE( Pairs( pairs.begin(), pairs.end() ) == expected );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
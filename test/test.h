@@ -1,9 +1,15 @@
+#include <limits>
+#include <random>
+
 #include <catch2/catch.hpp>
-#include <spot/math/math.h>
+#include <spot/math/mat4.h>
 
 namespace spot::math
 {
 
-bool equals( const Mat4& a, const Mat4& b );
+bool equals( const Mat4& a, const Mat4& b, float margin = std::numeric_limits<float>::epsilon() * 2.0f );
+
+/// @return A random unit quaternion
+Quat random_rotation( std::mt19937& gen );
 
 }
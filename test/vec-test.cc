@@ -0,0 +1,99 @@
+#include "test.h"
+#include "spot/math/vec.h"
+
+#include <sstream>
+
+namespace spot::math
+{
+
+
+static_assert( std::is_same_v<Vec3f, Vec3> );
+static_assert( sizeof( Vec3 ) == 3 * sizeof( float ) );
+static_assert( sizeof( Vec3d ) == 3 * sizeof( double ) );
+static_assert( sizeof( Vec2u ) == 2 * sizeof( uint32_t ) );
+static_assert( sizeof( Size ) == 2 * sizeof( uint32_t ) );
+
+// Operators are usable in constant expressions for every type
+static_assert( Vec3d( 1, 2, 3 ) + Vec3d::One * 2.0 == Vec3d( 3, 4, 5 ) );
+static_assert( Vec4f( 1, 2, 3, 4 ) - Vec4f::One == Vec4f( 0, 1, 2, 3 ) );
+static_assert( -Vec2i( 1, -2 ) == Vec2i( -1, 2 ) );
+static_assert( Vec3i( 1, 2, 3 ) * Vec3i( 2, 3, 4 ) == Vec3i( 2, 6, 12 ) );
+static_assert( Vec3i( 2, 4, 6 ) / 2 == Vec3i( 1, 2, 3 ) );
+static_assert( dot( Vec3i( 1, 2, 3 ), Vec3i( 4, 5, 6 ) ) == 32 );
+static_assert( cross( Vec3i( 1, 0, 0 ), Vec3i( 0, 1, 0 ) ) == Vec3i( 0, 0, 1 ) );
+static_assert( min( Vec2i( 1, 5 ), Vec2i( 3, 2 ) ) == Vec2i( 1, 2 ) );
+static_assert( max( Vec2i( 1, 5 ), Vec2i( 3, 2 ) ) == Vec2i( 3, 5 ) );
+static_assert( lerp( Vec2d( 0, 0 ), Vec2d( 2, 4 ), 0.5 ) == Vec2d( 1, 2 ) );
+static_assert( Vec<5, int>::filled( 7 )[4] == 7 );
+static_assert( Vec3i::Zero == Vec3i() );
+
+// Conversions between types, and names of the components
+static_assert( Vec3( Vec2( 1.0f, 2.0f ) ) == Vec3( 1.0f, 2.0f, 0.0f ) );
+static_assert( Vec4( Vec3( 1.0f, 2.0f, 3.0f ) ).w == 1.0f );
+static_assert( Size( 640, 480 ).height == 480u );
+static_assert( Vec3i( Vec3d( 1.5, -2.5, 3.0 ) ) == Vec3i( 1, -2, 3 ) );
+static_assert( Vec3d( Vec3( 1.0f, 2.0f, 3.0f ) ) == Vec3d( 1, 2, 3 ) );
+static_assert( Vec3( Vec3d( 1, 2, 3 ) ).z == 3.0f );
+static_assert( Vec2u( Vec2( 3.0f, 4.0f ) ).y == 4u );
+
+
+TEST_CASE( "Vec" )
+{
+	SECTION( "access" )
+	{
+		auto v = Vec4d( 1, 2, 3, 4 );
+		REQUIRE( v.x == 1.0 );
+		REQUIRE( v.y == 2.0 );
+		REQUIRE( v.z == 3.0 );
+		REQUIRE( v.w == 4.0 );
+
+		v[2] = 5.0;
+		v.x = -1.0;
+		REQUIRE( v == Vec4d( -1, 2, 5, 4 ) );
+
+		auto p = Vec3( 1.0f, 2.0f, 3.0f );
+		p = Vec2( 4.0f, 5.0f );
+		p += Vec2( 1.0f, 1.0f );
+		REQUIRE( p == Vec3( 5.0f, 6.0f, 3.0f ) );
+
+		v += Vec4d::One;
+		v *= 2.0;
+		v -= Vec4d( 0, 6, 12, 10 );
+		v /= 2.0;
+		REQUIRE( v == Vec4d( 0, 0, 0, 0 ) );
+	}
+
+	SECTION( "normalize" )
+	{
+		auto d = Vec3d( 3, 0, 4 );
+		REQUIRE( length( d ) == 5.0 );
+		d.normalize();
+		REQUIRE( d == Vec3d( 0.6, 0.0, 0.8 ) );
+
+		auto f = Vec3( 1.0f, 2.0f, 3.0f );
+		f.normalize();
+		REQUIRE( std::abs( length( f ) - 1.0f ) < 1e-6f );
+	}
+
+	SECTION( "size" )
+	{
+		auto s = Size( 640, 480 );
+		auto u = Vec2u( s );
+		REQUIRE( u == Vec2u( 640, 480 ) );
+		REQUIRE( Size( u * 2u ) == Size( 1280, 960 ) );
+
+		s *= 1.5f;
+		REQUIRE( s == Size( 960, 720 ) );
+		REQUIRE( s / 2 == Size( 480, 360 ) );
+	}
+
+	SECTION( "print" )
+	{
+		std::stringstream ss;
+		ss << Vec3i( 1, -2, 3 );
+		REQUIRE( ss.str() == "[1, -2, 3]" );
+	}
+}
+
+
+}  // namespace spot::math
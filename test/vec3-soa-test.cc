@@ -0,0 +1,137 @@
+#include "test.h"
+#include "spot/math/vec3-soa.h"
+
+#include <cstdint>
+#include <random>
+
+namespace spot::math
+{
+
+
+std::vector<Vec3> random_vectors( std::mt19937& gen, const size_t count )
+{
+	std::uniform_real_distribution<float> dist( -4.0f, 4.0f );
+	std::vector<Vec3> ret( count );
+	for ( auto& v : ret )
+	{
+		v = { dist( gen ), dist( gen ), dist( gen ) };
+	}
+	return ret;
+}
+
+
+TEST_CASE( "Vec3Soa" )
+{
+	std::mt19937 gen( 42 );
+
+	// Sizes around the SIMD width exercise the padding
+	for ( size_t count : { 0, 1, 3, 4, 7, 8, 9, 37 } )
+	{
+		auto va = random_vectors( gen, count );
+		auto vb = random_vectors( gen, count );
+		auto a  = Vec3Soa( va );
+		auto b  = Vec3Soa( vb );
+
+		DYNAMIC_SECTION( "layout " << count )
+		{
+			REQUIRE( a.size() == count );
+			REQUIRE( reinterpret_cast<uintptr_t>( a.x ) % Vec3Soa::Alignment == 0 );
+			REQUIRE( reinterpret_cast<uintptr_t>( a.y ) % Vec3Soa::Alignment == 0 );
+			REQUIRE( reinterpret_cast<uintptr_t>( a.z ) % Vec3Soa::Alignment == 0 );
+			REQUIRE( a.scatter() == va );
+
+			Arena arena;
+			auto view = a.scatter( arena );
+			REQUIRE( std::vector<Vec3>( view.begin(), view.end() ) == va );
+
+			auto c = a;
+			REQUIRE( c.scatter() == va );
+			auto d = std::move( c );
+			REQUIRE( d.scatter() == va );
+			REQUIRE( c.size() == 0 );
+
+			// New vectors are zero even after operations wrote the padding
+			normalize( d, d );
+			d.resize( count + 5 );
+			for ( size_t i = count; i < d.size(); ++i )
+			{
+				REQUIRE( d[i] == Vec3::Zero );
+			}
+		}
+
+		DYNAMIC_SECTION( "element-wise " << count )
+		{
+			Vec3Soa out;
+			add( a, b, out );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( out[i] == va[i] + vb[i] );
+			}
+
+			sub( a, b, out );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( out[i] == va[i] - vb[i] );
+			}
+
+			mul( a, b, out );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( out[i] == va[i] * vb[i] );
+			}
+
+			mul( a, 3.0f, out );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( out[i] == va[i] * 3.0f );
+			}
+
+			cross( a, b, out );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( out[i] == Vec3::cross( va[i], vb[i] ) );
+			}
+
+			lerp( a, b, 0.25f, out );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( out[i] == lerp( va[i], vb[i], 0.25f ) );
+			}
+
+			std::vector<float> d( count );
+			dot( a, b, d.data() );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				REQUIRE( d[i] == Approx( Vec3::dot( va[i], vb[i] ) ) );
+			}
+
+			// In place
+			normalize( a, a );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				auto n = va[i];
+				n.normalize();
+				REQUIRE( a[i] == n );
+			}
+		}
+
+		DYNAMIC_SECTION( "reduce " << count )
+		{
+			if ( count > 0 )
+			{
+				Vec3 min = va[0];
+				Vec3 max = va[0];
+				for ( auto& v : va )
+				{
+					min = { std::min( min.x, v.x ), std::min( min.y, v.y ), std::min( min.z, v.z ) };
+					max = { std::max( max.x, v.x ), std::max( max.y, v.y ), std::max( max.z, v.z ) };
+				}
+				REQUIRE( a.get_min() == min );
+				REQUIRE( a.get_max() == max );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math
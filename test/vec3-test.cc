@@ -19,3 +19,14 @@ TEST_CASE( "Vec3" )
 	auto c = Vec3::cross( a, b );
 	REQUIRE( c == Vec3::Zero );
 }
+
+
+#ifdef SPOT_MATH_INLINE
+namespace spot::math
+{
+
+static_assert( Vec3::cross( Vec3( 1.0f, 0.0f, 0.0f ), Vec3( 0.0f, 1.0f, 0.0f ) ) == Vec3( 0.0f, 0.0f, 1.0f ) );
+static_assert( lerp( Vec3(), Vec3( 2.0f, 4.0f, 6.0f ), 0.5f ) == Vec3( 1.0f, 2.0f, 3.0f ) );
+
+} // namespace spot::math
+#endif
@@ -0,0 +1,109 @@
+#include "test.h"
+#include "spot/math/world.h"
+
+#include <cstring>
+#include <vector>
+
+namespace spot::math
+{
+
+
+TEST_CASE( "World" )
+{
+	std::mt19937 gen( 22 );
+	std::uniform_real_distribution<double> far( 1.0e7, 1.0e7 + 1000.0 );
+	std::uniform_real_distribution<double> near( -10.0, 10.0 );
+
+	// A camera far from the origin, with objects around it
+	const auto camera = Vec3d( far( gen ), far( gen ), -far( gen ) );
+	auto random_position = [&]() {
+		return camera + Vec3d( near( gen ), near( gen ), near( gen ) );
+	};
+
+	SECTION( "from trs" )
+	{
+		auto r = random_rotation( gen );
+		auto s = Vec3( 1.0f, 2.0f, 3.0f );
+		auto t = Vec3( 1.0f, -2.0f, 4.0f );
+		auto m = from_trs( Vec3d( t ), r, s );
+		REQUIRE( equals( Mat4( m ), Mat4::from_trs( t, r, s ) ) );
+	}
+
+	SECTION( "positions" )
+	{
+		// At 1e7 the spacing of floats is 1, so positions relative to the
+		// camera are rounded to whole units unless subtracted in double
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto p = random_position();
+			auto relative = Vec3d( rebase( camera, p ) );
+			for ( size_t j = 0; j < 3; ++j )
+			{
+				REQUIRE( relative[j] == double( float( p[j] - camera[j] ) ) );
+				REQUIRE( std::abs( relative[j] - ( p[j] - camera[j] ) ) < 1.0e-6 );
+			}
+		}
+	}
+
+	SECTION( "transforms" )
+	{
+		for ( size_t i = 0; i < 100; ++i )
+		{
+			auto r = random_rotation( gen );
+			auto t = random_position();
+			auto world = from_trs( t, r, Vec3( 2.0f, 2.0f, 2.0f ) );
+			auto view = rebase( camera, world );
+
+			// A point near the object ends up where it is relative to the camera
+			auto local = Vec3( 0.25f, -0.5f, 1.0f );
+			auto expected = world * Vec4d( local.x, local.y, local.z, 1.0 );
+			auto p = view * local;
+			REQUIRE( std::abs( p.x - ( expected[0] - camera[0] ) ) < 1.0e-5 );
+			REQUIRE( std::abs( p.y - ( expected[1] - camera[1] ) ) < 1.0e-5 );
+			REQUIRE( std::abs( p.z - ( expected[2] - camera[2] ) ) < 1.0e-5 );
+		}
+
+		// The bottom row is kept
+		auto projective = Mat4d::generate( [&]( size_t, size_t ) { return near( gen ); } );
+		projective( 3, 0 ) = -0.0;
+		auto view = rebase( camera, projective );
+		for ( size_t column = 0; column < 4; ++column )
+		{
+			REQUIRE( view( 3, column ) == float( projective( 3, column ) ) );
+		}
+		REQUIRE( std::signbit( view( 3, 0 ) ) );
+	}
+
+	SECTION( "batch" )
+	{
+		// The vectorized kernels give the same results as one at a time
+		for ( size_t count : { 0, 1, 3, 4, 5, 17 } )
+		{
+			std::vector<Vec3d> positions( count );
+			std::vector<Mat4d> transforms( count );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				positions[i] = random_position();
+				transforms[i] = Mat4d::generate( [&]( size_t row, size_t ) {
+					return row == 3 ? near( gen ) : far( gen );
+				} );
+			}
+
+			std::vector<Vec3> relative( count );
+			std::vector<Mat4> views( count );
+			rebase( camera, positions.data(), relative.data(), count );
+			rebase( camera, transforms.data(), views.data(), count );
+
+			for ( size_t i = 0; i < count; ++i )
+			{
+				auto p = rebase( camera, positions[i] );
+				auto m = rebase( camera, transforms[i] );
+				REQUIRE( std::memcmp( &relative[i], &p, sizeof( p ) ) == 0 );
+				REQUIRE( std::memcmp( &views[i], &m, sizeof( m ) ) == 0 );
+			}
+		}
+	}
+}
+
+
+}  // namespace spot::math